@@ -0,0 +1,170 @@
+#!/usr/bin/env python
+
+"""Builds a pack file, an indexed alternative to a .love zip.
+
+Files whose contents are already compressed (images, audio) are stored
+as-is, so they can be read without a copy. Other files are split into
+blocks which are deflated on their own. The index at the front of the
+pack is sorted by path hash. See PackArchive.h for the format.
+"""
+
+import optparse
+import os
+import struct
+import sys
+import zlib
+
+MAGIC = b'LOVEPAK1'
+HEADER_SIZE = 24
+FANOUT_SIZE = 256 * 4
+ENTRY_SIZE = 40
+FLAG_COMPRESSED = 1
+
+DEFAULT_BLOCK_SIZE = 64 * 1024
+
+# Files which compress poorly, so are always stored.
+STORED_EXTENSIONS = set([
+  '.gif', '.jpeg', '.jpg', '.love', '.mp3', '.ogg', '.png', '.zip',
+])
+
+# A compressed file must be at most this fraction of its size, or it is
+# stored instead.
+MAX_RATIO = 0.95
+
+
+def Hash(path):
+  h = 2166136261
+  for c in bytearray(path):
+    h = ((h ^ c) * 16777619) & 0xFFFFFFFF
+  return h
+
+
+def Normalize(path):
+  return path.replace(os.sep, '/').strip('/')
+
+
+def CompressBlocks(data, block_size):
+  """Returns the block table and blocks, or None if not worth it."""
+  table = []
+  blocks = []
+  for start in range(0, len(data), block_size):
+    block = data[start:start + block_size]
+    z = zlib.compressobj(zlib.Z_BEST_SPEED, zlib.DEFLATED, -zlib.MAX_WBITS)
+    packed = z.compress(block) + z.flush()
+    if len(packed) >= len(block):
+      packed = block
+    table.append(len(packed))
+    blocks.append(packed)
+
+  body = struct.pack('<%dI' % len(table), *table) + b''.join(blocks)
+  if len(body) > len(data) * MAX_RATIO:
+    return None
+  return body
+
+
+def CollectFiles(args):
+  """Returns (pack path, file path) for each file in args."""
+  files = []
+  for arg in args:
+    if os.path.isdir(arg):
+      for root, dirs, names in os.walk(arg):
+        dirs.sort()
+        for name in sorted(names):
+          path = os.path.join(root, name)
+          files.append((Normalize(os.path.relpath(path, arg)), path))
+    else:
+      files.append((Normalize(os.path.basename(arg)), arg))
+  return files
+
+
+def WritePack(out, files, block_size, verbose=False):
+  entries = []
+  for name, path in files:
+    with open(path, 'rb') as f:
+      data = f.read()
+
+    flags = 0
+    body = data
+    ext = os.path.splitext(name)[1].lower()
+    if ext not in STORED_EXTENSIONS and data:
+      packed = CompressBlocks(data, block_size)
+      if packed is not None:
+        flags = FLAG_COMPRESSED
+        body = packed
+
+    if verbose:
+      sys.stdout.write('%s %s %d -> %d\n' % (
+          'deflate' if flags else 'store  ', name, len(data), len(body)))
+
+    entries.append({
+      'name': name.encode('utf-8'),
+      'flags': flags,
+      'size': len(data),
+      'modtime': int(os.path.getmtime(path)),
+      'body': body,
+    })
+
+  for entry in entries:
+    entry['hash'] = Hash(entry['name'])
+  entries.sort(key=lambda e: (e['hash'], e['name']))
+
+  names = b''
+  for entry in entries:
+    entry['name_offset'] = len(names)
+    names += entry['name']
+
+  fanout = [0] * 256
+  for entry in entries:
+    fanout[entry['hash'] >> 24] += 1
+  for i in range(1, 256):
+    fanout[i] += fanout[i - 1]
+
+  offset = HEADER_SIZE + FANOUT_SIZE + len(entries) * ENTRY_SIZE + len(names)
+  for entry in entries:
+    entry['offset'] = offset
+    offset += len(entry['body'])
+
+  with open(out, 'wb') as f:
+    f.write(MAGIC)
+    f.write(struct.pack('<4I', len(entries), block_size, len(names), 0))
+    f.write(struct.pack('<256I', *fanout))
+    for entry in entries:
+      f.write(struct.pack('<4I3Q', entry['hash'], entry['flags'],
+                          entry['name_offset'], len(entry['name']),
+                          entry['offset'], entry['size'], entry['modtime']))
+    f.write(names)
+    for entry in entries:
+      f.write(entry['body'])
+
+
+def main(args):
+  parser = optparse.OptionParser(
+      usage='%prog -o OUT [options] DIR_OR_FILE...')
+  parser.add_option('-o', dest='out')
+  parser.add_option('-b', '--block-size', type='int',
+                    default=DEFAULT_BLOCK_SIZE)
+  parser.add_option('-v', '--verbose', action='store_true')
+  options, args = parser.parse_args(args)
+
+  if not options.out:
+    parser.error('Need output file (-o)')
+  if not args:
+    parser.error('Need files or directories to pack')
+  if options.block_size <= 0:
+    parser.error('Block size must be positive')
+
+  files = CollectFiles(args)
+
+  # The index must not hold two entries for one path.
+  seen = {}
+  for name, path in files:
+    if name in seen:
+      parser.error('%s and %s would both be packed as %s' % (
+          seen[name], path, name))
+    seen[name] = path
+
+  WritePack(options.out, files, options.block_size, options.verbose)
+  return 0
+
+if __name__ == '__main__':
+  sys.exit(main(sys.argv[1:]))
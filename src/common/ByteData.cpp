@@ -0,0 +1,87 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+#include "ByteData.h"
+#include "Exception.h"
+
+// STD
+#include <cstdlib>
+#include <cstring>
+
+namespace love
+{
+	ByteData::ByteData(int size)
+		: size(size), readOnly(false)
+	{
+		data = (char *) calloc(size > 0 ? size : 1, 1);
+		if (!data)
+			throw love::Exception("Out of memory.");
+	}
+
+	ByteData::ByteData(const void * bytes, int size, bool transfer)
+		: size(size), readOnly(true)
+	{
+		if (transfer)
+		{
+			data = (char *) bytes;
+			return;
+		}
+
+		data = (char *) malloc(size > 0 ? size : 1);
+		if (!data)
+			throw love::Exception("Out of memory.");
+		memcpy(data, bytes, size);
+	}
+
+	ByteData::~ByteData()
+	{
+		free(data);
+	}
+
+	void * ByteData::getData() const
+	{
+		return data;
+	}
+
+	int ByteData::getSize() const
+	{
+		return size;
+	}
+
+	bool ByteData::isReadOnly() const
+	{
+		return readOnly;
+	}
+
+	void ByteData::setReadOnly()
+	{
+		readOnly = true;
+	}
+
+	void ByteData::write(const void * bytes, int offset, int count)
+	{
+		if (readOnly)
+			throw love::Exception("ByteData is read-only.");
+		if (offset < 0 || count < 0 || offset > size - count)
+			throw love::Exception("Write out of range.");
+		memcpy(data + offset, bytes, count);
+	}
+
+} // love
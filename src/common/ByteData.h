@@ -0,0 +1,84 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+#ifndef LOVE_BYTE_DATA_H
+#define LOVE_BYTE_DATA_H
+
+// LOVE
+#include "config.h"
+#include "Data.h"
+
+namespace love
+{
+	/**
+	* A plain block of bytes which can be shared between threads
+	* without copying. Sending a ByteData to another thread (through
+	* a Variant) passes a reference and makes the ByteData read-only,
+	* so every thread sees the same, unchanging bytes.
+	**/
+	class ByteData : public Data
+	{
+	public:
+
+		/**
+		* Creates a writable ByteData filled with zeroes.
+		**/
+		ByteData(int size);
+
+		/**
+		* Creates a read-only ByteData.
+		* @param data The bytes.
+		* @param size The number of bytes.
+		* @param transfer If true, the ByteData takes over data, which
+		* must have been allocated with malloc, instead of copying it.
+		**/
+		ByteData(const void * data, int size, bool transfer = false);
+
+		virtual ~ByteData();
+
+		// Implements Data.
+		void * getData() const;
+		int getSize() const;
+
+		bool isReadOnly() const;
+
+		/**
+		* Makes the ByteData read-only, for good.
+		**/
+		void setReadOnly();
+
+		/**
+		* Copies bytes into the ByteData.
+		* @throws love::Exception if it is read-only or the bytes
+		* don't fit.
+		**/
+		void write(const void * bytes, int offset, int count);
+
+	private:
+
+		char * data;
+		int size;
+		bool readOnly;
+
+	}; // ByteData
+
+} // love
+
+#endif // LOVE_BYTE_DATA_H
@@ -20,12 +20,17 @@
 
 // LOVE
 #include "Object.h"
+#include "atomic.h"
 
 namespace love
 {
+	// Objects waiting for destroyDeferred. Objects are only ever pushed
+	// one at a time and taken all at once, so a plain compare-and-swap
+	// list is safe.
+	static void * volatile deferred = 0;
 
 	Object::Object()
-		: count(1)
+		: count(1), nextDeferred(0)
 	{
 	}
 
@@ -35,18 +40,57 @@ namespace love
 
 	int Object::getReferenceCount() const
 	{
-		return count;
+		return atomicLoad(const_cast<volatile int *>(&count));
 	}
 
 	void Object::retain()
 	{
-		++count;
+		atomicAdd(&count, 1);
 	}
 
 	void Object::release()
 	{
-		if (--count <= 0)
+		if (atomicAdd(&count, -1) > 0)
+			return;
+
+		if (!deferDestruction())
+		{
 			delete this;
+			return;
+		}
+
+		void * head;
+		do
+		{
+			head = deferred;
+			nextDeferred = (Object *) head;
+		}
+		while (!atomicCompareAndSwapPointer(&deferred, head, this));
+	}
+
+	void Object::destroyDeferred()
+	{
+		void * head;
+		do
+		{
+			head = deferred;
+			if (!head)
+				return;
+		}
+		while (!atomicCompareAndSwapPointer(&deferred, head, 0));
+
+		Object * o = (Object *) head;
+		while (o)
+		{
+			Object * next = o->nextDeferred;
+			delete o;
+			o = next;
+		}
+	}
+
+	bool Object::deferDestruction() const
+	{
+		return false;
 	}
 
 } // love
@@ -30,13 +30,19 @@ namespace love
 	* This class is an alternative to using smart pointers; it contains retain/release
 	* methods, and will delete itself with the reference count hits zero. The wrapper
 	* code assumes that all userdata inherits from this class.
+	*
+	* The reference count is atomic, so any thread may retain and release an
+	* Object without locking.
 	**/
 	class Object
 	{
 	private:
 
 		// The reference count.
-		int count;
+		volatile int count;
+
+		// Next in the list of objects waiting for destroyDeferred.
+		Object * nextDeferred;
 
 	public:
 
@@ -69,6 +75,24 @@ namespace love
 		**/
 		void release();
 
+		/**
+		* Deletes the objects which were released for the last time
+		* since the previous call, but asked to be deleted later (see
+		* deferDestruction).
+		**/
+		static void destroyDeferred();
+
+	protected:
+
+		/**
+		* Called when the last reference is released. Objects which
+		* may only be destroyed on a certain thread return true when
+		* called on any other thread; they are then kept until
+		* destroyDeferred is called.
+		* @return False by default, to be deleted right away.
+		**/
+		virtual bool deferDestruction() const;
+
 	}; // Object
 
 } // love
@@ -0,0 +1,519 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+#include "Serializer.h"
+
+// LOVE
+#include <common/atomic.h>
+#include <common/ByteData.h>
+#include <common/Exception.h>
+#include <common/StringMap.h>
+
+// STD
+#include <cstdlib>
+#include <cstring>
+
+// Tables nested deeper than this are not serialized.
+#define LOVE_SERIALIZER_MAX_DEPTH 64
+
+// Strings shorter than this are always written out in full.
+#define LOVE_SERIALIZER_MIN_INTERN 2
+
+// At most this many buffers are kept for reuse, and none larger than
+// LOVE_SERIALIZER_MAX_POOLED bytes.
+#define LOVE_SERIALIZER_POOL_SIZE 32
+#define LOVE_SERIALIZER_MAX_POOLED (1024 * 1024)
+
+namespace love
+{
+	extern StringMap<Type, TYPE_MAX_ENUM> types;
+	love::Type extractudatatype(lua_State * L, int idx);
+
+	namespace
+	{
+		enum Tag
+		{
+			TAG_NIL = 0,
+			TAG_FALSE,
+			TAG_TRUE,
+			TAG_INTEGER,
+			TAG_NUMBER,
+			TAG_STRING,
+			TAG_STRING_REF,
+			TAG_TABLE,
+			TAG_LUSERDATA,
+			TAG_OBJECT
+		};
+
+		// The pool of free buffers. The critical sections are a few
+		// instructions long, so a spinlock is enough.
+		volatile int poolLock = 0;
+		void * poolHead = 0;
+		int poolCount = 0;
+
+		void lockPool()
+		{
+			while (!atomicCompareAndSwap(&poolLock, 0, 1))
+				;
+		}
+
+		void unlockPool()
+		{
+			atomicStore(&poolLock, 0);
+		}
+
+		bool isInteger(double n, int & i)
+		{
+			if (!(n >= -2147483648.0 && n <= 2147483647.0))
+				return false;
+			i = (int) n;
+			if ((double) i != n)
+				return false;
+			// Keep -0 as a double.
+			return i != 0 || 1.0 / n > 0;
+		}
+	}
+
+	Serializer::Serializer()
+		: buffer(0), size(0), stringCount(0), internIndex(0), visitedIndex(0)
+	{
+	}
+
+	Serializer::~Serializer()
+	{
+		clear();
+		if (buffer)
+			recycle(buffer);
+	}
+
+	bool Serializer::serialize(lua_State * L, int idx)
+	{
+		clear();
+
+		if (idx < 0 && idx > LUA_REGISTRYINDEX)
+			idx += lua_gettop(L) + 1;
+
+		if (!lua_checkstack(L, 2))
+			return false;
+
+		// Maps strings already written to their index.
+		lua_newtable(L);
+		internIndex = lua_gettop(L);
+		// Tables currently being written, to catch cycles.
+		lua_newtable(L);
+		visitedIndex = lua_gettop(L);
+
+		bool ok = writeValue(L, idx, 0);
+		lua_pop(L, 2);
+
+		if (!ok)
+			clear();
+		return ok;
+	}
+
+	void Serializer::deserialize(lua_State * L) const
+	{
+		if (size == 0)
+		{
+			lua_pushnil(L);
+			return;
+		}
+
+		std::vector<const char *> strings;
+		std::vector<size_t> lengths;
+		strings.reserve(stringCount);
+		lengths.reserve(stringCount);
+
+		size_t pos = 0;
+		readValue(L, pos, strings, lengths);
+	}
+
+	size_t Serializer::getSize() const
+	{
+		return size;
+	}
+
+	Serializer::Buffer * Serializer::acquire()
+	{
+		Buffer * b = 0;
+
+		lockPool();
+		if (poolHead)
+		{
+			b = (Buffer *) poolHead;
+			poolHead = b->next;
+			poolCount--;
+		}
+		unlockPool();
+
+		if (!b)
+		{
+			b = new Buffer;
+			b->capacity = 256;
+			b->data = (char *) malloc(b->capacity);
+			b->next = 0;
+		}
+
+		return b;
+	}
+
+	void Serializer::recycle(Buffer * b)
+	{
+		if (b->capacity <= LOVE_SERIALIZER_MAX_POOLED)
+		{
+			lockPool();
+			if (poolCount < LOVE_SERIALIZER_POOL_SIZE)
+			{
+				b->next = (Buffer *) poolHead;
+				poolHead = b;
+				poolCount++;
+				b = 0;
+			}
+			unlockPool();
+		}
+
+		if (b)
+		{
+			free(b->data);
+			delete b;
+		}
+	}
+
+	void Serializer::reserve(size_t extra)
+	{
+		if (!buffer)
+			buffer = acquire();
+
+		if (size + extra <= buffer->capacity)
+			return;
+
+		size_t capacity = buffer->capacity * 2;
+		while (capacity < size + extra)
+			capacity *= 2;
+
+		char * data = (char *) realloc(buffer->data, capacity);
+		if (!data)
+			throw love::Exception("Out of memory.");
+		buffer->data = data;
+		buffer->capacity = capacity;
+	}
+
+	void Serializer::write(const void * bytes, size_t n)
+	{
+		reserve(n);
+		memcpy(buffer->data + size, bytes, n);
+		size += n;
+	}
+
+	void Serializer::writeByte(unsigned char b)
+	{
+		reserve(1);
+		buffer->data[size++] = (char) b;
+	}
+
+	void Serializer::writeVarint(unsigned int n)
+	{
+		reserve(5);
+		while (n >= 0x80)
+		{
+			buffer->data[size++] = (char) ((n & 0x7F) | 0x80);
+			n >>= 7;
+		}
+		buffer->data[size++] = (char) n;
+	}
+
+	void Serializer::writeString(const char * str, size_t len)
+	{
+		writeByte(TAG_STRING);
+		writeVarint((unsigned int) len);
+		write(str, len);
+	}
+
+	bool Serializer::writeValue(lua_State * L, int idx, int depth)
+	{
+		switch (lua_type(L, idx))
+		{
+		case LUA_TNIL:
+			writeByte(TAG_NIL);
+			return true;
+		case LUA_TBOOLEAN:
+			writeByte(lua_toboolean(L, idx) ? TAG_TRUE : TAG_FALSE);
+			return true;
+		case LUA_TNUMBER:
+			{
+				double n = lua_tonumber(L, idx);
+				int i;
+				if (isInteger(n, i))
+				{
+					writeByte(TAG_INTEGER);
+					// Zigzag, so small negative numbers are short too.
+					writeVarint(((unsigned int) i << 1) ^ (unsigned int) (i >> 31));
+				}
+				else
+				{
+					writeByte(TAG_NUMBER);
+					write(&n, sizeof(double));
+				}
+				return true;
+			}
+		case LUA_TSTRING:
+			{
+				size_t len;
+				const char * str = lua_tolstring(L, idx, &len);
+				if (len < LOVE_SERIALIZER_MIN_INTERN)
+				{
+					writeString(str, len);
+					return true;
+				}
+
+				lua_pushvalue(L, idx);
+				lua_rawget(L, internIndex);
+				if (lua_isnumber(L, -1))
+				{
+					writeByte(TAG_STRING_REF);
+					writeVarint((unsigned int) lua_tointeger(L, -1));
+					lua_pop(L, 1);
+					return true;
+				}
+				lua_pop(L, 1);
+
+				lua_pushvalue(L, idx);
+				lua_pushinteger(L, stringCount++);
+				lua_rawset(L, internIndex);
+				writeString(str, len);
+				return true;
+			}
+		case LUA_TTABLE:
+			return writeTable(L, idx, depth);
+		case LUA_TLIGHTUSERDATA:
+			{
+				void * p = lua_touserdata(L, idx);
+				writeByte(TAG_LUSERDATA);
+				write(&p, sizeof(void *));
+				return true;
+			}
+		case LUA_TUSERDATA:
+			{
+				love::Type type = extractudatatype(L, idx);
+				Proxy * p = (Proxy *) lua_touserdata(L, idx);
+				if (type == INVALID_ID)
+				{
+					// Same as Variant: not ours, so only the pointer
+					// can be sent.
+					writeByte(TAG_LUSERDATA);
+					write(&p, sizeof(void *));
+					return true;
+				}
+
+				ObjectRef ref;
+				ref.type = type;
+				ref.flags = p->flags;
+				ref.object = (Object *) p->data;
+				ref.object->retain();
+				if (ref.flags[BYTE_DATA_ID])
+					((ByteData *) p->data)->setReadOnly();
+				objects.push_back(ref);
+
+				writeByte(TAG_OBJECT);
+				writeVarint((unsigned int) objects.size() - 1);
+				return true;
+			}
+		default:
+			return false;
+		}
+	}
+
+	bool Serializer::writeTable(lua_State * L, int idx, int depth)
+	{
+		if (depth >= LOVE_SERIALIZER_MAX_DEPTH || !lua_checkstack(L, 4))
+			return false;
+
+		lua_pushvalue(L, idx);
+		lua_rawget(L, visitedIndex);
+		bool cycle = lua_toboolean(L, -1) != 0;
+		lua_pop(L, 1);
+		if (cycle)
+			return false;
+
+		lua_pushvalue(L, idx);
+		lua_pushboolean(L, 1);
+		lua_rawset(L, visitedIndex);
+
+		int narr = (int) lua_objlen(L, idx);
+
+		writeByte(TAG_TABLE);
+		writeVarint((unsigned int) narr);
+
+		// Filled in once the hash part has been counted.
+		reserve(4);
+		size_t countPos = size;
+		size += 4;
+
+		for (int i = 1; i <= narr; i++)
+		{
+			lua_rawgeti(L, idx, i);
+			bool ok = writeValue(L, lua_gettop(L), depth + 1);
+			lua_pop(L, 1);
+			if (!ok)
+				return false;
+		}
+
+		unsigned int nhash = 0;
+		lua_pushnil(L);
+		while (lua_next(L, idx) != 0)
+		{
+			int key = lua_gettop(L) - 1;
+			int i;
+			if (lua_type(L, key) == LUA_TNUMBER && isInteger(lua_tonumber(L, key), i) && i >= 1 && i <= narr)
+			{
+				lua_pop(L, 1);
+				continue;
+			}
+
+			if (!writeValue(L, key, depth + 1) || !writeValue(L, key + 1, depth + 1))
+			{
+				lua_pop(L, 2);
+				return false;
+			}
+			lua_pop(L, 1);
+			nhash++;
+		}
+
+		memcpy(buffer->data + countPos, &nhash, 4);
+
+		lua_pushvalue(L, idx);
+		lua_pushnil(L);
+		lua_rawset(L, visitedIndex);
+		return true;
+	}
+
+	unsigned int Serializer::readVarint(size_t & pos) const
+	{
+		unsigned int n = 0;
+		int shift = 0;
+		unsigned char b;
+		do
+		{
+			b = (unsigned char) buffer->data[pos++];
+			n |= (unsigned int) (b & 0x7F) << shift;
+			shift += 7;
+		}
+		while (b & 0x80);
+		return n;
+	}
+
+	void Serializer::readValue(lua_State * L, size_t & pos, std::vector<const char *> & strings, std::vector<size_t> & lengths) const
+	{
+		const char * data = buffer->data;
+		switch (data[pos++])
+		{
+		case TAG_FALSE:
+			lua_pushboolean(L, 0);
+			break;
+		case TAG_TRUE:
+			lua_pushboolean(L, 1);
+			break;
+		case TAG_INTEGER:
+			{
+				unsigned int z = readVarint(pos);
+				lua_pushinteger(L, (int) (z >> 1) ^ -(int) (z & 1));
+				break;
+			}
+		case TAG_NUMBER:
+			{
+				double n;
+				memcpy(&n, data + pos, sizeof(double));
+				pos += sizeof(double);
+				lua_pushnumber(L, n);
+				break;
+			}
+		case TAG_STRING:
+			{
+				size_t len = readVarint(pos);
+				if (len >= LOVE_SERIALIZER_MIN_INTERN)
+				{
+					strings.push_back(data + pos);
+					lengths.push_back(len);
+				}
+				lua_pushlstring(L, data + pos, len);
+				pos += len;
+				break;
+			}
+		case TAG_STRING_REF:
+			{
+				unsigned int i = readVarint(pos);
+				lua_pushlstring(L, strings[i], lengths[i]);
+				break;
+			}
+		case TAG_TABLE:
+			{
+				luaL_checkstack(L, 3, "table too deep to rebuild");
+				int narr = (int) readVarint(pos);
+				unsigned int nhash;
+				memcpy(&nhash, data + pos, 4);
+				pos += 4;
+
+				lua_createtable(L, narr, (int) nhash);
+				for (int i = 1; i <= narr; i++)
+				{
+					readValue(L, pos, strings, lengths);
+					lua_rawseti(L, -2, i);
+				}
+				for (unsigned int i = 0; i < nhash; i++)
+				{
+					readValue(L, pos, strings, lengths);
+					readValue(L, pos, strings, lengths);
+					lua_rawset(L, -3);
+				}
+				break;
+			}
+		case TAG_LUSERDATA:
+			{
+				void * p;
+				memcpy(&p, data + pos, sizeof(void *));
+				pos += sizeof(void *);
+				lua_pushlightuserdata(L, p);
+				break;
+			}
+		case TAG_OBJECT:
+			{
+				const ObjectRef & ref = objects[readVarint(pos)];
+				const char * name = 0;
+				types.find(ref.type, name);
+				ref.object->retain();
+				luax_newtype(L, name, ref.flags, ref.object);
+				break;
+			}
+		default:
+			lua_pushnil(L);
+			break;
+		}
+	}
+
+	void Serializer::clear()
+	{
+		for (size_t i = 0; i < objects.size(); i++)
+			objects[i].object->release();
+		objects.clear();
+		size = 0;
+		stringCount = 0;
+	}
+
+} // love
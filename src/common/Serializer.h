@@ -0,0 +1,119 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+#ifndef LOVE_SERIALIZER_H
+#define LOVE_SERIALIZER_H
+
+// LOVE
+#include <common/runtime.h>
+#include <common/Object.h>
+
+// STD
+#include <vector>
+
+namespace love
+{
+	/**
+	* Holds a Lua value (usually a table) in a compact binary form, so
+	* it can be rebuilt in another lua_State without going through
+	* Lua source. Used by Variant for tables.
+	*
+	* Strings which appear more than once are stored once and referred
+	* to by index after that. The array part of a table is written as a
+	* plain run of values, and read back into a preallocated array.
+	*
+	* The bytes live in buffers which are pooled between instances, so
+	* sending many messages does not allocate for each one.
+	**/
+	class Serializer
+	{
+	public:
+
+		Serializer();
+		~Serializer();
+
+		/**
+		* Serializes the value at the given index.
+		* @return False if the value (or something in it) can't be
+		* serialized: functions, coroutines, cycles or tables nested
+		* too deeply.
+		**/
+		bool serialize(lua_State * L, int idx);
+
+		/**
+		* Pushes a copy of the serialized value onto the stack.
+		**/
+		void deserialize(lua_State * L) const;
+
+		/**
+		* Gets the size of the serialized value in bytes.
+		**/
+		size_t getSize() const;
+
+	private:
+
+		struct Buffer
+		{
+			char * data;
+			size_t capacity;
+			Buffer * next;
+		};
+
+		// A LOVE object inside the value. The Serializer holds a
+		// reference to each one.
+		struct ObjectRef
+		{
+			love::Type type;
+			bits flags;
+			Object * object;
+		};
+
+		static Buffer * acquire();
+		static void recycle(Buffer * buffer);
+
+		void reserve(size_t size);
+		void write(const void * bytes, size_t size);
+		void writeByte(unsigned char b);
+		void writeVarint(unsigned int n);
+		void writeString(const char * str, size_t len);
+
+		bool writeValue(lua_State * L, int idx, int depth);
+		bool writeTable(lua_State * L, int idx, int depth);
+
+		unsigned int readVarint(size_t & pos) const;
+		void readValue(lua_State * L, size_t & pos, std::vector<const char *> & strings, std::vector<size_t> & lengths) const;
+
+		void clear();
+
+		Buffer * buffer;
+		size_t size;
+		std::vector<ObjectRef> objects;
+
+		// Number of distinct strings written, and the index of the
+		// Lua table used to find repeated strings while serializing.
+		unsigned int stringCount;
+		int internIndex;
+		int visitedIndex;
+
+	}; // Serializer
+
+} // love
+
+#endif // LOVE_SERIALIZER_H
@@ -20,6 +20,7 @@
 
 #include "Variant.h"
 #include <common/StringMap.h>
+#include <common/ByteData.h>
 
 namespace love
 {
@@ -85,11 +86,20 @@ namespace love
 			flags = p->flags;
 			data.userdata = p->data;
 			((love::Object *) data.userdata)->retain();
+			// Other threads get the same bytes, so they must not change.
+			if (flags[BYTE_DATA_ID])
+				((ByteData *) data.userdata)->setReadOnly();
 		}
 		else
 			data.userdata = userdata;
 	}
 
+	Variant::Variant(Serializer *table)
+	{
+		type = TABLE;
+		data.table = table;
+	}
+
 	Variant::~Variant()
 	{
 		switch(type)
@@ -100,6 +110,9 @@ namespace love
 			case FUSERDATA:
 				((love::Object *) data.userdata)->release();
 				break;
+			case TABLE:
+				delete data.table;
+				break;
 			default:
 				break;
 		}
@@ -128,6 +141,15 @@ namespace love
 			case LUA_TUSERDATA:
 				v = new Variant(extractudatatype(L, n), lua_touserdata(L, n));
 				break;
+			case LUA_TTABLE:
+				{
+					Serializer *table = new Serializer();
+					if (table->serialize(L, n))
+						v = new Variant(table);
+					else
+						delete table;
+				}
+				break;
 		}
 		return v;
 	}
@@ -165,6 +187,9 @@ namespace love
 				// sadly, however, it's the most
 				// I can do (at the moment).
 				break;
+			case TABLE:
+				data.table->deserialize(L);
+				break;
 			default:
 				lua_pushnil(L);
 				break;
@@ -23,6 +23,7 @@
 
 #include <common/runtime.h>
 #include <common/Object.h>
+#include <common/Serializer.h>
 
 #include <cstring>
 
@@ -39,7 +40,8 @@ namespace love
 			CHARACTER,
 			STRING,
 			LUSERDATA,
-			FUSERDATA
+			FUSERDATA,
+			TABLE
 		} type;
 		union
 		{
@@ -51,6 +53,7 @@ namespace love
 				size_t len;
 			} string;
 			void *userdata;
+			Serializer *table;
 		} data;
 		love::Type udatatype;
 		bits flags;
@@ -63,6 +66,7 @@ namespace love
 		Variant(char c);
 		Variant(void *userdata);
 		Variant(love::Type udatatype, void *userdata);
+		Variant(Serializer *table);
 		virtual ~Variant();
 
 		static Variant *fromLua(lua_State *L, int n);
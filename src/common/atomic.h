@@ -0,0 +1,137 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+#ifndef LOVE_ATOMIC_H
+#define LOVE_ATOMIC_H
+
+#include <common/config.h>
+
+#ifdef LOVE_WINDOWS
+#	include <windows.h>
+#endif
+
+namespace love
+{
+	/**
+	* Atomic operations on ints and pointers shared between threads.
+	* All of them are full memory barriers.
+	**/
+
+	/**
+	* Adds to an int.
+	* @return The new value.
+	**/
+	inline int atomicAdd(volatile int * value, int amount)
+	{
+#ifdef LOVE_WINDOWS
+		return InterlockedExchangeAdd((volatile LONG *) value, amount) + amount;
+#else
+		return __sync_add_and_fetch(value, amount);
+#endif
+	}
+
+	/**
+	* Sets an int to a new value if it has the expected one.
+	* @return True if the value was set.
+	**/
+	inline bool atomicCompareAndSwap(volatile int * value, int expected, int desired)
+	{
+#ifdef LOVE_WINDOWS
+		return InterlockedCompareExchange((volatile LONG *) value, desired, expected) == expected;
+#else
+		return __sync_bool_compare_and_swap(value, expected, desired);
+#endif
+	}
+
+	inline bool atomicCompareAndSwap(volatile unsigned int * value, unsigned int expected, unsigned int desired)
+	{
+#ifdef LOVE_WINDOWS
+		return InterlockedCompareExchange((volatile LONG *) value, (LONG) desired, (LONG) expected) == (LONG) expected;
+#else
+		return __sync_bool_compare_and_swap(value, expected, desired);
+#endif
+	}
+
+	/**
+	* Sets a pointer to a new value if it has the expected one.
+	* @return True if the value was set.
+	**/
+	inline bool atomicCompareAndSwapPointer(void * volatile * value, void * expected, void * desired)
+	{
+#ifdef LOVE_WINDOWS
+		return InterlockedCompareExchangePointer(value, desired, expected) == expected;
+#else
+		return __sync_bool_compare_and_swap(value, expected, desired);
+#endif
+	}
+
+	/**
+	* Reads an int, so that later reads and writes are not moved
+	* before it.
+	**/
+	inline int atomicLoad(volatile int * value)
+	{
+		int result = *value;
+#ifdef LOVE_WINDOWS
+		MemoryBarrier();
+#else
+		__sync_synchronize();
+#endif
+		return result;
+	}
+
+	inline unsigned int atomicLoad(volatile unsigned int * value)
+	{
+		unsigned int result = *value;
+#ifdef LOVE_WINDOWS
+		MemoryBarrier();
+#else
+		__sync_synchronize();
+#endif
+		return result;
+	}
+
+	/**
+	* Writes an int, so that earlier reads and writes are not moved
+	* after it.
+	**/
+	inline void atomicStore(volatile int * value, int desired)
+	{
+#ifdef LOVE_WINDOWS
+		MemoryBarrier();
+#else
+		__sync_synchronize();
+#endif
+		*value = desired;
+	}
+
+	inline void atomicStore(volatile unsigned int * value, unsigned int desired)
+	{
+#ifdef LOVE_WINDOWS
+		MemoryBarrier();
+#else
+		__sync_synchronize();
+#endif
+		*value = desired;
+	}
+
+} // love
+
+#endif // LOVE_ATOMIC_H
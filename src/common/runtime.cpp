@@ -25,7 +25,6 @@
 #include "Object.h"
 #include "Reference.h"
 #include "StringMap.h"
-#include <thread/threads.h>
 
 // STD
 #include <iostream>
@@ -33,28 +32,16 @@
 
 namespace love
 {
-	static thread::Mutex *gcmutex = 0;
-	void *_gcmutex = 0;
-	unsigned int _gcthread = 0;
 	/**
 	* Called when an object is collected. The object is released
 	* once in this function, possibly deleting it.
 	**/
 	static int w__gc(lua_State * L)
 	{
-		if (!gcmutex)
-		{
-			gcmutex = new thread::Mutex();
-			_gcmutex = (void*) gcmutex;
-		}
 		Proxy * p = (Proxy *)lua_touserdata(L, 1);
 		Object * t = (Object *)p->data;
 		if (p->own)
-		{
-			thread::Lock lock(gcmutex);
-			_gcthread = thread::ThreadBase::threadId();
 			t->release();
-		}
 		return 0;
 	}
 
@@ -284,6 +271,25 @@ namespace love
 		return 0;
 	}
 
+	/**
+	* Pushes the metatable for a type. Metatables are cached in the registry
+	* under the address of the type name, which is much cheaper to look up
+	* than the name itself.
+	**/
+	static void luax_pushmetatable(lua_State * L, const char * name)
+	{
+		lua_pushlightuserdata(L, (void *) name);
+		lua_rawget(L, LUA_REGISTRYINDEX);
+		if (!lua_isnil(L, -1))
+			return;
+
+		lua_pop(L, 1);
+		luaL_newmetatable(L, name);
+		lua_pushlightuserdata(L, (void *) name);
+		lua_pushvalue(L, -2);
+		lua_rawset(L, LUA_REGISTRYINDEX);
+	}
+
 	void luax_newtype(lua_State * L, const char * name, bits flags, void * data, bool own)
 	{
 		Proxy * u = (Proxy *)lua_newuserdata(L, sizeof(Proxy));
@@ -292,10 +298,50 @@ namespace love
 		u->flags = flags;
 		u->own = own;
 
-		luaL_newmetatable(L, name);
+		luax_pushmetatable(L, name);
 		lua_setmetatable(L, -2);
 	}
 
+	// The address of this is the registry key of the proxy cache.
+	static char proxyCacheKey;
+
+	void luax_pushtype(lua_State * L, const char * name, bits flags, Object * object)
+	{
+		lua_pushlightuserdata(L, &proxyCacheKey);
+		lua_rawget(L, LUA_REGISTRYINDEX);
+
+		if (lua_isnil(L, -1))
+		{
+			// A table of proxies by object, with weak values so it doesn't
+			// keep them alive.
+			lua_pop(L, 1);
+			lua_newtable(L);
+			lua_newtable(L);
+			lua_pushstring(L, "v");
+			lua_setfield(L, -2, "__mode");
+			lua_setmetatable(L, -2);
+			lua_pushlightuserdata(L, &proxyCacheKey);
+			lua_pushvalue(L, -2);
+			lua_rawset(L, LUA_REGISTRYINDEX);
+		}
+
+		lua_pushlightuserdata(L, object);
+		lua_rawget(L, -2);
+		if (!lua_isnil(L, -1))
+		{
+			lua_remove(L, -2); // cache
+			return;
+		}
+		lua_pop(L, 1);
+
+		object->retain();
+		luax_newtype(L, name, flags, object);
+		lua_pushlightuserdata(L, object);
+		lua_pushvalue(L, -2);
+		lua_rawset(L, -4);
+		lua_remove(L, -2); // cache
+	}
+
 	bool luax_istype(lua_State * L, int idx, love::bits type)
 	{
 		if (lua_isuserdata(L, idx) == 0)
@@ -416,6 +462,7 @@ namespace love
 
 		{"Object", OBJECT_ID},
 		{"Data", DATA_ID},
+		{"ByteData", BYTE_DATA_ID},
 		{"Module", MODULE_ID},
 
 		// Filesystem
@@ -462,6 +509,9 @@ namespace love
 
 		// Thread
 		{"Thread", THREAD_THREAD_ID},
+		{"Channel", THREAD_CHANNEL_ID},
+		{"JobPool", THREAD_JOB_POOL_ID},
+		{"Job", THREAD_JOB_ID},
 
 		// The modules themselves. Only add abstracted modules here.
 		{"filesystem", MODULE_FILESYSTEM_ID},
@@ -35,12 +35,9 @@ namespace love
 {
 	// Forward declarations.
 	class Module;
+	class Object;
 	class Reference;
 
-	// Exposed mutex of the GC
-	extern void *_gcmutex;
-	extern unsigned int _gcthread;
-
 	/**
 	* Registries represent special tables which can be accessed with
 	* luax_getregistry.
@@ -214,13 +211,27 @@ namespace love
 	/**
 	* Creates a new Lua-accessible object of the given type, and put it on the stack.
 	* @param L The Lua state.
-	* @param name The name of the type. This must match the used earlier with luax_register_type.
+	* @param name The name of the type. This must match the used earlier with luax_register_type,
+	* and have static storage, as the metatable is cached by its address.
 	* @param flags The type information.
 	* @param data The pointer to the actual object.
 	* @own Set this to true (default) if the object should be released upon garbage collection.
 	**/
 	void luax_newtype(lua_State * L, const char * name, bits flags, void * data, bool own = true);
 
+	/**
+	* Like luax_newtype, but reuses the Lua value from an earlier push of the
+	* same object if it is still alive, so no userdata is allocated. Meant
+	* for objects pushed often, like physics fixtures and contacts.
+	* The object is retained when (and only when) a new value is made, and
+	* it must always be pushed with the same type.
+	* @param L The Lua state.
+	* @param name The name of the type. This must have static storage.
+	* @param flags The type information.
+	* @param object The object to push.
+	**/
+	void luax_pushtype(lua_State * L, const char * name, bits flags, Object * object);
+
 	/**
 	* Checks whether the value at idx is a certain type.
 	* @param L The Lua state.
@@ -32,6 +32,7 @@ namespace love
 		// Cross-module types.
 		OBJECT_ID,
 		DATA_ID,
+		BYTE_DATA_ID,
 		MODULE_ID,
 
 		// Filesystem.
@@ -88,6 +89,9 @@ namespace love
 
 		// Thread
 		THREAD_THREAD_ID,
+		THREAD_CHANNEL_ID,
+		THREAD_JOB_POOL_ID,
+		THREAD_JOB_ID,
 
 		// The modules themselves. Only add abstracted modules here.
 		MODULE_FILESYSTEM_ID,
@@ -104,6 +108,7 @@ namespace love
 
 	const bits OBJECT_T = bits(1) << OBJECT_ID;
 	const bits DATA_T = (bits(1) << DATA_ID) | OBJECT_T;
+	const bits BYTE_DATA_T = (bits(1) << BYTE_DATA_ID) | DATA_T;
 	const bits MODULE_T = (bits(1) << MODULE_ID) | OBJECT_T;
 
 	// Filesystem.
@@ -159,6 +164,9 @@ namespace love
 
 	// Thread.
 	const bits THREAD_THREAD_T = (bits(1) << THREAD_THREAD_ID) | OBJECT_T;
+	const bits THREAD_CHANNEL_T = (bits(1) << THREAD_CHANNEL_ID) | OBJECT_T;
+	const bits THREAD_JOB_POOL_T = (bits(1) << THREAD_JOB_POOL_ID) | OBJECT_T;
+	const bits THREAD_JOB_T = (bits(1) << THREAD_JOB_ID) | OBJECT_T;
 
 	// Modules.
 	const bits MODULE_FILESYSTEM_T = (bits(1) << MODULE_FILESYSTEM_ID) | MODULE_T;
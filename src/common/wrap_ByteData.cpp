@@ -0,0 +1,93 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+#include "wrap_ByteData.h"
+#include "wrap_Data.h"
+#include "Exception.h"
+
+namespace love
+{
+	ByteData * luax_checkbytedata(lua_State * L, int idx)
+	{
+		return luax_checktype<ByteData>(L, idx, "ByteData", BYTE_DATA_T);
+	}
+
+	int w_ByteData_getString(lua_State * L)
+	{
+		ByteData * t = luax_checkbytedata(L, 1);
+		int offset = luaL_optint(L, 2, 0);
+		if (offset < 0 || offset > t->getSize())
+			return luaL_error(L, "Offset out of range.");
+		int size = luaL_optint(L, 3, t->getSize() - offset);
+		if (size < 0 || size > t->getSize() - offset)
+			return luaL_error(L, "Size out of range.");
+		lua_pushlstring(L, (const char *) t->getData() + offset, size);
+		return 1;
+	}
+
+	int w_ByteData_setString(lua_State * L)
+	{
+		ByteData * t = luax_checkbytedata(L, 1);
+		size_t len;
+		const char * str = luaL_checklstring(L, 2, &len);
+		int offset = luaL_optint(L, 3, 0);
+		try
+		{
+			t->write(str, offset, (int) len);
+		}
+		catch (love::Exception & e)
+		{
+			return luaL_error(L, "%s", e.what());
+		}
+		return 0;
+	}
+
+	int w_ByteData_isReadOnly(lua_State * L)
+	{
+		ByteData * t = luax_checkbytedata(L, 1);
+		luax_pushboolean(L, t->isReadOnly());
+		return 1;
+	}
+
+	int w_ByteData_setReadOnly(lua_State * L)
+	{
+		ByteData * t = luax_checkbytedata(L, 1);
+		t->setReadOnly();
+		return 0;
+	}
+
+	static const luaL_Reg functions[] = {
+		// Data
+		{ "getPointer", w_Data_getPointer },
+		{ "getSize", w_Data_getSize },
+
+		{ "getString", w_ByteData_getString },
+		{ "setString", w_ByteData_setString },
+		{ "isReadOnly", w_ByteData_isReadOnly },
+		{ "setReadOnly", w_ByteData_setReadOnly },
+		{ 0, 0 }
+	};
+
+	extern "C" int luaopen_bytedata(lua_State * L)
+	{
+		return luax_register_type(L, "ByteData", functions);
+	}
+
+} // love
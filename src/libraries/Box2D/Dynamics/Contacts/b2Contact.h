@@ -115,6 +115,13 @@ public:
 	/// Get the child primitive index for fixture B.
 	int32 GetChildIndexB() const;
 
+	/// Get the user data pointer that was provided with SetUserData.
+	void* GetUserData() const;
+
+	/// Set the user data. Use this to store your application specific data.
+	/// b2ContactListener::DestroyContact is called before the contact is freed.
+	void SetUserData(void* data);
+
 	/// Override the default friction mixture. You can call this in b2ContactListener::PreSolve.
 	/// This value persists until set or reset.
 	void SetFriction(float32 friction);
@@ -177,7 +184,7 @@ protected:
 	static void Destroy(b2Contact* contact, b2Shape::Type typeA, b2Shape::Type typeB, b2BlockAllocator* allocator);
 	static void Destroy(b2Contact* contact, b2BlockAllocator* allocator);
 
-	b2Contact() : m_fixtureA(NULL), m_fixtureB(NULL) {}
+	b2Contact() : m_fixtureA(NULL), m_fixtureB(NULL), m_userData(NULL) {}
 	b2Contact(b2Fixture* fixtureA, int32 indexA, b2Fixture* fixtureB, int32 indexB);
 	virtual ~b2Contact() {}
 
@@ -209,6 +216,8 @@ protected:
 
 	float32 m_friction;
 	float32 m_restitution;
+
+	void* m_userData;
 };
 
 inline b2Manifold* b2Contact::GetManifold()
@@ -293,6 +302,16 @@ inline int32 b2Contact::GetChildIndexB() const
 	return m_indexB;
 }
 
+inline void* b2Contact::GetUserData() const
+{
+	return m_userData;
+}
+
+inline void b2Contact::SetUserData(void* data)
+{
+	m_userData = data;
+}
+
 inline void b2Contact::FlagForFiltering()
 {
 	m_flags |= e_filterFlag;
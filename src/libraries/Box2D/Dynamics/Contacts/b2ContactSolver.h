@@ -62,6 +62,8 @@ struct b2ContactSolverDef
 	int32 count;
 	b2Position* positions;
 	b2Velocity* velocities;
+	const int32* sharedIndices;
+	int32 sharedCount;
 	b2StackAllocator* allocator;
 };
 
@@ -397,6 +397,8 @@ private:
 	friend class b2FrictionJoint;
 	friend class b2RopeJoint;
 
+	friend int32 b2GetSolverIndex(const b2Body* body, const int32* sharedIndices, int32 sharedCount);
+
 	// m_flags
 	enum
 	{
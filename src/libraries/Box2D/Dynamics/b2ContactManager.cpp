@@ -46,6 +46,11 @@ void b2ContactManager::Destroy(b2Contact* c)
 		m_contactListener->EndContact(c);
 	}
 
+	if (m_contactListener)
+	{
+		m_contactListener->DestroyContact(c);
+	}
+
 	// Remove from the world.
 	if (c->m_prev)
 	{
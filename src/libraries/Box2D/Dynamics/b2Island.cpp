@@ -145,16 +145,46 @@ This might be faster than computing sin+cos.
 However, we can compute sin+cos of the same angle fast.
 */
 
+int32 b2GetSolverIndex(const b2Body* body, const int32* sharedIndices, int32 sharedCount)
+{
+	// Static bodies are shared, if the island shares any.
+	if (sharedCount == 0 || body->m_type != b2_staticBody)
+	{
+		return body->m_islandIndex;
+	}
+
+	int32 low = 0;
+	int32 high = sharedCount - 1;
+	while (low < high)
+	{
+		int32 mid = (low + high) / 2;
+		if (sharedIndices[mid] < body->m_islandIndex)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+
+	b2Assert(sharedIndices[low] == body->m_islandIndex);
+	return low;
+}
+
 b2Island::b2Island(
 	int32 bodyCapacity,
 	int32 contactCapacity,
 	int32 jointCapacity,
 	b2StackAllocator* allocator,
-	b2ContactListener* listener)
+	b2ContactListener* listener,
+	int32 sharedCount)
 {
 	m_bodyCapacity = bodyCapacity;
 	m_contactCapacity = contactCapacity;
 	m_jointCapacity	 = jointCapacity;
+	m_sharedCount = sharedCount;
+	m_sharedBodyCount = 0;
 	m_bodyCount = 0;
 	m_contactCount = 0;
 	m_jointCount = 0;
@@ -168,11 +198,13 @@ b2Island::b2Island(
 
 	m_velocities = (b2Velocity*)m_allocator->Allocate(m_bodyCapacity * sizeof(b2Velocity));
 	m_positions = (b2Position*)m_allocator->Allocate(m_bodyCapacity * sizeof(b2Position));
+	m_sharedIndices = (int32*)m_allocator->Allocate(m_sharedCount * sizeof(int32));
 }
 
 b2Island::~b2Island()
 {
 	// Warning: the order should reverse the constructor order.
+	m_allocator->Free(m_sharedIndices);
 	m_allocator->Free(m_positions);
 	m_allocator->Free(m_velocities);
 	m_allocator->Free(m_joints);
@@ -186,19 +218,34 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 
 	float32 h = step.dt;
 
+	b2Assert(m_sharedBodyCount == m_sharedCount);
+
+	// Solver data
+	b2SolverData solverData;
+	solverData.step = step;
+	solverData.positions = m_positions;
+	solverData.velocities = m_velocities;
+	solverData.sharedIndices = m_sharedIndices;
+	solverData.sharedCount = m_sharedCount;
+
 	// Integrate velocities and apply damping. Initialize the body state.
 	for (int32 i = 0; i < m_bodyCount; ++i)
 	{
 		b2Body* b = m_bodies[i];
+		int32 index = solverData.GetIndex(b);
 
 		b2Vec2 c = b->m_sweep.c;
 		float32 a = b->m_sweep.a;
 		b2Vec2 v = b->m_linearVelocity;
 		float32 w = b->m_angularVelocity;
 
-		// Store positions for continuous collision.
-		b->m_sweep.c0 = b->m_sweep.c;
-		b->m_sweep.a0 = b->m_sweep.a;
+		// Store positions for continuous collision. Shared bodies are
+		// static, so theirs are stored already.
+		if (index >= m_sharedCount)
+		{
+			b->m_sweep.c0 = b->m_sweep.c;
+			b->m_sweep.a0 = b->m_sweep.a;
+		}
 
 		if (b->m_type == b2_dynamicBody)
 		{
@@ -217,20 +264,14 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 			w *= b2Clamp(1.0f - h * b->m_angularDamping, 0.0f, 1.0f);
 		}
 
-		m_positions[i].c = c;
-		m_positions[i].a = a;
-		m_velocities[i].v = v;
-		m_velocities[i].w = w;
+		m_positions[index].c = c;
+		m_positions[index].a = a;
+		m_velocities[index].v = v;
+		m_velocities[index].w = w;
 	}
 
 	timer.Reset();
 
-	// Solver data
-	b2SolverData solverData;
-	solverData.step = step;
-	solverData.positions = m_positions;
-	solverData.velocities = m_velocities;
-
 	// Initialize velocity constraints.
 	b2ContactSolverDef contactSolverDef;
 	contactSolverDef.step = step;
@@ -238,6 +279,8 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	contactSolverDef.count = m_contactCount;
 	contactSolverDef.positions = m_positions;
 	contactSolverDef.velocities = m_velocities;
+	contactSolverDef.sharedIndices = m_sharedIndices;
+	contactSolverDef.sharedCount = m_sharedCount;
 	contactSolverDef.allocator = m_allocator;
 
 	b2ContactSolver contactSolver(&contactSolverDef);
@@ -274,10 +317,11 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	// Integrate positions
 	for (int32 i = 0; i < m_bodyCount; ++i)
 	{
-		b2Vec2 c = m_positions[i].c;
-		float32 a = m_positions[i].a;
-		b2Vec2 v = m_velocities[i].v;
-		float32 w = m_velocities[i].w;
+		int32 index = solverData.GetIndex(m_bodies[i]);
+		b2Vec2 c = m_positions[index].c;
+		float32 a = m_positions[index].a;
+		b2Vec2 v = m_velocities[index].v;
+		float32 w = m_velocities[index].w;
 
 		// Check for large velocities
 		b2Vec2 translation = h * v;
@@ -298,10 +342,10 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 		c += h * v;
 		a += h * w;
 
-		m_positions[i].c = c;
-		m_positions[i].a = a;
-		m_velocities[i].v = v;
-		m_velocities[i].w = w;
+		m_positions[index].c = c;
+		m_positions[index].a = a;
+		m_velocities[index].v = v;
+		m_velocities[index].w = w;
 	}
 
 	// Solve position constraints
@@ -330,10 +374,16 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	for (int32 i = 0; i < m_bodyCount; ++i)
 	{
 		b2Body* body = m_bodies[i];
-		body->m_sweep.c = m_positions[i].c;
-		body->m_sweep.a = m_positions[i].a;
-		body->m_linearVelocity = m_velocities[i].v;
-		body->m_angularVelocity = m_velocities[i].w;
+		int32 index = solverData.GetIndex(body);
+		if (index < m_sharedCount)
+		{
+			continue;
+		}
+
+		body->m_sweep.c = m_positions[index].c;
+		body->m_sweep.a = m_positions[index].a;
+		body->m_linearVelocity = m_velocities[index].v;
+		body->m_angularVelocity = m_velocities[index].w;
 		body->SynchronizeTransform();
 	}
 
@@ -372,10 +422,14 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 
 		if (minSleepTime >= b2_timeToSleep && positionSolved)
 		{
+			// The caller puts shared bodies to sleep.
 			for (int32 i = 0; i < m_bodyCount; ++i)
 			{
 				b2Body* b = m_bodies[i];
-				b->SetAwake(false);
+				if (solverData.GetIndex(b) >= m_sharedCount)
+				{
+					b->SetAwake(false);
+				}
 			}
 		}
 	}
@@ -383,6 +437,7 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 
 void b2Island::SolveTOI(const b2TimeStep& subStep, int32 toiIndexA, int32 toiIndexB)
 {
+	b2Assert(m_sharedCount == 0);
 	b2Assert(toiIndexA < m_bodyCount);
 	b2Assert(toiIndexB < m_bodyCount);
 
@@ -403,6 +458,8 @@ void b2Island::SolveTOI(const b2TimeStep& subStep, int32 toiIndexA, int32 toiInd
 	contactSolverDef.step = subStep;
 	contactSolverDef.positions = m_positions;
 	contactSolverDef.velocities = m_velocities;
+	contactSolverDef.sharedIndices = NULL;
+	contactSolverDef.sharedCount = 0;
 	b2ContactSolver contactSolver(&contactSolverDef);
 
 	// Solve position constraints.
@@ -35,7 +35,8 @@ class b2Island
 {
 public:
 	b2Island(int32 bodyCapacity, int32 contactCapacity, int32 jointCapacity,
-			b2StackAllocator* allocator, b2ContactListener* listener);
+			b2StackAllocator* allocator, b2ContactListener* listener,
+			int32 sharedCount = 0);
 	~b2Island();
 
 	void Clear()
@@ -43,6 +44,7 @@ public:
 		m_bodyCount = 0;
 		m_contactCount = 0;
 		m_jointCount = 0;
+		m_sharedBodyCount = 0;
 	}
 
 	void Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& gravity, bool allowSleep);
@@ -52,7 +54,32 @@ public:
 	void Add(b2Body* body)
 	{
 		b2Assert(m_bodyCount < m_bodyCapacity);
-		body->m_islandIndex = m_bodyCount;
+		body->m_islandIndex = m_sharedCount + m_bodyCount - m_sharedBodyCount;
+		m_bodies[m_bodyCount] = body;
+		++m_bodyCount;
+	}
+
+	/// Add a static body which other islands may be solving at the same time.
+	/// Its island index is a shared index set by the caller, the same in all
+	/// the islands, and the body is only read. The island keeps its state in
+	/// one of its first m_sharedCount slots, found through m_sharedIndices.
+	void AddShared(b2Body* body)
+	{
+		b2Assert(m_bodyCount < m_bodyCapacity);
+		b2Assert(m_sharedBodyCount < m_sharedCount);
+		b2Assert(body->m_type == b2_staticBody);
+		b2Assert(0 <= body->m_islandIndex);
+
+		// Keep the shared indices in order. There are only a few.
+		int32 i = m_sharedBodyCount;
+		while (i > 0 && m_sharedIndices[i - 1] > body->m_islandIndex)
+		{
+			m_sharedIndices[i] = m_sharedIndices[i - 1];
+			--i;
+		}
+		m_sharedIndices[i] = body->m_islandIndex;
+		++m_sharedBodyCount;
+
 		m_bodies[m_bodyCount] = body;
 		++m_bodyCount;
 	}
@@ -88,6 +115,12 @@ public:
 	int32 m_bodyCapacity;
 	int32 m_contactCapacity;
 	int32 m_jointCapacity;
+
+	// The state of shared bodies comes first, so the state of the i-th body
+	// which is not shared is at m_sharedCount + i.
+	int32* m_sharedIndices;
+	int32 m_sharedCount;
+	int32 m_sharedBodyCount;
 };
 
 #endif
@@ -21,6 +21,8 @@
 
 #include <Box2D/Common/b2Math.h>
 
+class b2Body;
+
 /// Profiling data. Times are in milliseconds.
 struct b2Profile
 {
@@ -59,12 +61,24 @@ struct b2Velocity
 	float32 w;
 };
 
+/// Get the index of a body's state in an island. sharedIndices holds the shared
+/// indices of the island's shared bodies in order (see b2Island::AddShared), and
+/// the state of the i-th comes first, at index i.
+int32 b2GetSolverIndex(const b2Body* body, const int32* sharedIndices, int32 sharedCount);
+
 /// Solver Data
 struct b2SolverData
 {
 	b2TimeStep step;
 	b2Position* positions;
 	b2Velocity* velocities;
+	const int32* sharedIndices;
+	int32 sharedCount;
+
+	int32 GetIndex(const b2Body* body) const
+	{
+		return b2GetSolverIndex(body, sharedIndices, sharedCount);
+	}
 };
 
 #endif
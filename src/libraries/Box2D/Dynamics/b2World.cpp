@@ -39,6 +39,10 @@ b2World::b2World(const b2Vec2& gravity)
 	m_destructionListener = NULL;
 	m_debugDraw = NULL;
 
+	m_taskRunner = NULL;
+	m_taskAllocators = NULL;
+	m_taskAllocatorCount = 0;
+
 	m_bodyList = NULL;
 	m_jointList = NULL;
 
@@ -82,6 +86,12 @@ b2World::~b2World()
 
 		b = bNext;
 	}
+
+	for (int32 i = 0; i < m_taskAllocatorCount; ++i)
+	{
+		m_taskAllocators[i].~b2StackAllocator();
+	}
+	b2Free(m_taskAllocators);
 }
 
 void b2World::SetDestructionListener(b2DestructionListener* listener)
@@ -104,6 +114,17 @@ void b2World::SetDebugDraw(b2Draw* debugDraw)
 	m_debugDraw = debugDraw;
 }
 
+void b2World::SetTaskRunner(b2TaskRunner* runner)
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return;
+	}
+
+	m_taskRunner = runner;
+}
+
 b2Body* b2World::CreateBody(const b2BodyDef* def)
 {
 	b2Assert(IsLocked() == false);
@@ -389,6 +410,13 @@ void b2World::Solve(const b2TimeStep& step)
 	m_profile.solveVelocity = 0.0f;
 	m_profile.solvePosition = 0.0f;
 
+	if (m_taskRunner != NULL && m_taskRunner->GetThreadCount() > 1)
+	{
+		SolveIslands(step);
+		SynchronizeFixtures();
+		return;
+	}
+
 	// Size the island for the worst case.
 	b2Island island(m_bodyCount,
 					m_contactManager.m_contactCount,
@@ -547,30 +575,379 @@ void b2World::Solve(const b2TimeStep& step)
 
 	m_stackAllocator.Free(stack);
 
+	SynchronizeFixtures();
+}
+
+// An island found by SolveIslands: ranges of its bodies, contacts and joints.
+struct b2IslandTask
+{
+	int32 bodyStart;
+	int32 bodyCount;
+	int32 contactStart;
+	int32 contactCount;
+	int32 jointStart;
+	int32 jointCount;
+	int32 sharedCount;
+	b2Profile profile;
+};
+
+struct b2IslandTaskContext
+{
+	b2IslandTask* islands;
+	b2Body** bodies;
+	b2Contact** contacts;
+	b2Joint** joints;
+	b2StackAllocator* allocators;
+	int32 allocatorCount;
+	b2TimeStep step;
+	b2Vec2 gravity;
+	bool allowSleep;
+};
+
+static void b2SolveIslandTasks(void* data, int32 thread, int32 first, int32 last)
+{
+	b2IslandTaskContext* context = (b2IslandTaskContext*)data;
+	b2Assert(0 <= thread && thread < context->allocatorCount);
+	b2StackAllocator* allocator = context->allocators + thread;
+
+	for (int32 i = first; i < last; ++i)
 	{
-		b2Timer timer;
-		// Synchronize fixtures, check for out of range bodies.
-		for (b2Body* b = m_bodyList; b; b = b->GetNext())
+		b2IslandTask* task = context->islands + i;
+
+		// No listener: PostSolve is reported by SolveIslands.
+		b2Island island(task->bodyCount,
+						task->contactCount,
+						task->jointCount,
+						allocator,
+						NULL,
+						task->sharedCount);
+
+		b2Body** bodies = context->bodies + task->bodyStart;
+		for (int32 j = 0; j < task->bodyCount; ++j)
 		{
-			// If a body was not in an island then it did not move.
-			if ((b->m_flags & b2Body::e_islandFlag) == 0)
+			if (bodies[j]->GetType() == b2_staticBody)
 			{
-				continue;
+				island.AddShared(bodies[j]);
 			}
+			else
+			{
+				island.Add(bodies[j]);
+			}
+		}
+
+		for (int32 j = 0; j < task->contactCount; ++j)
+		{
+			island.Add(context->contacts[task->contactStart + j]);
+		}
+
+		for (int32 j = 0; j < task->jointCount; ++j)
+		{
+			island.Add(context->joints[task->jointStart + j]);
+		}
+
+		island.Solve(&task->profile, context->step, context->gravity, context->allowSleep);
+	}
+}
+
+// Like the island loop in Solve, but all islands are found first and then
+// solved with the task runner. A static body can be in several islands, so
+// it gets one island index for all of them (a shared index), which each
+// island maps to a state slot of its own, and is only read while the islands
+// are solved. The rest of its island bookkeeping, and
+// reporting PostSolve, is done afterwards in island order, so the results
+// match solving the islands one after another.
+void b2World::SolveIslands(const b2TimeStep& step)
+{
+	int32 threadCount = m_taskRunner->GetThreadCount();
+	if (m_taskAllocatorCount < threadCount)
+	{
+		for (int32 i = 0; i < m_taskAllocatorCount; ++i)
+		{
+			m_taskAllocators[i].~b2StackAllocator();
+		}
+		b2Free(m_taskAllocators);
+
+		m_taskAllocators = (b2StackAllocator*)b2Alloc(threadCount * sizeof(b2StackAllocator));
+		for (int32 i = 0; i < threadCount; ++i)
+		{
+			new (m_taskAllocators + i) b2StackAllocator();
+		}
+		m_taskAllocatorCount = threadCount;
+	}
+
+	// Clear all the island flags, and the shared indices.
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		b->m_flags &= ~b2Body::e_islandFlag;
+		if (b->GetType() == b2_staticBody)
+		{
+			b->m_islandIndex = -1;
+		}
+	}
+	for (b2Contact* c = m_contactManager.m_contactList; c; c = c->m_next)
+	{
+		c->m_flags &= ~b2Contact::e_islandFlag;
+	}
+	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		j->m_islandFlag = false;
+	}
+
+	// A static body is added once per island it touches, through a contact
+	// or a joint.
+	int32 bodyCapacity = m_bodyCount + m_contactManager.m_contactCount + m_jointCount;
+	b2IslandTask* islands = (b2IslandTask*)m_stackAllocator.Allocate(m_bodyCount * sizeof(b2IslandTask));
+	b2Body** bodies = (b2Body**)m_stackAllocator.Allocate(bodyCapacity * sizeof(b2Body*));
+	b2Contact** contacts = (b2Contact**)m_stackAllocator.Allocate(m_contactManager.m_contactCount * sizeof(b2Contact*));
+	b2Joint** joints = (b2Joint**)m_stackAllocator.Allocate(m_jointCount * sizeof(b2Joint*));
+	int32 islandCount = 0;
+	int32 bodyCount = 0;
+	int32 contactCount = 0;
+	int32 jointCount = 0;
+	int32 sharedCount = 0;
+
+	// Find all awake islands.
+	int32 stackSize = m_bodyCount;
+	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
+	for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
+	{
+		if (seed->m_flags & b2Body::e_islandFlag)
+		{
+			continue;
+		}
+
+		if (seed->IsAwake() == false || seed->IsActive() == false)
+		{
+			continue;
+		}
+
+		// The seed can be dynamic or kinematic.
+		if (seed->GetType() == b2_staticBody)
+		{
+			continue;
+		}
+
+		b2IslandTask* island = islands + islandCount;
+		++islandCount;
+		island->bodyStart = bodyCount;
+		island->contactStart = contactCount;
+		island->jointStart = jointCount;
+		island->sharedCount = 0;
+
+		int32 stackCount = 0;
+		stack[stackCount++] = seed;
+		seed->m_flags |= b2Body::e_islandFlag;
+
+		// Perform a depth first search (DFS) on the constraint graph.
+		while (stackCount > 0)
+		{
+			// Grab the next body off the stack and add it to the island.
+			b2Body* b = stack[--stackCount];
+			b2Assert(b->IsActive() == true);
+			b2Assert(bodyCount < bodyCapacity);
+			bodies[bodyCount++] = b;
 
+			// Make sure the body is awake.
+			b->SetAwake(true);
+
+			// To keep islands as small as possible, we don't
+			// propagate islands across static bodies.
 			if (b->GetType() == b2_staticBody)
 			{
+				if (b->m_islandIndex < 0)
+				{
+					b->m_islandIndex = sharedCount++;
+				}
+				++island->sharedCount;
 				continue;
 			}
 
-			// Update fixtures (for broad-phase).
-			b->SynchronizeFixtures();
+			// Search all contacts connected to this body.
+			for (b2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
+			{
+				b2Contact* contact = ce->contact;
+
+				// Has this contact already been added to an island?
+				if (contact->m_flags & b2Contact::e_islandFlag)
+				{
+					continue;
+				}
+
+				// Is this contact solid and touching?
+				if (contact->IsEnabled() == false ||
+					contact->IsTouching() == false)
+				{
+					continue;
+				}
+
+				// Skip sensors.
+				bool sensorA = contact->m_fixtureA->m_isSensor;
+				bool sensorB = contact->m_fixtureB->m_isSensor;
+				if (sensorA || sensorB)
+				{
+					continue;
+				}
+
+				contacts[contactCount++] = contact;
+				contact->m_flags |= b2Contact::e_islandFlag;
+
+				b2Body* other = ce->other;
+
+				// Was the other body already added to this island?
+				if (other->m_flags & b2Body::e_islandFlag)
+				{
+					continue;
+				}
+
+				b2Assert(stackCount < stackSize);
+				stack[stackCount++] = other;
+				other->m_flags |= b2Body::e_islandFlag;
+			}
+
+			// Search all joints connect to this body.
+			for (b2JointEdge* je = b->m_jointList; je; je = je->next)
+			{
+				if (je->joint->m_islandFlag == true)
+				{
+					continue;
+				}
+
+				b2Body* other = je->other;
+
+				// Don't simulate joints connected to inactive bodies.
+				if (other->IsActive() == false)
+				{
+					continue;
+				}
+
+				joints[jointCount++] = je->joint;
+				je->joint->m_islandFlag = true;
+
+				if (other->m_flags & b2Body::e_islandFlag)
+				{
+					continue;
+				}
+
+				b2Assert(stackCount < stackSize);
+				stack[stackCount++] = other;
+				other->m_flags |= b2Body::e_islandFlag;
+			}
+		}
+
+		island->bodyCount = bodyCount - island->bodyStart;
+		island->contactCount = contactCount - island->contactStart;
+		island->jointCount = jointCount - island->jointStart;
+
+		// Allow static bodies to participate in other islands.
+		for (int32 i = island->bodyStart; i < bodyCount; ++i)
+		{
+			b2Body* b = bodies[i];
+			if (b->GetType() == b2_staticBody)
+			{
+				b->m_flags &= ~b2Body::e_islandFlag;
+			}
 		}
+	}
 
-		// Look for new contacts.
-		m_contactManager.FindNewContacts();
-		m_profile.broadphase = timer.GetMilliseconds();
+	m_stackAllocator.Free(stack);
+
+	b2IslandTaskContext context;
+	context.islands = islands;
+	context.bodies = bodies;
+	context.contacts = contacts;
+	context.joints = joints;
+	context.allocators = m_taskAllocators;
+	context.allocatorCount = threadCount;
+	context.step = step;
+	context.gravity = m_gravity;
+	context.allowSleep = m_allowSleep;
+
+	try
+	{
+		m_taskRunner->ParallelFor(islandCount, b2SolveIslandTasks, &context);
+	}
+	catch (...)
+	{
+		m_stackAllocator.Free(joints);
+		m_stackAllocator.Free(contacts);
+		m_stackAllocator.Free(bodies);
+		m_stackAllocator.Free(islands);
+		throw;
+	}
+
+	b2ContactListener* listener = m_contactManager.m_contactListener;
+	for (int32 i = 0; i < islandCount; ++i)
+	{
+		b2IslandTask* island = islands + i;
+		m_profile.solveInit += island->profile.solveInit;
+		m_profile.solveVelocity += island->profile.solveVelocity;
+		m_profile.solvePosition += island->profile.solvePosition;
+
+		// The seed is not static, so it is asleep if the island went to sleep.
+		// A static body is left as the last island it is in left it.
+		bool awake = bodies[island->bodyStart]->IsAwake();
+		for (int32 j = 0; j < island->bodyCount; ++j)
+		{
+			b2Body* b = bodies[island->bodyStart + j];
+			if (b->GetType() == b2_staticBody)
+			{
+				b->SetAwake(awake);
+			}
+		}
+
+		if (listener == NULL)
+		{
+			continue;
+		}
+
+		// The solver stored the impulses in the manifolds.
+		for (int32 j = 0; j < island->contactCount; ++j)
+		{
+			b2Contact* c = contacts[island->contactStart + j];
+			const b2Manifold* manifold = c->GetManifold();
+
+			b2ContactImpulse impulse;
+			impulse.count = manifold->pointCount;
+			for (int32 k = 0; k < manifold->pointCount; ++k)
+			{
+				impulse.normalImpulses[k] = manifold->points[k].normalImpulse;
+				impulse.tangentImpulses[k] = manifold->points[k].tangentImpulse;
+			}
+
+			listener->PostSolve(c, &impulse);
+		}
+	}
+
+	m_stackAllocator.Free(joints);
+	m_stackAllocator.Free(contacts);
+	m_stackAllocator.Free(bodies);
+	m_stackAllocator.Free(islands);
+}
+
+void b2World::SynchronizeFixtures()
+{
+	b2Timer timer;
+	// Synchronize fixtures, check for out of range bodies.
+	for (b2Body* b = m_bodyList; b; b = b->GetNext())
+	{
+		// If a body was not in an island then it did not move.
+		if ((b->m_flags & b2Body::e_islandFlag) == 0)
+		{
+			continue;
+		}
+
+		if (b->GetType() == b2_staticBody)
+		{
+			continue;
+		}
+
+		// Update fixtures (for broad-phase).
+		b->SynchronizeFixtures();
 	}
+
+	// Look for new contacts.
+	m_contactManager.FindNewContacts();
+	m_profile.broadphase = timer.GetMilliseconds();
 }
 
 // Find TOI contacts and solve them.
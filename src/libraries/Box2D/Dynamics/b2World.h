@@ -66,6 +66,12 @@ public:
 	/// by you and must remain in scope.
 	void SetDebugDraw(b2Draw* debugDraw);
 
+	/// Register a task runner to solve islands on several threads, or NULL to
+	/// solve them on the calling thread. The runner is owned by you and must
+	/// remain in scope.
+	/// @warning This function is locked during callbacks.
+	void SetTaskRunner(b2TaskRunner* runner);
+
 	/// Create a rigid body given a definition. No reference to the definition
 	/// is retained.
 	/// @warning This function is locked during callbacks.
@@ -220,6 +226,8 @@ private:
 	friend class b2Controller;
 
 	void Solve(const b2TimeStep& step);
+	void SolveIslands(const b2TimeStep& step);
+	void SynchronizeFixtures();
 	void SolveTOI(const b2TimeStep& step);
 
 	void DrawJoint(b2Joint* joint);
@@ -244,6 +252,12 @@ private:
 	b2DestructionListener* m_destructionListener;
 	b2Draw* m_debugDraw;
 
+	// Islands are solved with this, if set. Each thread it may use has
+	// its own stack allocator.
+	b2TaskRunner* m_taskRunner;
+	b2StackAllocator* m_taskAllocators;
+	int32 m_taskAllocatorCount;
+
 	// This is used to compute the time step ratio to
 	// support a variable time step.
 	float32 m_inv_dt0;
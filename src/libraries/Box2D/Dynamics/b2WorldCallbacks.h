@@ -89,6 +89,11 @@ public:
 	/// Called when two fixtures cease to touch.
 	virtual void EndContact(b2Contact* contact) { B2_NOT_USED(contact); }
 
+	/// Called when a contact is about to be destroyed, touching or not. This
+	/// comes after any EndContact, and is the last chance to clear references
+	/// to the contact (e.g. from its user data).
+	virtual void DestroyContact(b2Contact* contact) { B2_NOT_USED(contact); }
+
 	/// This is called after a contact is updated. This allows you to inspect a
 	/// contact before it goes to the solver. If you are careful, you can modify the
 	/// contact manifold (e.g. disable contact).
@@ -118,6 +123,29 @@ public:
 	}
 };
 
+/// Implement this class to solve islands on several threads. Islands are built
+/// as usual and then solved in any order, each on one thread. Contact
+/// listener PostSolve callbacks are deferred until all islands are solved,
+/// and come in the usual order, on the thread that called b2World::Step.
+/// The results match solving the islands one after another.
+/// See b2World::SetTaskRunner
+class b2TaskRunner
+{
+public:
+	/// A task is called for the items [first, last). thread is in
+	/// [0, GetThreadCount()) and differs between tasks running at the same time.
+	typedef void (*Task)(void* data, int32 thread, int32 first, int32 last);
+
+	virtual ~b2TaskRunner() {}
+
+	/// Get the number of threads which may run tasks at once, including
+	/// the calling thread.
+	virtual int32 GetThreadCount() const = 0;
+
+	/// Call task for ranges covering [0, count), and return once all are done.
+	virtual void ParallelFor(int32 count, Task task, void* data) = 0;
+};
+
 /// Callback class for AABB queries.
 /// See b2World::Query
 class b2QueryCallback
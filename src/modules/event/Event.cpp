@@ -20,6 +20,12 @@
 
 #include "Event.h"
 
+// LOVE
+#include <common/Exception.h>
+
+// STD
+#include <cstring>
+
 using love::thread::Mutex;
 using love::thread::Lock;
 
@@ -27,85 +33,282 @@ namespace love
 {
 namespace event
 {
-	Message::Message(std::string name, Variant *a, Variant *b, Variant *c, Variant *d)
-		: name(name), nargs(0)
+	void Message::init(int name)
+	{
+		this->name = (uint16) name;
+		nargs = 0;
+		nameVariant = 0;
+	}
+
+	void Message::init(const char *name, size_t len)
+	{
+		this->name = NAME_UNINTERNED;
+		nargs = 0;
+		nameVariant = new Variant(name, len);
+	}
+
+	void Message::addBoolean(bool b)
+	{
+		if (nargs == MAX_ARGS)
+			return;
+		Arg &a = args[nargs++];
+		a.type = ARG_BOOLEAN;
+		a.boolean = b;
+	}
+
+	void Message::addNumber(double n)
 	{
-		args[0] = a;
-		args[1] = b;
-		args[2] = c;
-		args[3] = d;
-		for (int i = 0; i < 4; i++)
+		if (nargs == MAX_ARGS)
+			return;
+		Arg &a = args[nargs++];
+		a.type = ARG_NUMBER;
+		a.number = n;
+	}
+
+	void Message::addString(const char *str, size_t len)
+	{
+		if (nargs == MAX_ARGS)
+			return;
+
+		if (len > MAX_INLINE_STRING)
 		{
-			if (!args[i])
-				continue;
-			args[i]->retain();
-			nargs++;
+			Variant *v = new Variant(str, len);
+			addVariant(v);
+			v->release();
+			return;
 		}
+
+		Arg &a = args[nargs++];
+		a.type = ARG_STRING;
+		a.len = (uint8) len;
+		memcpy(a.string, str, len);
+		a.string[len] = 0;
 	}
 
-	Message::~Message()
+	void Message::addString(const char *str)
 	{
-		for (int i = 0; i < nargs; i++)
-			args[i]->release();
+		addString(str, strlen(str));
 	}
 
-	int Message::toLua(lua_State *L)
+	void Message::addVariant(Variant *v)
 	{
-		luax_pushstring(L, name);
-		for (int i = 0; i < nargs; i++)
-			args[i]->toLua(L);
-		return nargs+1;
+		if (nargs == MAX_ARGS)
+			return;
+		Arg &a = args[nargs++];
+		a.type = ARG_VARIANT;
+		a.variant = v;
+		v->retain();
 	}
 
-	Message *Message::fromLua(lua_State *L, int n)
+	void Message::clear()
 	{
-		std::string name = luax_checkstring(L, n);
-		n++;
-		Message *m = new Message(name);
-		for (int i = 0; i < 4; i++)
+		for (int i = 0; i < nargs; i++)
 		{
-			if (lua_isnoneornil(L, n+i))
-				break;
-			m->args[i] = Variant::fromLua(L, n+i);
-			if (!m->args[i])
-			{
-				delete m;
-				luaL_error(L, "Argument %d can't be stored safely\nExpected boolean, number, string or userdata.", n+i);
-				return NULL;
-			}
-			m->nargs++;
+			if (args[i].type == ARG_VARIANT)
+				args[i].variant->release();
 		}
-		return m;
+		nargs = 0;
+
+		if (nameVariant)
+			nameVariant->release();
+		nameVariant = 0;
+	}
+
+	Event::Event()
+		: head(0), count(0), numNames(NAME_MAX_BUILTIN)
+	{
+		names[NAME_QUIT] = "quit";
+		names[NAME_FOCUS] = "focus";
+		names[NAME_KEYPRESSED] = "keypressed";
+		names[NAME_KEYRELEASED] = "keyreleased";
+		names[NAME_MOUSEPRESSED] = "mousepressed";
+		names[NAME_MOUSERELEASED] = "mousereleased";
+		names[NAME_MOUSEMOVED] = "mousemoved";
+		names[NAME_JOYSTICKPRESSED] = "joystickpressed";
+		names[NAME_JOYSTICKRELEASED] = "joystickreleased";
 	}
 
 	Event::~Event()
 	{
+		Event::clear();
+		for (int i = NAME_MAX_BUILTIN; i < numNames; i++)
+			delete [] names[i];
 	}
 
-	void Event::push(Message *msg)
+	bool Event::push(Message &msg)
 	{
-		Lock lock(mutex);
-		msg->retain();
-		queue.push(msg);
+		{
+			Lock lock(mutex);
+			if (count == QUEUE_CAPACITY)
+			{
+				msg.clear();
+				return false;
+			}
+			queue[(head + count) % QUEUE_CAPACITY] = msg;
+			count++;
+		}
+
+		wake();
+		return true;
 	}
 
-	bool Event::poll(Message *&msg)
+	bool Event::poll(Message &msg)
 	{
 		Lock lock(mutex);
-		if (queue.empty())
+		if (count == 0)
 			return false;
-		msg = queue.front();
-		queue.pop();
+		msg = queue[head];
+		head = (head + 1) % QUEUE_CAPACITY;
+		count--;
 		return true;
 	}
 
 	void Event::clear()
 	{
 		Lock lock(mutex);
-		while (!queue.empty())
+		while (count > 0)
+		{
+			queue[head].clear();
+			head = (head + 1) % QUEUE_CAPACITY;
+			count--;
+		}
+	}
+
+	void Event::wake()
+	{
+	}
+
+	int Event::internName(const char *name)
+	{
+		int id = addName(name);
+		if (id < 0)
+			throw Exception("Too many event names (the limit is %d).", MAX_NAMES);
+		return id;
+	}
+
+	int Event::addName(const char *name)
+	{
+		Lock lock(namesMutex);
+		for (int i = 0; i < numNames; i++)
+		{
+			if (strcmp(names[i], name) == 0)
+				return i;
+		}
+
+		if (numNames == MAX_NAMES)
+			return -1;
+
+		size_t len = strlen(name);
+		char *copy = new char[len+1];
+		memcpy(copy, name, len+1);
+		names[numNames] = copy;
+		return numNames++;
+	}
+
+	const char *Event::getEventName(int id) const
+	{
+		return names[id];
+	}
+
+	int Event::toLua(lua_State *L, const Message &msg) const
+	{
+		if (msg.name == Message::NAME_UNINTERNED)
+			msg.nameVariant->toLua(L);
+		else
+			lua_pushstring(L, getEventName(msg.name));
+		for (int i = 0; i < msg.nargs; i++)
+		{
+			const Message::Arg &a = msg.args[i];
+			switch (a.type)
+			{
+			case Message::ARG_BOOLEAN:
+				lua_pushboolean(L, a.boolean);
+				break;
+			case Message::ARG_NUMBER:
+				lua_pushnumber(L, a.number);
+				break;
+			case Message::ARG_STRING:
+				lua_pushlstring(L, a.string, a.len);
+				break;
+			case Message::ARG_VARIANT:
+				a.variant->toLua(L);
+				break;
+			}
+		}
+		return msg.nargs + 1;
+	}
+
+	static int convert_i(lua_State *L)
+	{
+		const Event *event = (const Event *) lua_touserdata(L, 1);
+		const Message *msg = (const Message *) lua_touserdata(L, 2);
+		return event->toLua(L, *msg);
+	}
+
+	void Event::pushConverter(lua_State *L)
+	{
+		lua_pushcfunction(L, convert_i);
+	}
+
+	int Event::toLuaAndClear(lua_State *L, Message &msg) const
+	{
+		int top = lua_gettop(L) - 1;
+		lua_pushlightuserdata(L, (void *) this);
+		lua_pushlightuserdata(L, &msg);
+		int status = lua_pcall(L, 2, LUA_MULTRET, 0);
+		msg.clear();
+		if (status != 0)
+			return lua_error(L);
+		return lua_gettop(L) - top;
+	}
+
+	void Event::fromLua(lua_State *L, int n, Message &msg)
+	{
+		size_t len;
+		const char *name = luaL_checklstring(L, n, &len);
+
+		// Every name used in a game normally fits in the table. One which
+		// makes up names, say with a counter, still gets its messages.
+		int id = addName(name);
+		if (id >= 0)
+			msg.init(id);
+		else
+			msg.init(name, len);
+
+		n++;
+		for (int i = n; i < n + Message::MAX_ARGS; i++)
 		{
-			queue.back()->release();
-			queue.pop();
+			switch (lua_type(L, i))
+			{
+			case LUA_TNONE:
+			case LUA_TNIL:
+				return;
+			case LUA_TBOOLEAN:
+				msg.addBoolean(lua_toboolean(L, i) != 0);
+				break;
+			case LUA_TNUMBER:
+				msg.addNumber(lua_tonumber(L, i));
+				break;
+			case LUA_TSTRING:
+			{
+				size_t len;
+				const char *str = lua_tolstring(L, i, &len);
+				msg.addString(str, len);
+				break;
+			}
+			default:
+			{
+				Variant *v = Variant::fromLua(L, i);
+				if (!v)
+				{
+					msg.clear();
+					luaL_error(L, "Argument %d can't be stored safely\nExpected boolean, number, string, table or userdata.", i);
+				}
+				msg.addVariant(v);
+				v->release();
+				break;
+			}
+			}
 		}
 	}
 
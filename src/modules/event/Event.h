@@ -25,51 +25,192 @@
 #include <common/Module.h>
 #include <common/StringMap.h>
 #include <common/Variant.h>
+#include <common/int.h>
 #include <keyboard/Keyboard.h>
 #include <mouse/Mouse.h>
 #include <thread/threads.h>
 
-// STL
-#include <queue>
-
 namespace love
 {
 namespace event
 {
-	class Message : public Object
+	/**
+	* A queued event. Messages are plain data which are copied in and out
+	* of the queue, so input events cost no allocations. The name is an ID
+	* from Event::internName, and numbers, booleans and short strings are
+	* stored inline. Anything else is held by a Variant, which is released
+	* by clear(). So is the name, once the name table is full.
+	**/
+	struct Message
 	{
-	private:
-		std::string name;
-		Variant *args[4];
-		int nargs;
+		enum
+		{
+			MAX_ARGS = 4,
+			MAX_INLINE_STRING = 15,
 
-	public:
-		Message(std::string name, Variant *a = NULL, Variant *b = NULL, Variant *c = NULL, Variant *d = NULL);
-		~Message();
+			// The name of a message held by nameVariant.
+			NAME_UNINTERNED = 0xFFFF
+		};
+
+		enum ArgType
+		{
+			ARG_BOOLEAN,
+			ARG_NUMBER,
+			ARG_STRING,
+			ARG_VARIANT
+		};
+
+		struct Arg
+		{
+			uint8 type;
+			uint8 len;
+			union
+			{
+				bool boolean;
+				double number;
+				char string[MAX_INLINE_STRING+1];
+				Variant *variant;
+			};
+		};
+
+		uint16 name;
+		uint16 nargs;
+		Arg args[MAX_ARGS];
+		Variant *nameVariant;
+
+		void init(int name);
 
-		int toLua(lua_State *L);
-		static Message *fromLua(lua_State *L, int n);
+		/**
+		* Uses a name which is not in the name table. The Message keeps
+		* a copy of it.
+		**/
+		void init(const char *name, size_t len);
+		void addBoolean(bool b);
+		void addNumber(double n);
+		void addString(const char *str, size_t len);
+		void addString(const char *str);
+
+		/**
+		* Adds a Variant argument. The Message keeps a reference to it.
+		**/
+		void addVariant(Variant *v);
+
+		/**
+		* Releases the Variant arguments and name.
+		**/
+		void clear();
 	};
 
 	class Event : public Module
 	{
 	public:
+
+		/**
+		* IDs of the names used by the input events. Other names get IDs
+		* from internName when first pushed.
+		**/
+		enum Name
+		{
+			NAME_QUIT,
+			NAME_FOCUS,
+			NAME_KEYPRESSED,
+			NAME_KEYRELEASED,
+			NAME_MOUSEPRESSED,
+			NAME_MOUSERELEASED,
+			NAME_MOUSEMOVED,
+			NAME_JOYSTICKPRESSED,
+			NAME_JOYSTICKRELEASED,
+			NAME_MAX_BUILTIN
+		};
+
+		enum
+		{
+			QUEUE_CAPACITY = 1024,
+			MAX_NAMES = 256
+		};
+
+		Event();
 		virtual ~Event();
 
-		void push(Message *msg);
-		bool poll(Message *&msg);
+		/**
+		* Queues a message, which is copied. The queue takes over any
+		* Variants held by it.
+		* @return False (and the message is cleared) if the queue is full.
+		**/
+		bool push(Message &msg);
+
+		/**
+		* Removes the oldest message from the queue. The caller must clear()
+		* the copy when done with it.
+		**/
+		bool poll(Message &msg);
 		virtual void clear();
 
 		virtual void pump() = 0;
 
+		/**
+		* Gets the ID of an event name, adding it if this is the first use.
+		* Throws an Exception if there are too many names.
+		**/
+		int internName(const char *name);
+		const char *getEventName(int id) const;
+
+		/**
+		* Pushes a message's name and arguments onto the Lua stack.
+		* @return The number of values pushed.
+		**/
+		int toLua(lua_State *L, const Message &msg) const;
+
+		/**
+		* Pushes the function toLuaAndClear calls. As this may raise a Lua
+		* error, it is done before a message is taken from the queue.
+		**/
+		static void pushConverter(lua_State *L);
+
+		/**
+		* Like toLua, but also clears the message, even if the conversion
+		* raises a Lua error (which is then passed on). The function from
+		* pushConverter must be on top of the stack.
+		**/
+		int toLuaAndClear(lua_State *L, Message &msg) const;
+
+		/**
+		* Fills a message from the name and arguments on the Lua stack,
+		* starting at index n. Raises a Lua error for arguments which can't
+		* be stored. Names which don't fit in the name table are held by
+		* the message instead.
+		**/
+		void fromLua(lua_State *L, int n, Message &msg);
+
 		static bool getConstant(const char * in, love::mouse::Mouse::Button & out);
 		static bool getConstant(love::mouse::Mouse::Button in, const char *& out);
 		static bool getConstant(const char * in, love::keyboard::Keyboard::Key & out);
 		static bool getConstant(love::keyboard::Keyboard::Key in, const char *& out);
 
 	protected:
+
+		/**
+		* Called after a message is queued, from the pushing thread. Backends
+		* which can block waiting for input should wake the waiter here.
+		**/
+		virtual void wake();
+
+		/**
+		* Like internName, but returns -1 if the name table is full.
+		**/
+		int addName(const char *name);
+
 		thread::Mutex mutex;
-		std::queue<Message*> queue;
+		Message queue[QUEUE_CAPACITY];
+		int head;
+		int count;
+
+		// Names are never removed, so a pointer read under the lock (or
+		// for an ID taken from a queued message) stays valid.
+		thread::Mutex namesMutex;
+		const char *names[MAX_NAMES];
+		int numNames;
+
 		static StringMap<love::mouse::Mouse::Button, love::mouse::Mouse::BUTTON_MAX_ENUM>::Entry buttonEntries[];
 		static StringMap<love::mouse::Mouse::Button, love::mouse::Mouse::BUTTON_MAX_ENUM> buttons;
 		static StringMap<love::keyboard::Keyboard::Key, love::keyboard::Keyboard::KEY_MAX_ENUM>::Entry keyEntries[];
@@ -3,6 +3,9 @@
 
 #include "Event.h"
 
+#include <sys/time.h>
+#include <algorithm>
+
 #include <keyboard/Keyboard.h>
 #include <keyboard/ppapi/Keyboard.h>
 #include <mouse/Mouse.h>
@@ -55,47 +58,82 @@ const char * Event::getName() const {
 Event::Event() {
 }
 
+bool Event::setFilter(const char* name, bool enabled) {
+  love::window::ppapi::InputFilter filter;
+  if (!filters.find(name, filter))
+    return false;
+  love::window::ppapi::SetInputFilter(filter, enabled);
+  return true;
+}
+
+bool Event::getFilter(const char* name, bool* enabled) {
+  love::window::ppapi::InputFilter filter;
+  if (!filters.find(name, filter))
+    return false;
+  *enabled = love::window::ppapi::IsInputEnabled(filter);
+  return true;
+}
+
+void Event::setMouseMoveCoalescing(bool coalesce) {
+  love::window::ppapi::SetMouseMoveCoalescing(coalesce);
+}
+
 void Event::pump() {
   using namespace love::window::ppapi;
-  InputEvents events;
-  DequeueAllEvents(&events);
+  DequeueAllEvents(&events_);
 
-  Message *msg;
-  for (InputEvents::iterator iter = events.begin();
-      iter != events.end();
+  Message msg;
+  for (InputEvents::iterator iter = events_.begin();
+      iter != events_.end();
       ++iter) {
-    const InputEvent& event = *iter;
-    msg = convert(event);
-    if (msg) {
+    if (convert(*iter, &msg))
       push(msg);
-      msg->release();
-    }
   }
 }
 
 void Event::clear() {
   using namespace love::window::ppapi;
-  InputEvents events;
-  DequeueAllEvents(&events);
+  DequeueAllEvents(&events_);
+  events_.clear();
   love::event::Event::clear();
 }
 
-Message* Event::wait() {
+bool Event::wait(Message* msg, int timeout_ms) {
   using namespace love::window::ppapi;
-  WaitForEvent();
-  InputEvent event;
-  if (DequeueEvent(&event))
-    return convert(event);
-  return NULL;
+  struct timeval start;
+  gettimeofday(&start, NULL);
+
+  while (true) {
+    // Read first, so a message pushed between the poll and the wait
+    // makes the wait return at once.
+    uint32_t generation = GetWakeGeneration();
+    if (poll(*msg))
+      return true;
+
+    int remaining = -1;
+    if (timeout_ms >= 0) {
+      struct timeval now;
+      gettimeofday(&now, NULL);
+      int elapsed = (now.tv_sec - start.tv_sec) * 1000 +
+                    (now.tv_usec - start.tv_usec) / 1000;
+      remaining = std::max(timeout_ms - elapsed, 0);
+    }
+    // Input which converts to no message (a focus change, say) loops
+    // around to wait for the rest of the timeout.
+    if (!WaitForEvent(remaining, generation))
+      return false;
+    pump();
+  }
 }
 
-Message* Event::convert(const love::window::ppapi::InputEvent& event) {
+void Event::wake() {
+  love::window::ppapi::WakeEventWaiters();
+}
+
+bool Event::convert(const love::window::ppapi::InputEvent& event,
+                    Message* msg) {
   using namespace love::window::ppapi;
 
-  Message* msg = NULL;
-  Variant *arg1 = NULL;
-  Variant *arg2 = NULL;
-  Variant *arg3 = NULL;
   const char* txt = NULL;
 
   switch (event.type) {
@@ -106,26 +144,31 @@ Message* Event::convert(const love::window::ppapi::InputEvent& event) {
           love::mouse::Mouse::Button button;
           if (buttons.find(event.mouse.button, button) &&
               love::event::Event::buttons.find(button, txt)) {
-            arg1 = new Variant((double) event.mouse.x);
-            arg2 = new Variant((double) event.mouse.y);
-            arg3 = new Variant(txt, strlen(txt));
-            const char* type = event.mouse.type == MOUSE_DOWN ?
-                "mousepressed" : "mousereleased";
-            msg = new Message(type, arg1, arg2, arg3);
+            msg->init(event.mouse.type == MOUSE_DOWN ?
+                NAME_MOUSEPRESSED : NAME_MOUSERELEASED);
+            msg->addNumber(event.mouse.x);
+            msg->addNumber(event.mouse.y);
+            msg->addString(txt);
+            return true;
           }
           break;
         }
+        case MOUSE_MOVE:
+          msg->init(NAME_MOUSEMOVED);
+          msg->addNumber(event.mouse.x);
+          msg->addNumber(event.mouse.y);
+          msg->addNumber(event.mouse.movement_x);
+          msg->addNumber(event.mouse.movement_y);
+          return true;
       }
       break;
 
-    case INPUT_WHEEL: {
-        arg1 = new Variant((double) GetMouseX());
-        arg2 = new Variant((double) GetMouseY());
-        const char* type = event.wheel.delta_y > 0 ? "wu" : "wd";
-        arg3 = new Variant(type, strlen(type));
-        msg = new Message("mousepressed", arg1, arg2, arg3);
-      }
-      break;
+    case INPUT_WHEEL:
+      msg->init(NAME_MOUSEPRESSED);
+      msg->addNumber(GetMouseX());
+      msg->addNumber(GetMouseY());
+      msg->addString(event.wheel.delta_y > 0 ? "wu" : "wd");
+      return true;
 
     case INPUT_KEY:
       switch (event.key.type) {
@@ -134,11 +177,11 @@ Message* Event::convert(const love::window::ppapi::InputEvent& event) {
           love::keyboard::Keyboard::Key key;
           if (love::keyboard::ppapi::Keyboard::Convert((KeyCode) event.key.code, &key) &&
               love::event::Event::keys.find(key, txt)) {
-            arg1 = new Variant(txt, strlen(txt));
-            arg2 = new Variant((double) DecodeUtf8(event.key.text));
-            const char* type = event.key.type == KEY_DOWN ?
-                "keypressed" : "keyreleased";
-            msg = new Message(type, arg1, arg2);
+            msg->init(event.key.type == KEY_DOWN ?
+                NAME_KEYPRESSED : NAME_KEYRELEASED);
+            msg->addString(txt);
+            msg->addNumber(DecodeUtf8(event.key.text));
+            return true;
           }
           break;
         }
@@ -146,11 +189,7 @@ Message* Event::convert(const love::window::ppapi::InputEvent& event) {
       break;
   }
 
-  if (arg1) arg1->release();
-  if (arg2) arg2->release();
-  if (arg3) arg3->release();
-
-  return msg;
+  return false;
 }
 
 /*
@@ -229,6 +268,16 @@ Message* Event::convert(const love::window::ppapi::InputEvent& event) {
 
   Event::MouseEnumMap Event::buttons(Event::buttonEntries, sizeof(Event::buttonEntries));
 
+  Event::FilterMap::Entry Event::filterEntries[] = {
+    { "keypressed", love::window::ppapi::FILTER_KEY_DOWN },
+    { "keyreleased", love::window::ppapi::FILTER_KEY_UP },
+    { "mousepressed", love::window::ppapi::FILTER_MOUSE_DOWN },
+    { "mousereleased", love::window::ppapi::FILTER_MOUSE_UP },
+    { "mousemoved", love::window::ppapi::FILTER_MOUSE_MOVE },
+  };
+
+  Event::FilterMap Event::filters(Event::filterEntries, sizeof(Event::filterEntries));
+
 } // ppapi
 } // event
 } // love
@@ -23,16 +23,36 @@ class Event : public love::event::Event {
 
     void pump();
     void clear();
-    Message* wait();
+    // Takes the next message, waiting up to |timeout_ms| (or forever if
+    // negative) for one to arrive. Returns false if it timed out.
+    bool wait(Message* msg, int timeout_ms);
+
+    // Turns delivery of an event type on or off. Only input events can be
+    // filtered; mouse motion ("mousemoved") is off by default. Returns
+    // false if |name| can't be filtered.
+    bool setFilter(const char* name, bool enabled);
+    bool getFilter(const char* name, bool* enabled);
+
+    // Merges runs of queued mouse moves into one event. On by default.
+    void setMouseMoveCoalescing(bool coalesce);
+
+  protected:
+    void wake();
 
   private:
-    Message* convert(const love::window::ppapi::InputEvent& event);
+    bool convert(const love::window::ppapi::InputEvent& event, Message* msg);
 
     typedef love::mouse::Mouse::Button LoveMouseButton;
     typedef love::window::ppapi::MouseButton PPAPIMouseButton;
     typedef EnumMap<LoveMouseButton, PPAPIMouseButton, love::window::ppapi::MOUSE_BUTTON_MAX> MouseEnumMap;
     static MouseEnumMap::Entry buttonEntries[];
     static MouseEnumMap buttons;
+
+    typedef StringMap<love::window::ppapi::InputFilter, love::window::ppapi::FILTER_MAX> FilterMap;
+    static FilterMap::Entry filterEntries[];
+    static FilterMap filters;
+
+    love::window::ppapi::InputEvents events_;
 }; // System
 
 } // ppapi
@@ -21,10 +21,14 @@
 #include "wrap_Event.h"
 
 // LOVE
+#include <common/int.h>
 #include <common/runtime.h>
 
 #include "Event.h"
 
+// STD
+#include <algorithm>
+
 namespace love
 {
 namespace event
@@ -35,14 +39,11 @@ namespace ppapi
 
 	static int poll_i(lua_State * L)
 	{
-		Message *m;
+		Message m;
+		lua_pushvalue(L, lua_upvalueindex(1));
 
-		while (instance->poll(m))
-		{
-			int args = m->toLua(L);
-			m->release();
-			return args;
-		}
+		if (instance->poll(m))
+			return instance->toLuaAndClear(L, m);
 
 		// No pending events.
 		return 0;
@@ -56,52 +57,73 @@ namespace ppapi
 
 	int w_poll(lua_State * L)
 	{
-		lua_pushcclosure(L, &poll_i, 0);
+		// The converter is shared by every call of the iterator.
+		Event::pushConverter(L);
+		lua_pushcclosure(L, &poll_i, 1);
 		return 1;
 	}
 
 	int w_wait(lua_State * L)
 	{
-		static Message *m;
-
-		if ((m = instance->wait()))
+		Message m;
+		int timeout = -1;
+		if (!lua_isnoneornil(L, 1))
 		{
-			int args = m->toLua(L);
-			m->release();
-			return args;
+			double ms = luaL_checknumber(L, 1) * 1000.0;
+			timeout = (int) std::min(std::max(ms, 0.0), (double) LOVE_INT32_MAX);
 		}
 
+		Event::pushConverter(L);
+		if (instance->wait(&m, timeout))
+			return instance->toLuaAndClear(L, m);
+
 		return 0;
 	}
 
 	int w_push(lua_State * L)
 	{
-		static Message *m;
-
-		bool success = (m = Message::fromLua(L, 1)) != NULL;
-		luax_pushboolean(L, success);
+		Message m;
+		instance->fromLua(L, 1, m);
+		luax_pushboolean(L, instance->push(m));
+		return 1;
+	}
 
-		if (!success)
-			return 1;
+	int w_clear(lua_State *)
+	{
+		instance->clear();
+		return 0;
+	}
 
-		instance->push(m);
-		m->release();
+	int w_setFilter(lua_State * L)
+	{
+		const char * name = luaL_checkstring(L, 1);
+		bool enabled = luax_toboolean(L, 2);
+		if (!instance->setFilter(name, enabled))
+			return luaL_error(L, "Invalid event name: %s", name);
+		return 0;
+	}
 
+	int w_getFilter(lua_State * L)
+	{
+		const char * name = luaL_checkstring(L, 1);
+		bool enabled;
+		if (!instance->getFilter(name, &enabled))
+			return luaL_error(L, "Invalid event name: %s", name);
+		luax_pushboolean(L, enabled);
 		return 1;
 	}
 
-	int w_clear(lua_State *)
+	int w_setMotionCoalescing(lua_State * L)
 	{
-		instance->clear();
+		instance->setMouseMoveCoalescing(luax_toboolean(L, 1));
 		return 0;
 	}
 
 	int w_quit(lua_State * L)
 	{
-		Message *m = new Message("quit");
-		instance->push(m);
-		m->release();
-		luax_pushboolean(L, true);
+		Message m;
+		m.init(Event::NAME_QUIT);
+		luax_pushboolean(L, instance->push(m));
 		return 1;
 	}
 
@@ -112,6 +134,9 @@ namespace ppapi
 		{ "wait", w_wait },
 		{ "push", w_push },
 		{ "clear", w_clear },
+		{ "setFilter", w_setFilter },
+		{ "getFilter", w_getFilter },
+		{ "setMotionCoalescing", w_setMotionCoalescing },
 		{ "quit", w_quit },
 		{ 0, 0 }
 	};
@@ -36,6 +36,9 @@ namespace ppapi
 	int w_wait(lua_State * L);
 	int w_push(lua_State * L);
 	int w_clear(lua_State * L);
+	int w_setFilter(lua_State * L);
+	int w_getFilter(lua_State * L);
+	int w_setMotionCoalescing(lua_State * L);
 	int w_quit(lua_State * L);
 
 	extern "C" LOVE_EXPORT int luaopen_love_event(lua_State * L);
@@ -46,26 +46,22 @@ namespace sdl
 		static SDL_Event e;
 		SDL_EnableUNICODE(1);
 
-		Message *msg;
+		Message msg;
 
 		while (SDL_PollEvent(&e))
 		{
-			msg = convert(e);
-			if (msg)
-			{
+			if (convert(e, msg))
 				push(msg);
-				msg->release();
-			}
 		}
 	}
 
-	Message *Event::wait()
+	bool Event::wait(Message & msg)
 	{
 		static SDL_Event e;
 		bool ok = (SDL_WaitEvent(&e) == 1);
 		if (!ok)
-			return NULL;
-		return convert(e);
+			return false;
+		return convert(e, msg);
 	}
 
 	void Event::clear()
@@ -80,70 +76,63 @@ namespace sdl
 		love::event::Event::clear();
 	}
 
-	Message *Event::convert(SDL_Event & e)
+	bool Event::convert(SDL_Event & e, Message & msg)
 	{
-		Message *msg = NULL;
 		love::keyboard::Keyboard::Key key;
 		love::mouse::Mouse::Button button;
-		Variant *arg1, *arg2, *arg3;
 		const char *txt;
 		switch(e.type)
 		{
 		case SDL_KEYDOWN:
 			if (keys.find(e.key.keysym.sym, key) && love::event::Event::keys.find(key, txt))
 			{
-				arg1 = new Variant(txt, strlen(txt));
-				arg2 = new Variant((double) e.key.keysym.unicode);
-				msg = new Message("keypressed", arg1, arg2);
-				arg1->release();
-				arg2->release();
+				msg.init(NAME_KEYPRESSED);
+				msg.addString(txt);
+				msg.addNumber(e.key.keysym.unicode);
+				return true;
 			}
 			break;
 		case SDL_KEYUP:
 			if (keys.find(e.key.keysym.sym, key) && love::event::Event::keys.find(key, txt))
 			{
-				arg1 = new Variant(txt, strlen(txt));
-				msg = new Message("keyreleased", arg1);
-				arg1->release();
+				msg.init(NAME_KEYRELEASED);
+				msg.addString(txt);
+				return true;
 			}
 			break;
 		case SDL_MOUSEBUTTONDOWN:
 		case SDL_MOUSEBUTTONUP:
 			if (buttons.find(e.button.button, button) && love::event::Event::buttons.find(button, txt))
 			{
-				arg1 = new Variant((double) e.button.x);
-				arg2 = new Variant((double) e.button.y);
-				arg3 = new Variant(txt, strlen(txt));
-				msg = new Message((e.type == SDL_MOUSEBUTTONDOWN) ?
-						"mousepressed" : "mousereleased",
-						arg1, arg2, arg3);
-				arg1->release();
-				arg2->release();
-				arg3->release();
+				msg.init((e.type == SDL_MOUSEBUTTONDOWN) ?
+						NAME_MOUSEPRESSED : NAME_MOUSERELEASED);
+				msg.addNumber(e.button.x);
+				msg.addNumber(e.button.y);
+				msg.addString(txt);
+				return true;
 			}
 			break;
 		case SDL_JOYBUTTONDOWN:
 		case SDL_JOYBUTTONUP:
-			arg1 = new Variant((double) (e.jbutton.which+1));
-			arg2 = new Variant((double) (e.jbutton.button+1));
-			msg = new Message((e.type == SDL_JOYBUTTONDOWN) ?
-					"joystickpressed" : "joystickreleased",
-					arg1, arg2);
-			arg1->release();
-			arg2->release();
-			break;
+			msg.init((e.type == SDL_JOYBUTTONDOWN) ?
+					NAME_JOYSTICKPRESSED : NAME_JOYSTICKRELEASED);
+			msg.addNumber(e.jbutton.which+1);
+			msg.addNumber(e.jbutton.button+1);
+			return true;
 		case SDL_ACTIVEEVENT:
-			arg1 = new Variant(e.active.gain != 0);
 			if (e.active.state & SDL_APPINPUTFOCUS)
-				msg = new Message("focus", arg1);
-			arg1->release();
+			{
+				msg.init(NAME_FOCUS);
+				msg.addBoolean(e.active.gain != 0);
+				return true;
+			}
 			break;
 		case SDL_QUIT:
-			msg = new Message("quit");
-			break;
+			msg.init(NAME_QUIT);
+			return true;
 		}
 
-		return msg;
+		return false;
 	}
 
 	EnumMap<love::keyboard::Keyboard::Key, SDLKey, love::keyboard::Keyboard::KEY_MAX_ENUM>::Entry Event::keyEntries[] =
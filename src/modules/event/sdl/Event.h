@@ -55,8 +55,9 @@ namespace sdl
 		* Waits for the next event (indefinitely). Useful for creating games where
 		* the screen and game state only needs updating when the user interacts with
 		* the window.
+		* @return False if the event was not one which love.event reports.
 		**/
-		Message *wait();
+		bool wait(Message & msg);
 
 		/**
 		 * Clears the event queue.
@@ -65,7 +66,7 @@ namespace sdl
 
 	private:
 
-		Message *convert(SDL_Event & e);
+		bool convert(SDL_Event & e, Message & msg);
 
 		static EnumMap<love::keyboard::Keyboard::Key, SDLKey, love::keyboard::Keyboard::KEY_MAX_ENUM>::Entry keyEntries[];
 		static EnumMap<love::keyboard::Keyboard::Key, SDLKey, love::keyboard::Keyboard::KEY_MAX_ENUM> keys;
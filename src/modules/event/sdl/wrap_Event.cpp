@@ -36,14 +36,11 @@ namespace sdl
 
 	static int poll_i(lua_State * L)
 	{
-		Message *m;
+		Message m;
+		lua_pushvalue(L, lua_upvalueindex(1));
 
-		while (instance->poll(m))
-		{
-			int args = m->toLua(L);
-			m->release();
-			return args;
-		}
+		if (instance->poll(m))
+			return instance->toLuaAndClear(L, m);
 
 		// No pending events.
 		return 0;
@@ -57,37 +54,28 @@ namespace sdl
 
 	int w_poll(lua_State * L)
 	{
-		lua_pushcclosure(L, &poll_i, 0);
+		// The converter is shared by every call of the iterator.
+		Event::pushConverter(L);
+		lua_pushcclosure(L, &poll_i, 1);
 		return 1;
 	}
 
 	int w_wait(lua_State * L)
 	{
-		static Message *m;
+		Message m;
+		Event::pushConverter(L);
 
-		if ((m = instance->wait()))
-		{
-			int args = m->toLua(L);
-			m->release();
-			return args;
-		}
+		if (instance->wait(m))
+			return instance->toLuaAndClear(L, m);
 
 		return 0;
 	}
 
 	int w_push(lua_State * L)
 	{
-		static Message *m;
-
-		bool success = (m = Message::fromLua(L, 1)) != NULL;
-		luax_pushboolean(L, success);
-
-		if (!success)
-			return 1;
-
-		instance->push(m);
-		m->release();
-
+		Message m;
+		instance->fromLua(L, 1, m);
+		luax_pushboolean(L, instance->push(m));
 		return 1;
 	}
 
@@ -99,10 +87,9 @@ namespace sdl
 
 	int w_quit(lua_State * L)
 	{
-		Message *m = new Message("quit");
-		instance->push(m);
-		m->release();
-		luax_pushboolean(L, true);
+		Message m;
+		m.init(Event::NAME_QUIT);
+		luax_pushboolean(L, instance->push(m));
 		return 1;
 	}
 
@@ -38,6 +38,16 @@ namespace filesystem
 		return modes.find(in, out);
 	}
 
+	bool File::getConstant(const char * in, BufferMode & out)
+	{
+		return bufferModes.find(in, out);
+	}
+
+	bool File::getConstant(BufferMode in, const char *& out)
+	{
+		return bufferModes.find(in, out);
+	}
+
 	StringMap<File::Mode, File::MODE_MAX_ENUM>::Entry File::modeEntries[] =
 	{
 		{"c", File::CLOSED},
@@ -48,5 +58,14 @@ namespace filesystem
 
 	StringMap<File::Mode, File::MODE_MAX_ENUM> File::modes(File::modeEntries, sizeof(File::modeEntries));
 
+	StringMap<File::BufferMode, File::BUFFER_MAX_ENUM>::Entry File::bufferModeEntries[] =
+	{
+		{"none", File::BUFFER_NONE},
+		{"line", File::BUFFER_LINE},
+		{"full", File::BUFFER_FULL},
+	};
+
+	StringMap<File::BufferMode, File::BUFFER_MAX_ENUM> File::bufferModes(File::bufferModeEntries, sizeof(File::bufferModeEntries));
+
 } // filesystem
 } // love
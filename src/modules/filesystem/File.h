@@ -54,6 +54,17 @@ namespace filesystem
 			MODE_MAX_ENUM
 		};
 
+		/**
+		* How writes are buffered before they reach the file.
+		**/
+		enum BufferMode
+		{
+			BUFFER_NONE,
+			BUFFER_LINE,
+			BUFFER_FULL,
+			BUFFER_MAX_ENUM
+		};
+
 		/**
 		* Used to indicate ALL data in a file.
 		**/
@@ -143,6 +154,32 @@ namespace filesystem
 		**/
 		virtual bool seek(uint64 pos) = 0;
 
+		/**
+		* Sets the buffering of the File. The buffer is used for both
+		* reads and writes; in line mode, writes containing a newline
+		* are flushed.
+		*
+		* @param mode BUFFER_NONE, BUFFER_LINE or BUFFER_FULL.
+		* @param size The size of the buffer in bytes.
+		* @return True on success, false otherwise.
+		**/
+		virtual bool setBuffer(BufferMode mode, int64 size) = 0;
+
+		/**
+		* Gets the buffering of the File.
+		*
+		* @param size Set to the size of the buffer in bytes.
+		* @return The buffer mode.
+		**/
+		virtual BufferMode getBuffer(int64 & size) const = 0;
+
+		/**
+		* Writes out any buffered data.
+		*
+		* @return True on success, false otherwise.
+		**/
+		virtual bool flush() = 0;
+
 		/**
 		* Gets the current mode of the File.
 		* @return The current mode of the File; CLOSED, READ, WRITE or APPEND.
@@ -164,11 +201,17 @@ namespace filesystem
 		static bool getConstant(const char * in, Mode & out);
 		static bool getConstant(Mode in, const char *& out);
 
+		static bool getConstant(const char * in, BufferMode & out);
+		static bool getConstant(BufferMode in, const char *& out);
+
 	private:
 
 		static StringMap<Mode, MODE_MAX_ENUM>::Entry modeEntries[];
 		static StringMap<Mode, MODE_MAX_ENUM> modes;
 
+		static StringMap<BufferMode, BUFFER_MAX_ENUM>::Entry bufferModeEntries[];
+		static StringMap<BufferMode, BUFFER_MAX_ENUM> bufferModes;
+
 	}; // File
 
 } // filesystem
@@ -29,15 +29,27 @@ namespace love
 namespace filesystem
 {
 	FileData::FileData(uint64 size, const std::string & filename)
-		: data(new char[(size_t) size]), size(size), filename(filename)
+		: data(new char[(size_t) size]), owner(0), size(size), filename(filename)
 	{
 		if (filename.rfind('.') != std::string::npos)
 			extension = filename.substr(filename.rfind('.')+1);
 	}
 
+	FileData::FileData(void * data, uint64 size, const std::string & filename, Object * owner)
+		: data((char *) data), owner(owner), size(size), filename(filename)
+	{
+		owner->retain();
+
+		if (filename.rfind('.') != std::string::npos)
+			extension = filename.substr(filename.rfind('.')+1);
+	}
+
 	FileData::~FileData()
 	{
-		delete [] data;
+		if (owner != 0)
+			owner->release();
+		else
+			delete [] data;
 	}
 
 	void * FileData::getData() const
@@ -66,6 +78,11 @@ namespace filesystem
 		return extension;
 	}
 
+	bool FileData::isView() const
+	{
+		return owner != 0;
+	}
+
 	bool FileData::getConstant(const char * in, Decoder & out)
 	{
 		return decoders.find(in, out);
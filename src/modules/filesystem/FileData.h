@@ -38,6 +38,9 @@ namespace filesystem
 		// The actual data.
 		char * data;
 
+		// Owner of the data if this is a view, otherwise 0.
+		Object * owner;
+
 		// Size of the data.
 		uint64 size;
 
@@ -58,6 +61,17 @@ namespace filesystem
 
 		FileData(uint64 size, const std::string & filename);
 
+		/**
+		* Creates a read-only view of data owned by another object,
+		* instead of copying it. The owner is retained for the lifetime
+		* of the FileData.
+		* @param data Pointer to the data.
+		* @param size The size of the data.
+		* @param filename The full filename used to file type identification.
+		* @param owner The object which keeps the data alive.
+		**/
+		FileData(void * data, uint64 size, const std::string & filename, Object * owner);
+
 		virtual ~FileData();
 
 		// Implements Data.
@@ -69,6 +83,12 @@ namespace filesystem
 		const std::string & getFilename() const;
 		const std::string & getExtension() const;
 
+		/**
+		* Checks whether the data is a view of another object's data.
+		* Views must not be written to.
+		**/
+		bool isView() const;
+
 		static bool getConstant(const char * in, Decoder & out);
 		static bool getConstant(Decoder in, const char *& out);
 
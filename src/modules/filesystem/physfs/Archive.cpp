@@ -0,0 +1,291 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+// A 64-bit off_t for fseeko on 32-bit glibc.
+#ifndef _FILE_OFFSET_BITS
+#	define _FILE_OFFSET_BITS 64
+#endif
+
+#include "Archive.h"
+
+// STD
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <sys/types.h>
+
+// LOVE
+#include <common/config.h>
+#include <common/Exception.h>
+#include <filesystem/FileData.h>
+#include <thread/threads.h>
+
+namespace love
+{
+namespace filesystem
+{
+namespace physfs
+{
+	namespace
+	{
+		// fseek and ftell use a long, which is 32 bits on some
+		// platforms; archives may be larger than that.
+		int seek64(FILE * file, int64 offset, int origin)
+		{
+#ifdef LOVE_WINDOWS
+			return _fseeki64(file, offset, origin);
+#else
+			return fseeko(file, (off_t) offset, origin);
+#endif
+		}
+
+		int64 tell64(FILE * file)
+		{
+#ifdef LOVE_WINDOWS
+			return (int64) _ftelli64(file);
+#else
+			return (int64) ftello(file);
+#endif
+		}
+	}
+
+	const void * ArchiveIO::getPointer(int64, int64)
+	{
+		return 0;
+	}
+
+	int64 ArchiveIO::getCacheLimit() const
+	{
+		return 0;
+	}
+
+	FileIO::FileIO(const char * filename, int64 cacheLimit)
+		: file(0), size(0), cacheLimit(cacheLimit)
+	{
+		file = fopen(filename, "rb");
+		if (file == 0)
+			throw love::Exception("Could not open file %s.", filename);
+
+		seek64(file, 0, SEEK_END);
+		size = tell64(file);
+	}
+
+	FileIO::~FileIO()
+	{
+		fclose(file);
+	}
+
+	int64 FileIO::getSize()
+	{
+		return size;
+	}
+
+	bool FileIO::read(void * dst, int64 offset, int64 size)
+	{
+		if (offset < 0 || size < 0 || offset + size > this->size)
+			return false;
+
+		if (seek64(file, offset, SEEK_SET) != 0)
+			return false;
+
+		return fread(dst, 1, (size_t) size, file) == (size_t) size;
+	}
+
+	int64 FileIO::getCacheLimit() const
+	{
+		return cacheLimit;
+	}
+
+	MemoryIO::MemoryIO(int64 capacity)
+		: data(0), size(0), capacity(0)
+	{
+		reserve(capacity);
+	}
+
+	MemoryIO::~MemoryIO()
+	{
+		free(data);
+	}
+
+	bool MemoryIO::reserve(int64 capacity)
+	{
+		if (capacity <= this->capacity)
+			return true;
+
+		char * grown = (char *) realloc(data, (size_t) capacity);
+		if (grown == 0)
+			return false;
+
+		data = grown;
+		this->capacity = capacity;
+		return true;
+	}
+
+	bool MemoryIO::append(const void * src, int64 size)
+	{
+		if (this->size + size > capacity)
+		{
+			// Grow geometrically when the final size is unknown.
+			int64 wanted = std::max(this->size + size, capacity * 2);
+			if (!reserve(wanted))
+				return false;
+		}
+
+		memcpy(data + this->size, src, (size_t) size);
+		this->size += size;
+		return true;
+	}
+
+	const char * MemoryIO::getPointer() const
+	{
+		return data;
+	}
+
+	int64 MemoryIO::getSize()
+	{
+		return size;
+	}
+
+	bool MemoryIO::read(void * dst, int64 offset, int64 size)
+	{
+		if (offset < 0 || size < 0 || offset + size > this->size)
+			return false;
+
+		memcpy(dst, data + offset, (size_t) size);
+		return true;
+	}
+
+	const void * MemoryIO::getPointer(int64 offset, int64 size)
+	{
+		if (offset < 0 || size < 0 || offset + size > this->size)
+			return 0;
+		return data + offset;
+	}
+
+	Data * Archive::read(const std::string & path, int64 offset, int64 size)
+	{
+		Data * whole = read(path);
+		if (whole == 0)
+			return 0;
+
+		int64 total = whole->getSize();
+		offset = std::min(std::max(offset, (int64) 0), total);
+		size = std::min(std::max(size, (int64) 0), total - offset);
+
+		Data * part = new FileData((char *) whole->getData() + offset, size, path, whole);
+		whole->release();
+		return part;
+	}
+
+	bool Archive::hasRangeReads() const
+	{
+		return false;
+	}
+
+	static std::vector<Archive *> mounted;
+	static std::map<std::string, ArchiveIO *> sources;
+
+	// Sources are added by the PPAPI thread, and archives are searched
+	// from the game and I/O threads.
+	static thread::Mutex registry;
+
+	void Archive::mount(Archive * archive)
+	{
+		thread::Lock lock(registry);
+		archive->retain();
+		mounted.push_back(archive);
+	}
+
+	void Archive::unmount(Archive * archive)
+	{
+		thread::Lock lock(registry);
+		std::vector<Archive *>::iterator it = std::find(mounted.begin(), mounted.end(), archive);
+		if (it == mounted.end())
+			return;
+
+		mounted.erase(it);
+		archive->release();
+	}
+
+	Archive * Archive::find(const char * path)
+	{
+		thread::Lock lock(registry);
+		if (mounted.empty())
+			return 0;
+
+		std::string p = normalize(path);
+		for (size_t i = 0; i < mounted.size(); i++)
+		{
+			if (mounted[i]->exists(p))
+				return mounted[i];
+		}
+		return 0;
+	}
+
+	std::vector<Archive *> Archive::getMounted()
+	{
+		thread::Lock lock(registry);
+		return mounted;
+	}
+
+	void Archive::addSource(const char * name, ArchiveIO * io)
+	{
+		thread::Lock lock(registry);
+		io->retain();
+
+		std::map<std::string, ArchiveIO *>::iterator it = sources.find(name);
+		if (it != sources.end())
+		{
+			it->second->release();
+			it->second = io;
+		}
+		else
+			sources[name] = io;
+	}
+
+	ArchiveIO * Archive::getSource(const char * name)
+	{
+		thread::Lock lock(registry);
+		std::map<std::string, ArchiveIO *>::iterator it = sources.find(name);
+		if (it == sources.end())
+			return 0;
+
+		// A later addSource may replace it at any time.
+		it->second->retain();
+		return it->second;
+	}
+
+	std::string Archive::normalize(const char * path)
+	{
+		while (*path == '/')
+			path++;
+
+		std::string p(path);
+		while (!p.empty() && p[p.size() - 1] == '/')
+			p.erase(p.size() - 1);
+
+		return p;
+	}
+
+} // physfs
+} // filesystem
+} // love
@@ -0,0 +1,242 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+#ifndef LOVE_FILESYSTEM_PHYSFS_ARCHIVE_H
+#define LOVE_FILESYSTEM_PHYSFS_ARCHIVE_H
+
+// STD
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// LOVE
+#include <common/Data.h>
+#include <common/Object.h>
+#include <common/int.h>
+
+namespace love
+{
+namespace filesystem
+{
+namespace physfs
+{
+	/**
+	* A random-access byte source an Archive is read from. This
+	* plays the part of PHYSFS_Io, which our PhysFS (2.0) lacks.
+	**/
+	class ArchiveIO : public Object
+	{
+	public:
+
+		virtual ~ArchiveIO() {}
+
+		/**
+		* Gets the total size of the source in bytes.
+		**/
+		virtual int64 getSize() = 0;
+
+		/**
+		* Reads bytes from the source.
+		* @param dst The destination buffer.
+		* @param offset The position in the source to read from.
+		* @param size The number of bytes to read.
+		* @return True if all bytes could be read.
+		**/
+		virtual bool read(void * dst, int64 offset, int64 size) = 0;
+
+		/**
+		* Gets a pointer to bytes of the source, for sources which
+		* hold them contiguously in memory. The pointer stays valid as
+		* long as the source is alive.
+		* @return The pointer, or 0 if read must be used instead.
+		**/
+		virtual const void * getPointer(int64 offset, int64 size);
+
+		/**
+		* Gets how many bytes of decoded files an archive read from
+		* this source should keep in memory. Sources which are slow
+		* to read, such as remote ones, should return a limit.
+		**/
+		virtual int64 getCacheLimit() const;
+
+	}; // ArchiveIO
+
+	/**
+	* Reads a local file with stdio. Useful as a stand-in for
+	* remote sources.
+	**/
+	class FileIO : public ArchiveIO
+	{
+	private:
+
+		FILE * file;
+		int64 size;
+		int64 cacheLimit;
+
+	public:
+
+		/**
+		* @param filename The file to read.
+		* @param cacheLimit The value for getCacheLimit.
+		**/
+		FileIO(const char * filename, int64 cacheLimit = 0);
+		virtual ~FileIO();
+
+		// Implements ArchiveIO.
+		int64 getSize();
+		bool read(void * dst, int64 offset, int64 size);
+		int64 getCacheLimit() const;
+
+	}; // FileIO
+
+	/**
+	* A growable buffer in memory, for instance a downloaded .love file.
+	* It must not be appended to once an archive reads from it, as
+	* views of its data may exist.
+	**/
+	class MemoryIO : public ArchiveIO
+	{
+	private:
+
+		char * data;
+		int64 size;
+		int64 capacity;
+
+	public:
+
+		MemoryIO(int64 capacity = 0);
+		virtual ~MemoryIO();
+
+		/**
+		* Makes room for at least capacity bytes, so that appending
+		* up to that size does not reallocate.
+		**/
+		bool reserve(int64 capacity);
+
+		/**
+		* Appends bytes at the end of the buffer.
+		**/
+		bool append(const void * src, int64 size);
+
+		/**
+		* Gets a pointer to the buffer. It is invalidated by append.
+		**/
+		const char * getPointer() const;
+
+		// Implements ArchiveIO.
+		int64 getSize();
+		bool read(void * dst, int64 offset, int64 size);
+		const void * getPointer(int64 offset, int64 size);
+
+	}; // MemoryIO
+
+	/**
+	* A read-only tree of files outside of PhysFS. Mounted archives
+	* are searched after the PhysFS search path, so the save
+	* directory still overrides them.
+	**/
+	class Archive : public Object
+	{
+	public:
+
+		virtual ~Archive() {}
+
+		virtual bool exists(const std::string & path) = 0;
+		virtual bool isDirectory(const std::string & path) = 0;
+
+		/**
+		* Appends the names of the entries in a directory.
+		**/
+		virtual void enumerate(const std::string & dir, std::vector<std::string> & files) = 0;
+
+		/**
+		* Gets the modification time of a file, or -1.
+		**/
+		virtual int64 getLastModified(const std::string & path) = 0;
+
+		/**
+		* Gets the size of a file without reading it, or -1.
+		**/
+		virtual int64 getSize(const std::string & path) = 0;
+
+		/**
+		* Reads a whole file.
+		* @return A new Data object, or 0 if the file could not be read.
+		**/
+		virtual Data * read(const std::string & path) = 0;
+
+		/**
+		* Reads part of a file. The default reads the whole file.
+		* @return A new Data object of the bytes in the range which
+		* exist, or 0 if the file could not be read.
+		**/
+		virtual Data * read(const std::string & path, int64 offset, int64 size);
+
+		/**
+		* Whether reading part of a file costs less than reading all
+		* of it, so that files need not be read whole when opened.
+		**/
+		virtual bool hasRangeReads() const;
+
+		/**
+		* Adds an archive to the end of the archive search list.
+		**/
+		static void mount(Archive * archive);
+
+		/**
+		* Removes an archive from the search list.
+		**/
+		static void unmount(Archive * archive);
+
+		/**
+		* Finds the first mounted archive containing a file or directory.
+		* @return The archive, or 0 if none has the path.
+		**/
+		static Archive * find(const char * path);
+
+		/**
+		* Gets all mounted archives, in search order.
+		**/
+		static std::vector<Archive *> getMounted();
+
+		/**
+		* Registers a byte source under a name. Filesystem::setSource
+		* mounts such sources directly instead of going through PhysFS.
+		**/
+		static void addSource(const char * name, ArchiveIO * io);
+
+		/**
+		* Gets the byte source registered under a name, or 0.
+		* The caller must release the source.
+		**/
+		static ArchiveIO * getSource(const char * name);
+
+		/**
+		* Removes the leading and trailing slashes from a path.
+		**/
+		static std::string normalize(const char * path);
+
+	}; // Archive
+
+} // physfs
+} // filesystem
+} // love
+
+#endif // LOVE_FILESYSTEM_PHYSFS_ARCHIVE_H
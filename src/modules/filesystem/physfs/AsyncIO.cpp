@@ -0,0 +1,230 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+
+#include <cstring>
+
+#include <common/Exception.h>
+
+#include "AsyncIO.h"
+#include "File.h"
+
+namespace love
+{
+namespace filesystem
+{
+namespace physfs
+{
+	AsyncIO::AsyncIO(love::event::Event * target, int workers)
+		: target(target), next_id(1)
+	{
+		// Interned here, where a full name table is an error for the
+		// caller instead of a lost completion on an I/O thread.
+		int name = target->internName(LOVE_ASYNC_IO_EVENT);
+
+		for (int i = 0; i < workers; i++)
+		{
+			Worker * worker = new Worker(target, name);
+			if (!worker->start())
+			{
+				delete worker;
+				break;
+			}
+			this->workers.push_back(worker);
+		}
+
+		if (this->workers.empty())
+			throw love::Exception("Could not start the asynchronous I/O threads.");
+
+		target->retain();
+	}
+
+	AsyncIO::~AsyncIO()
+	{
+		for (size_t i = 0; i < workers.size(); i++)
+		{
+			workers[i]->stop();
+			delete workers[i];
+		}
+		target->release();
+	}
+
+	int AsyncIO::read(const std::string & filename)
+	{
+		Request * request = new Request();
+		request->type = Request::READ;
+		request->filename = filename;
+		return push(request);
+	}
+
+	int AsyncIO::write(const std::string & filename, const void * data, size_t size)
+	{
+		Request * request = new Request();
+		request->type = Request::WRITE;
+		request->filename = filename;
+		request->data.assign((const char *) data, size);
+		return push(request);
+	}
+
+	int AsyncIO::push(Request * request)
+	{
+		request->id = next_id++;
+
+		// Requests on one path always use the same thread, which keeps
+		// them in order (a read after a write sees the write).
+		unsigned int hash = 2166136261u;
+		for (size_t i = 0; i < request->filename.size(); i++)
+			hash = (hash ^ (unsigned char) request->filename[i]) * 16777619u;
+
+		workers[hash % workers.size()]->push(request);
+		return request->id;
+	}
+
+	AsyncIO::Worker::Worker(love::event::Event * target, int name)
+		: target(target), name(name), stopping(false)
+	{
+	}
+
+	AsyncIO::Worker::~Worker()
+	{
+		while (!requests.empty())
+		{
+			delete requests.front();
+			requests.pop();
+		}
+	}
+
+	void AsyncIO::Worker::push(Request * request)
+	{
+		{
+			thread::Lock lock(mutex);
+			requests.push(request);
+		}
+		cond.signal();
+	}
+
+	void AsyncIO::Worker::stop()
+	{
+		{
+			thread::Lock lock(mutex);
+			stopping = true;
+		}
+		cond.signal();
+		wait();
+	}
+
+	void AsyncIO::Worker::main()
+	{
+		while (true)
+		{
+			Request * request = 0;
+			{
+				thread::Lock lock(mutex);
+				while (requests.empty() && !stopping)
+					cond.wait(&mutex);
+
+				// Once stopped, reads are dropped, but the queued writes
+				// still run so that no data is lost on quit.
+				while (stopping && !requests.empty() && requests.front()->type == Request::READ)
+				{
+					delete requests.front();
+					requests.pop();
+				}
+				if (requests.empty())
+					return;
+
+				request = requests.front();
+				requests.pop();
+			}
+
+			run(request);
+			delete request;
+		}
+	}
+
+	void AsyncIO::Worker::run(Request * request)
+	{
+		Variant * result = 0;
+		bool success = false;
+
+		File * file = new File(request->filename);
+		try
+		{
+			if (request->type == Request::READ)
+			{
+				if (file->open(File::READ))
+				{
+					Data * data = file->read();
+					result = new Variant((const char *) data->getData(), data->getSize());
+					data->release();
+					success = true;
+				}
+				else
+					result = new Variant("Could not open file.", 20);
+			}
+			else
+			{
+				if (!file->open(File::WRITE))
+					result = new Variant("Could not open file.", 20);
+				else if (!file->write(request->data.data(), request->data.size()))
+					result = new Variant("Data could not be written.", 26);
+				else
+					success = file->close();
+			}
+		}
+		catch (love::Exception & e)
+		{
+			result = new Variant(e.what(), strlen(e.what()));
+		}
+		file->release();
+
+		complete(request->id, success, result);
+		if (result)
+			result->release();
+	}
+
+	void AsyncIO::Worker::complete(int id, bool success, Variant * result)
+	{
+		while (true)
+		{
+			// A failed push clears the message, so it is built again
+			// for every attempt.
+			love::event::Message msg;
+			msg.init(name);
+			msg.addNumber(id);
+			msg.addBoolean(success);
+			if (result)
+				msg.addVariant(result);
+
+			if (target->push(msg))
+				return;
+
+			// The queue is full. Wait for the game to poll it, unless
+			// we are shutting down and nobody will.
+			thread::Lock lock(mutex);
+			if (stopping)
+				return;
+			cond.wait(&mutex, 10);
+		}
+	}
+
+} // physfs
+} // filesystem
+} // love
@@ -0,0 +1,141 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+
+#ifndef LOVE_FILESYSTEM_PHYSFS_ASYNC_IO_H
+#define LOVE_FILESYSTEM_PHYSFS_ASYNC_IO_H
+
+// STD
+#include <queue>
+#include <string>
+#include <vector>
+
+// LOVE
+#include <common/Object.h>
+#include <event/Event.h>
+#include <thread/threads.h>
+
+// Number of I/O threads started by the first asynchronous request.
+#define LOVE_ASYNC_IO_WORKERS 2
+
+// Name of the love.event message which completes a request.
+#define LOVE_ASYNC_IO_EVENT "filesystemasync"
+
+namespace love
+{
+namespace filesystem
+{
+namespace physfs
+{
+	/**
+	* Runs file reads and writes on a small pool of I/O threads.
+	* Every request opens its own File, and all requests on the same
+	* path go to the same thread, so they complete in the order they
+	* were made. Completions are pushed to love.event as a
+	* LOVE_ASYNC_IO_EVENT message with the arguments:
+	* id, success, contents (reads) or error message (failures).
+	* A completion waits for room when the event queue is full, and
+	* queued writes still run when the AsyncIO is destroyed.
+	**/
+	class AsyncIO
+	{
+	public:
+
+		/**
+		* @param target The event module to deliver completions to.
+		* @param workers The number of I/O threads.
+		**/
+		AsyncIO(love::event::Event * target, int workers = LOVE_ASYNC_IO_WORKERS);
+		~AsyncIO();
+
+		/**
+		* Queues a read of a whole file.
+		* @param filename The file to read.
+		* @return The id of the request.
+		**/
+		int read(const std::string & filename);
+
+		/**
+		* Queues a write of a whole file. The data is copied.
+		* @param filename The file to write.
+		* @param data The bytes to write.
+		* @param size The number of bytes to write.
+		* @return The id of the request.
+		**/
+		int write(const std::string & filename, const void * data, size_t size);
+
+	private:
+
+		struct Request
+		{
+			enum Type
+			{
+				READ,
+				WRITE,
+			};
+
+			Type type;
+			int id;
+			std::string filename;
+			std::string data;
+		};
+
+		class Worker : public thread::ThreadBase
+		{
+		public:
+
+			Worker(love::event::Event * target, int name);
+			~Worker();
+
+			void push(Request * request);
+			void stop();
+
+		protected:
+
+			void main();
+
+		private:
+
+			void run(Request * request);
+			void complete(int id, bool success, Variant * result);
+
+			love::event::Event * target;
+			int name;
+
+			thread::Mutex mutex;
+			thread::Conditional cond;
+			std::queue<Request *> requests;
+			bool stopping;
+
+		}; // Worker
+
+		int push(Request * request);
+
+		love::event::Event * target;
+		std::vector<Worker *> workers;
+		int next_id;
+
+	}; // AsyncIO
+
+} // physfs
+} // filesystem
+} // love
+
+#endif // LOVE_FILESYSTEM_PHYSFS_ASYNC_IO_H
@@ -21,9 +21,11 @@
 #include "File.h"
 
 // STD
+#include <algorithm>
 #include <cstring>
 
 // LOVE
+#include "Archive.h"
 #include "Filesystem.h"
 #include <filesystem/FileData.h>
 
@@ -37,9 +39,15 @@ namespace filesystem
 namespace physfs
 {
 	extern bool hack_setupWriteDirectory();
+	extern void hack_invalidateSaveCache();
+
+	// The most read or written by a single PhysFS call, which takes
+	// 32-bit counts. Larger transfers are split into chunks this size.
+	static const int64 CHUNK_SIZE = 0x10000000; // 256 MB
 
 	File::File(std::string filename)
-		: filename(filename), file(0), mode(filesystem::File::CLOSED)
+		: filename(filename), file(0), data(0), position(0), archive(0), archiveSize(0), mode(filesystem::File::CLOSED)
+		, bufferMode(BUFFER_NONE), bufferSize(0)
 	{
 	}
 
@@ -54,18 +62,47 @@ namespace physfs
 		if (mode == CLOSED)
 			return true;
 
-		// File must exist if read mode.
+		// Files missing from the PhysFS search path may be in a mounted archive.
+		Archive * archive = 0;
 		if ((mode == READ) && !PHYSFS_exists(filename.c_str()))
-			throw love::Exception("Could not open file %s. Does not exist.", filename.c_str());
+		{
+			archive = Archive::find(filename.c_str());
+
+			// File must exist if read mode.
+			if (archive == 0)
+				throw love::Exception("Could not open file %s. Does not exist.", filename.c_str());
+		}
 
 		// Check whether the write directory is set.
 		if ((mode == APPEND || mode == WRITE) && (PHYSFS_getWriteDir() == 0) && !hack_setupWriteDirectory())
 			throw love::Exception("Could not set write directory.");
 
 		// File already open?
-		if (file != 0)
+		if (file != 0 || data != 0 || this->archive != 0)
 			return false;
 
+		if (archive != 0 && archive->hasRangeReads())
+		{
+			archiveSize = archive->getSize(Archive::normalize(filename.c_str()));
+			if (archiveSize < 0)
+				return false;
+			archive->retain();
+			this->archive = archive;
+			position = 0;
+			this->mode = mode;
+			return true;
+		}
+
+		if (archive != 0)
+		{
+			data = archive->read(Archive::normalize(filename.c_str()));
+			if (data == 0)
+				return false;
+			position = 0;
+			this->mode = mode;
+			return true;
+		}
+
 		this->mode = mode;
 
 		switch(mode)
@@ -75,19 +112,44 @@ namespace physfs
 			break;
 		case APPEND:
 			file = PHYSFS_openAppend(filename.c_str());
+			hack_invalidateSaveCache();
 			break;
 		case WRITE:
 			file = PHYSFS_openWrite(filename.c_str());
+			hack_invalidateSaveCache();
 			break;
 		default:
 			break;
 		}
 
+		if (file != 0 && bufferMode != BUFFER_NONE && !PHYSFS_setBuffer(file, (PHYSFS_uint64) bufferSize))
+		{
+			// Keep the file usable unbuffered.
+			bufferMode = BUFFER_NONE;
+			bufferSize = 0;
+		}
+
 		return (file != 0);
 	}
 
 	bool File::close()
 	{
+		if (data != 0)
+		{
+			data->release();
+			data = 0;
+			mode = CLOSED;
+			return true;
+		}
+
+		if (archive != 0)
+		{
+			archive->release();
+			archive = 0;
+			mode = CLOSED;
+			return true;
+		}
+
 		// HACK(binji)
 		if (mode == APPEND || mode == WRITE) {
 			using namespace love::window::ppapi;
@@ -104,6 +166,19 @@ namespace physfs
 
 	int64 File::getSize()
 	{
+		if (data != 0)
+			return data->getSize();
+		if (archive != 0)
+			return archiveSize;
+
+		// Archive files know their size without being read.
+		if (file == 0 && !PHYSFS_exists(filename.c_str()))
+		{
+			Archive * archive = Archive::find(filename.c_str());
+			if (archive != 0)
+				return archive->getSize(Archive::normalize(filename.c_str()));
+		}
+
 		// If the file is closed, open it to
 		// check the size.
 		if (file == 0)
@@ -120,15 +195,44 @@ namespace physfs
 
 	Data * File::read(int64 size)
 	{
-		bool isOpen = (file != 0);
+		bool isOpen = (file != 0 || data != 0 || archive != 0);
 
 		if (!isOpen && !open(READ))
 			throw love::Exception("Could not read file %s.", filename.c_str());
 
-		int64 max = (int64)PHYSFS_fileLength(file);
+		int64 max = getSize();
 		size = (size == ALL) ? max : size;
 		size = (size > max) ? max : size;
 
+		// Files of mounted archives are already in memory; only
+		// deflated entries were copied, when they were inflated.
+		if (data != 0)
+		{
+			size = std::min(size, (int64) data->getSize() - position);
+
+			FileData * view = new FileData((char *) data->getData() + position, size, getFilename(), data);
+			position += size;
+
+			if (!isOpen)
+				close();
+
+			return view;
+		}
+
+		if (archive != 0)
+		{
+			Data * part = archive->read(Archive::normalize(filename.c_str()), position, size);
+			if (part != 0)
+				position += part->getSize();
+
+			if (!isOpen)
+				close();
+
+			if (part == 0)
+				throw love::Exception("Could not read file %s.", filename.c_str());
+			return part;
+		}
+
 		FileData * fileData = new FileData(size, getFilename());
 
 		read(fileData->getData(), size);
@@ -141,18 +245,68 @@ namespace physfs
 
 	int64 File::read(void * dst, int64 size)
 	{
-		bool isOpen = (file != 0);
+		bool isOpen = (file != 0 || data != 0 || archive != 0);
 
 		if (!isOpen)
 			open(READ);
 
+		if (data != 0)
+		{
+			int64 max = data->getSize() - position;
+			size = (size == ALL || size > max) ? max : size;
+			memcpy(dst, (const char *) data->getData() + position, (size_t) size);
+			position += size;
+
+			if (!isOpen)
+				close();
+
+			return size;
+		}
+
+		if (archive != 0)
+		{
+			int64 max = archiveSize - position;
+			size = (size == ALL || size > max) ? max : size;
+
+			int64 read = -1;
+			Data * part = archive->read(Archive::normalize(filename.c_str()), position, size);
+			if (part != 0)
+			{
+				read = part->getSize();
+				memcpy(dst, part->getData(), (size_t) read);
+				position += read;
+				part->release();
+			}
+
+			if (!isOpen)
+				close();
+
+			return read;
+		}
+
 		int64 max = (int64)PHYSFS_fileLength(file);
 		size = (size == ALL) ? max : size;
 		size = (size > max) ? max : size;
-		// Sadly, we'll have to clamp to 32 bits here
-		size = (size > LOVE_UINT32_MAX) ? LOVE_UINT32_MAX : size;
 
-		int64 read = (int64)PHYSFS_read(file, dst, 1, (int) size);
+		int64 read = 0;
+		while (read < size)
+		{
+			int64 chunk = std::min(size - read, CHUNK_SIZE);
+			PHYSFS_sint64 count = PHYSFS_read(file, (char *) dst + read, 1, (PHYSFS_uint32) chunk);
+
+			if (count < 0)
+			{
+				if (read == 0)
+					read = -1;
+				break;
+			}
+
+			read += count;
+
+			// End of file.
+			if (count < chunk)
+				break;
+		}
 
 		if (!isOpen)
 			close();
@@ -165,15 +319,22 @@ namespace physfs
 		if (file == 0)
 			throw love::Exception("Could not write to file. File not open.");
 
-		// Another clamp, for the time being.
-		size = (size > LOVE_UINT32_MAX) ? LOVE_UINT32_MAX : size;
+		// Try to write, in chunks PhysFS can count.
+		int64 written = 0;
+		while (written < size)
+		{
+			int64 chunk = std::min(size - written, CHUNK_SIZE);
+			PHYSFS_sint64 count = PHYSFS_write(file, (const char *) data + written, 1, (PHYSFS_uint32) chunk);
 
-		// Try to write.
-		int64 written = static_cast<int64>(PHYSFS_write(file, data, 1, (int) size));
+			// Check that correct amount of data was written.
+			if (count != chunk)
+				return false;
 
-		// Check that correct amount of data was written.
-		if (written != size)
-			return false;
+			written += count;
+		}
+
+		if (bufferMode == BUFFER_LINE && memchr(data, '\n', (size_t) size) != 0)
+			return flush();
 
 		return true;
 	}
@@ -202,6 +363,11 @@ namespace physfs
 
 	bool File::eof()
 	{
+		if (data != 0)
+			return position >= data->getSize();
+		if (archive != 0)
+			return position >= archiveSize;
+
 		if (file == 0 || test_eof(this, file))
 			return true;
 		return false;
@@ -209,6 +375,9 @@ namespace physfs
 
 	int64 File::tell()
 	{
+		if (data != 0 || archive != 0)
+			return position;
+
 		if (file == 0)
 			return -1;
 
@@ -217,6 +386,22 @@ namespace physfs
 
 	bool File::seek(uint64 pos)
 	{
+		if (data != 0)
+		{
+			if (pos > (uint64) data->getSize())
+				return false;
+			position = (int64) pos;
+			return true;
+		}
+
+		if (archive != 0)
+		{
+			if (pos > (uint64) archiveSize)
+				return false;
+			position = (int64) pos;
+			return true;
+		}
+
 		if (file == 0)
 			return false;
 
@@ -225,6 +410,38 @@ namespace physfs
 		return true;
 	}
 
+	bool File::setBuffer(BufferMode mode, int64 size)
+	{
+		if (size < 0)
+			return false;
+
+		if (mode == BUFFER_NONE)
+			size = 0;
+		else if (size == 0)
+			return false;
+
+		if (file != 0 && !PHYSFS_setBuffer(file, (PHYSFS_uint64) size))
+			return false;
+
+		bufferMode = mode;
+		bufferSize = size;
+		return true;
+	}
+
+	filesystem::File::BufferMode File::getBuffer(int64 & size) const
+	{
+		size = bufferSize;
+		return bufferMode;
+	}
+
+	bool File::flush()
+	{
+		if (file == 0 || (mode != WRITE && mode != APPEND))
+			return false;
+
+		return PHYSFS_flush(file) != 0;
+	}
+
 	std::string File::getFilename() const
 	{
 		return filename;
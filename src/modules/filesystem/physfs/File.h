@@ -40,6 +40,8 @@ namespace filesystem
 {
 namespace physfs
 {
+	class Archive;
+
 	class File : public love::filesystem::File
 	{
 	private:
@@ -50,9 +52,23 @@ namespace physfs
 		// PHYSFS File handle.
 		PHYSFS_file * file;
 
+		// Contents and read position of a file opened from
+		// a mounted Archive rather than through PhysFS.
+		Data * data;
+		int64 position;
+
+		// Set instead of data when the Archive reads parts of files
+		// cheaply; reads then fetch only the bytes asked for.
+		Archive * archive;
+		int64 archiveSize;
+
 		// The current mode of the file.
 		Mode mode;
 
+		// Buffering, applied whenever the file is opened.
+		BufferMode bufferMode;
+		int64 bufferSize;
+
 	public:
 
 		/**
@@ -75,6 +91,9 @@ namespace physfs
 		bool eof();
 		int64 tell();
 		bool seek(uint64 pos);
+		bool setBuffer(BufferMode mode, int64 size);
+		BufferMode getBuffer(int64 & size) const;
+		bool flush();
 		Mode getMode();
 		std::string getFilename() const;
 		std::string getExtension() const;
@@ -20,12 +20,23 @@
 
 #include <common/config.h>
 
+#include <cstdio>
 #include <iostream>
+#include <set>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifndef LOVE_WINDOWS
+#	include <dirent.h>
+#endif
 
 #include <common/utf8.h>
 #include <common/b64.h>
 
+#include "AsyncIO.h"
 #include "Filesystem.h"
+#include "PackArchive.h"
+#include "ZipArchive.h"
 
 // HACK(binji)
 #include "window/ppapi/FilesystemHack.h"
@@ -37,12 +48,16 @@ namespace filesystem
 namespace physfs
 {
 	Filesystem::Filesystem()
-		: open_count(0), buffer(0), isInited(false), release(false), releaseSet(false)
+		: open_count(0), buffer(0), isInited(false), release(false), releaseSet(false), chunkCache(false), sourceIndex(0), async(0)
 	{
 	}
 
 	Filesystem::~Filesystem()
 	{
+		// Finish the I/O threads before PhysFS goes away.
+		delete async;
+		delete sourceIndex;
+
 		if (isInited)
 		{
 			isInited = false;
@@ -103,6 +118,7 @@ namespace physfs
 		// Try to add the save directory to the search path.
 		// (No error on fail, it means that the path doesn't exist).
 		PHYSFS_addToSearchPath(save_path_full.c_str(), 0);
+		invalidateSaveCache();
 
 		return true;
 	}
@@ -116,8 +132,64 @@ namespace physfs
 		if (!game_source.empty())
 			return false;
 
+		// Sources already in memory (such as a downloaded .love)
+		// are mounted directly, without a round trip through a file.
+		ArchiveIO * io = Archive::getSource(source);
+		if (io == 0)
+		{
+			// Pack files are ours to read; PhysFS knows nothing of them.
+			struct stat buf;
+			if (stat(source, &buf) == 0 && S_ISREG(buf.st_mode))
+			{
+				try
+				{
+					io = new FileIO(source);
+				}
+				catch (love::Exception &)
+				{
+				}
+				if (io != 0 && !PackArchive::isPack(io))
+				{
+					io->release();
+					io = 0;
+				}
+			}
+		}
+
+		if (io != 0)
+		{
+			Archive * archive = 0;
+			try
+			{
+				if (PackArchive::isPack(io))
+					archive = new PackArchive(io);
+				else
+				{
+					ZipArchive * zip = new ZipArchive(io);
+					zip->prefetchManifest();
+					archive = zip;
+				}
+			}
+			catch (love::Exception &)
+			{
+			}
+			io->release();
+
+			if (archive == 0)
+				return false;
+
+			Archive::mount(archive);
+			sourceIndex = new SourceIndex();
+			sourceIndex->buildArchive(archive);
+			archive->release();
+		}
 		// Add the directory.
-		if (!PHYSFS_addToSearchPath(source, 1))
+		else if (PHYSFS_addToSearchPath(source, 1))
+		{
+			sourceIndex = new SourceIndex();
+			sourceIndex->buildPhysFS(source);
+		}
+		else
 			return false;
 
 		// Save the game source.
@@ -163,10 +235,18 @@ namespace physfs
 			PHYSFS_setWriteDir(0); // Clear the write directory in case of error.
 			return false;
 		}
+		invalidateSaveCache();
 
 		return true;
 	}
 
+	void Filesystem::invalidateSaveCache()
+	{
+		thread::Lock lock(saveMutex);
+		saveTypes.clear();
+		saveLists.clear();
+	}
+
 	File * Filesystem::newFile(const char *filename)
 	{
 		return new File(filename);
@@ -265,17 +345,124 @@ namespace physfs
 		return save_path_full.c_str();
 	}
 
+	/**
+	* Whether a path can be looked up in the source index and the
+	* save directory, rather than through PhysFS. PhysFS rejects
+	* paths which could leave the search path; those are left to it.
+	**/
+	static bool isIndexable(const std::string & path)
+	{
+		if (path.find_first_of("\\:") != std::string::npos)
+			return false;
+
+		size_t start = 0;
+		while (start <= path.size())
+		{
+			size_t end = path.find('/', start);
+			if (end == std::string::npos)
+				end = path.size();
+			std::string part = path.substr(start, end - start);
+			if (part == "." || part == "..")
+				return false;
+			start = end + 1;
+		}
+		return true;
+	}
+
+	Filesystem::SaveType Filesystem::getSaveType(const std::string & path)
+	{
+		if (save_path_full.empty())
+			return SAVE_NONE;
+
+		thread::Lock lock(saveMutex);
+		std::map<std::string, int>::iterator it = saveTypes.find(path);
+		if (it != saveTypes.end())
+			return (SaveType) it->second;
+
+		SaveType type = SAVE_NONE;
+		struct stat buf;
+		if (stat((save_path_full + LOVE_PATH_SEPARATOR + path).c_str(), &buf) == 0)
+			type = S_ISDIR(buf.st_mode) ? SAVE_DIRECTORY : SAVE_FILE;
+
+		saveTypes[path] = type;
+		return type;
+	}
+
+	void Filesystem::getSaveList(const std::string & dir, std::vector<std::string> & files)
+	{
+		if (getSaveType(dir) != SAVE_DIRECTORY)
+			return;
+
+		thread::Lock lock(saveMutex);
+		std::map<std::string, std::vector<std::string> >::iterator it = saveLists.find(dir);
+		if (it == saveLists.end())
+		{
+			std::vector<std::string> & list = saveLists[dir];
+#ifdef LOVE_WINDOWS
+			// Entries PhysFS finds in the save directory.
+			char ** rc = PHYSFS_enumerateFiles(dir.c_str());
+			for (char ** i = rc; *i != 0; i++)
+			{
+				std::string path = dir.empty() ? std::string(*i) : dir + "/" + *i;
+				const char * realdir = PHYSFS_getRealDir(path.c_str());
+				if (realdir != 0 && save_path_full == realdir)
+					list.push_back(*i);
+			}
+			PHYSFS_freeList(rc);
+#else
+			DIR * d = opendir((save_path_full + LOVE_PATH_SEPARATOR + dir).c_str());
+			if (d != 0)
+			{
+				struct dirent * entry;
+				while ((entry = readdir(d)) != 0)
+				{
+					if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0)
+						list.push_back(entry->d_name);
+				}
+				closedir(d);
+			}
+#endif
+			it = saveLists.find(dir);
+		}
+
+		files.insert(files.end(), it->second.begin(), it->second.end());
+	}
+
 	bool Filesystem::exists(const char * file)
 	{
+		std::string path = Archive::normalize(file);
+		if (sourceIndex && isIndexable(path))
+			return sourceIndex->exists(path) || getSaveType(path) != SAVE_NONE;
+
 		if (PHYSFS_exists(file))
 			return true;
+		if (Archive::find(file))
+			return true;
 		return false;
 	}
 
 	bool Filesystem::isDirectory(const char * file)
 	{
+		std::string path = Archive::normalize(file);
+		if (sourceIndex && isIndexable(path))
+		{
+			// The save directory comes first in the search path.
+			SaveType type = getSaveType(path);
+			if (type != SAVE_NONE)
+				return type == SAVE_DIRECTORY;
+			return sourceIndex->isDirectory(path);
+		}
+
 		if (PHYSFS_isDirectory(file))
 			return true;
+
+		// PhysFS files shadow archive directories of the same name.
+		if (PHYSFS_exists(file))
+			return false;
+
+		Archive * archive = Archive::find(file);
+		if (archive && archive->isDirectory(path))
+			return true;
 		return false;
 	}
 
@@ -291,6 +478,7 @@ namespace physfs
 
 		if (!PHYSFS_mkdir(file))
 			return false;
+		invalidateSaveCache();
                 // HACK(binji)
 		using namespace love::window::ppapi;
 		if (!MakeDirectory(PHYSFS_getWriteDir(), file))
@@ -305,6 +493,7 @@ namespace physfs
 
 		if (!PHYSFS_delete(file))
 			return false;
+		invalidateSaveCache();
                 // HACK(binji)
 		using namespace love::window::ppapi;
 		if (!RemoveFile(PHYSFS_getWriteDir(), file))
@@ -439,6 +628,30 @@ namespace physfs
 			return luaL_error(L, "Function requires parameter of type string.");
 
 		const char * dir = lua_tostring(L, 1);
+
+		std::string path = Archive::normalize(dir);
+		if (sourceIndex && isIndexable(path))
+		{
+			// Sorted, like the PhysFS list.
+			std::set<std::string> names;
+			const std::vector<std::string> * files = sourceIndex->enumerate(path);
+			if (files != 0)
+				names.insert(files->begin(), files->end());
+
+			std::vector<std::string> saved;
+			getSaveList(path, saved);
+			names.insert(saved.begin(), saved.end());
+
+			lua_createtable(L, names.size(), 0);
+			int index = 1;
+			for (std::set<std::string>::const_iterator it = names.begin(); it != names.end(); ++it)
+			{
+				luax_pushstring(L, *it);
+				lua_rawseti(L, -2, index++);
+			}
+			return 1;
+		}
+
 		char **rc = PHYSFS_enumerateFiles(dir);
 		char **i;
 		int index = 1;
@@ -453,97 +666,155 @@ namespace physfs
 			index++;
 		}
 
+		// Add the entries of mounted archives not already listed.
+		std::vector<Archive *> archives = Archive::getMounted();
+		if (!archives.empty())
+		{
+			std::set<std::string> seen(rc, i);
+			std::vector<std::string> files;
+
+			for (size_t j = 0; j < archives.size(); j++)
+				archives[j]->enumerate(path, files);
+
+			for (size_t j = 0; j < files.size(); j++)
+			{
+				if (!seen.insert(files[j]).second)
+					continue;
+
+				lua_pushinteger(L, index);
+				luax_pushstring(L, files[j]);
+				lua_settable(L, -3);
+				index++;
+			}
+		}
+
 		PHYSFS_freeList(rc);
 
 		return 1;
 	}
 
-	int Filesystem::lines_i(lua_State * L)
+	/**
+	* Per-iterator state of love.filesystem.lines and File:lines. Lives
+	* in a Lua userdata upvalue, so it is collected with the iterator.
+	**/
+	struct LinesBuffer
+	{
+		// File offset of the byte following the buffered data.
+		int64 offset;
+
+		// Unconsumed data is in [start, end).
+		int start;
+		int end;
+
+		// True once the file has no more data.
+		bool eof;
+
+		char data[LOVE_FILESYSTEM_LINES_BUFFER_SIZE];
+	};
+
+	void Filesystem::pushLinesBuffer(lua_State * L)
 	{
-		const int bufsize = 1024;
-		char buf[bufsize];
-		int linesize = 0;
-		bool newline = false;
+		LinesBuffer * lb = (LinesBuffer *) lua_newuserdata(L, sizeof(LinesBuffer));
+		lb->offset = 0;
+		lb->start = 0;
+		lb->end = 0;
+		lb->eof = false;
+	}
 
+	int Filesystem::lines_i(lua_State * L)
+	{
 		File * file = luax_checktype<File>(L, lua_upvalueindex(1), "File", FILESYSTEM_FILE_T);
+		LinesBuffer * lb = (LinesBuffer *) lua_touserdata(L, lua_upvalueindex(4));
 
 		// Only accept read mode at this point.
 		if (file->getMode() != File::READ)
 			return luaL_error(L, "File needs to stay in read mode.");
 
-		int64 pos = file->tell();
+		// File:lines must leave the file position as the user left it.
 		int64 userpos = -1;
-
 		if (lua_isnoneornil(L, lua_upvalueindex(2)) == 0)
-		{
-			// User may have changed the file position.
-			userpos = pos;
-			pos = (int64) lua_tonumber(L, lua_upvalueindex(2));
-			if (userpos != pos)
-				file->seek(pos);
-		}
+			userpos = file->tell();
 
-		while (!newline && !file->eof())
-		{
-			// This 64-bit to 32-bit integer cast should be safe as it never exceeds bufsize.
-			int read = (int) file->read(buf, bufsize);
-			if (read < 0)
-				return luaL_error(L, "Could not read from file.");
+		bool error = false;
+		bool found = false;
 
-			linesize += read;
+		{
+			// Only used for lines longer than the buffer.
+			std::string overflow;
 
-			for (int i = 0; i < read; i++)
+			while (true)
 			{
-				if (buf[i] == '\n')
+				char * first = lb->data + lb->start;
+				char * nl = (char *) memchr(first, '\n', lb->end - lb->start);
+
+				if (nl != 0 || (lb->eof && (lb->end > lb->start || !overflow.empty())))
 				{
-					linesize -= read - i;
-					newline = true;
+					char * last = (nl != 0) ? nl : lb->data + lb->end;
+					lb->start = (nl != 0) ? (int) (nl - lb->data) + 1 : lb->end;
+
+					// Common case: the whole line is in the buffer.
+					if (!overflow.empty())
+					{
+						overflow.append(first, last - first);
+						first = &overflow[0];
+						last = first + overflow.size();
+					}
+
+					if (last > first && last[-1] == '\r')
+						last--;
+
+					lua_pushlstring(L, first, last - first);
+					found = true;
 					break;
 				}
-			}
-		}
 
-		if (newline || (file->eof() && linesize > 0))
-		{
-			if (linesize < bufsize)
-			{
-				// We have the line in the buffer on the stack. No 'new' and 'read' needed.
-				lua_pushlstring(L, buf, linesize > 0 && buf[linesize - 1] == '\r' ? linesize - 1 : linesize);
-				if (userpos < 0)
-					file->seek(pos + linesize + 1);
-			}
-			else
-			{
-				char * str;
-				try
+				if (lb->eof)
+					break;
+
+				// Keep the partial line, and make room behind it.
+				if (lb->start > 0)
 				{
-					str = new char[linesize + 1];
+					memmove(lb->data, lb->data + lb->start, lb->end - lb->start);
+					lb->end -= lb->start;
+					lb->start = 0;
 				}
-				catch (std::bad_alloc &)
+				else if (lb->end == LOVE_FILESYSTEM_LINES_BUFFER_SIZE)
 				{
-					return luaL_error(L, "Out of memory");
+					overflow.append(lb->data, lb->end);
+					lb->end = 0;
 				}
-				file->seek(pos);
 
-				// Read the \n anyway and save us a call to seek.
-				if (file->read(str, linesize + 1) == -1)
+				if (userpos >= 0 && file->tell() != lb->offset)
+					file->seek(lb->offset);
+
+				int64 want = LOVE_FILESYSTEM_LINES_BUFFER_SIZE - lb->end;
+				int64 read = file->read(lb->data + lb->end, want);
+				if (read < 0)
 				{
-					delete [] str;
-					return luaL_error(L, "Could not read from file.");
+					error = true;
+					break;
 				}
 
-				lua_pushlstring(L, str, str[linesize - 1] == '\r' ? linesize - 1 : linesize);
-				delete [] str;
+				lb->end += (int) read;
+				lb->offset += read;
+				if (read < want && file->eof())
+					lb->eof = true;
 			}
+		}
 
+		if (error)
+		{
 			if (userpos >= 0)
-			{
-				// Save new position in upvalue.
-				lua_pushnumber(L, (lua_Number) (pos + linesize + 1));
-				lua_replace(L, lua_upvalueindex(2));
 				file->seek(userpos);
-			}
+			return luaL_error(L, "Could not read from file.");
+		}
 
+		if (found)
+		{
+			// Refilling the buffer moves the file, even when it started
+			// where the buffer ends.
+			if (userpos >= 0 && file->tell() != userpos)
+				file->seek(userpos);
 			return 1;
 		}
 
@@ -554,7 +825,109 @@ namespace physfs
 			file->close();
 
 		return 0;
- 	}
+	}
+
+	static int chunk_writer(lua_State *, const void * p, size_t size, void * ud)
+	{
+		((std::string *) ud)->append((const char *) p, size);
+		return 0;
+	}
+
+	void Filesystem::setChunkCache(bool enable)
+	{
+		chunkCache = enable;
+	}
+
+	bool Filesystem::hasChunkCache() const
+	{
+		return chunkCache;
+	}
+
+	std::string Filesystem::getChunkCachePath(const std::string & filename) const
+	{
+		// FNV-1a. Collisions are caught by the path in the header.
+		uint32 hash = 2166136261u;
+		for (size_t i = 0; i < filename.size(); i++)
+			hash = (hash ^ (unsigned char) filename[i]) * 16777619u;
+
+		char name[16];
+		sprintf(name, "%08x.luac", hash);
+		return std::string(LOVE_CHUNK_CACHE_DIR "/") + name;
+	}
+
+	std::string Filesystem::getChunkCacheHeader(const std::string & filename, int64 size, int64 modtime) const
+	{
+		std::string header(LOVE_CHUNK_CACHE_MAGIC);
+		header.append((const char *) &size, sizeof(size));
+		header.append((const char *) &modtime, sizeof(modtime));
+		header.append(filename);
+		header.push_back('\0');
+		return header;
+	}
+
+	bool Filesystem::loadCachedChunk(lua_State * L, const std::string & filename, int64 size, int64 modtime)
+	{
+		std::string path = getChunkCachePath(filename);
+		if (!PHYSFS_exists(path.c_str()))
+			return false;
+
+		std::string header = getChunkCacheHeader(filename, size, modtime);
+		File * file = newFile(path.c_str());
+		Data * data = 0;
+
+		try
+		{
+			data = file->read();
+		}
+		catch (love::Exception &)
+		{
+		}
+		file->release();
+
+		if (data == 0)
+			return false;
+
+		const char * bytes = (const char *) data->getData();
+		size_t length = data->getSize();
+		int status = -1;
+
+		// Stale entries (the source was changed) are just ignored.
+		if (length > header.size() && memcmp(bytes, header.data(), header.size()) == 0)
+			status = luaL_loadbuffer(L, bytes + header.size(), length - header.size(), ("@" + filename).c_str());
+
+		data->release();
+
+		// Bytecode of another Lua build is rejected by the loader.
+		if (status > 0)
+			lua_pop(L, 1);
+
+		return status == 0;
+	}
+
+	void Filesystem::saveCachedChunk(lua_State * L, const std::string & filename, int64 size, int64 modtime)
+	{
+		std::string chunk = getChunkCacheHeader(filename, size, modtime);
+		if (lua_dump(L, chunk_writer, &chunk) != 0)
+			return;
+
+		if (!isDirectory(LOVE_CHUNK_CACHE_DIR) && !mkdir(LOVE_CHUNK_CACHE_DIR))
+			return;
+
+		File * file = newFile(getChunkCachePath(filename).c_str());
+		try
+		{
+			if (file->open(File::WRITE))
+			{
+				file->write(chunk.data(), chunk.size());
+				file->close();
+			}
+		}
+		catch (love::Exception &)
+		{
+			// The cache is only an optimization.
+		}
+		file->release();
+	}
 
 	int Filesystem::load(lua_State * L)
 	{
@@ -574,12 +947,32 @@ namespace physfs
 		// Create the file.
 		File * file = newFile(filename.c_str());
 
-		// Get the data from the file.
-		Data * data = file->read();
+		// Try the compiled chunk cache first; the source
+		// is not read at all when that succeeds.
+		int64 size = 0;
+		int64 modtime = -1;
+		bool cached = false;
+		if (chunkCache)
+		{
+			size = file->getSize();
+			modtime = getModTime(filename.c_str());
+			cached = loadCachedChunk(L, filename, size, modtime);
+		}
+
+		int status = 0;
+		if (!cached)
+		{
+			// Get the data from the file.
+			Data * data = file->read();
 
-		int status = luaL_loadbuffer(L, (const char *)data->getData(), data->getSize(), ("@" + filename).c_str());
+			status = luaL_loadbuffer(L, (const char *)data->getData(), data->getSize(), ("@" + filename).c_str());
+
+			data->release();
+
+			if (status == 0 && chunkCache && modtime != -1)
+				saveCachedChunk(L, filename, size, modtime);
+		}
 
-		data->release();
 		file->release();
 
 		// Load the chunk, but don't run it.
@@ -594,10 +987,22 @@ namespace physfs
 		}
 	}
 
+	int64 Filesystem::getModTime(const char * filename)
+	{
+		PHYSFS_sint64 time = PHYSFS_getLastModTime(filename);
+		if (time == -1 && !PHYSFS_exists(filename))
+		{
+			Archive * archive = Archive::find(filename);
+			if (archive)
+				time = archive->getLastModified(Archive::normalize(filename));
+		}
+		return (int64) time;
+	}
+
 	int Filesystem::getLastModified(lua_State * L)
 	{
 		const char * filename = luaL_checkstring(L, 1);
-		PHYSFS_sint64 time = PHYSFS_getLastModTime(filename);
+		int64 time = getModTime(filename);
 		if (time == -1)
 		{
 			lua_pushnil(L);
@@ -608,6 +1013,23 @@ namespace physfs
 		return 1;
 	}
 
+	AsyncIO * Filesystem::getAsyncIO(love::event::Event * target)
+	{
+		if (!async)
+			async = new AsyncIO(target);
+		return async;
+	}
+
+	int Filesystem::readAsync(const char * filename, love::event::Event * target)
+	{
+		return getAsyncIO(target)->read(filename);
+	}
+
+	int Filesystem::writeAsync(const char * filename, const void * data, size_t size, love::event::Event * target)
+	{
+		return getAsyncIO(target)->write(filename, data, size);
+	}
+
 } // physfs
 } // filesystem
 } // love
@@ -25,14 +25,26 @@
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <map>
 #include <string>
+#include <vector>
 
 // LOVE
 #include <common/Module.h>
 #include <common/config.h>
 #include <common/int.h>
 #include <filesystem/FileData.h>
+#include <thread/threads.h>
 #include "File.h"
+#include "SourceIndex.h"
+
+namespace love
+{
+namespace event
+{
+	class Event;
+} // event
+} // love
 
 // For great CWD. (Current Working Directory)
 // Using this instead of boost::filesystem which totally
@@ -66,12 +78,22 @@
 #	define LOVE_MAX_PATH MAXPATHLEN
 #endif
 
+// Size of the read buffer owned by each lines iterator.
+#define LOVE_FILESYSTEM_LINES_BUFFER_SIZE 65536
+
+// Save directory folder of the compiled chunk cache, and the
+// magic at the start of each cached chunk.
+#define LOVE_CHUNK_CACHE_DIR ".chunkcache"
+#define LOVE_CHUNK_CACHE_MAGIC "LOVEC1"
+
 namespace love
 {
 namespace filesystem
 {
 namespace physfs
 {
+	class AsyncIO;
+
 	class Filesystem : public Module
 	{
 	private:
@@ -108,6 +130,51 @@ namespace physfs
 		bool release;
 		bool releaseSet;
 
+		// Whether load keeps compiled chunks in the save directory.
+		bool chunkCache;
+
+		std::string getChunkCachePath(const std::string & filename) const;
+		std::string getChunkCacheHeader(const std::string & filename, int64 size, int64 modtime) const;
+
+		/**
+		* Pushes the cached chunk of a file, if the cache has one
+		* for this size and modification time of the file.
+		* @return True if the chunk was pushed.
+		**/
+		bool loadCachedChunk(lua_State * L, const std::string & filename, int64 size, int64 modtime);
+
+		/**
+		* Stores the function at the top of the stack in the cache.
+		**/
+		void saveCachedChunk(lua_State * L, const std::string & filename, int64 size, int64 modtime);
+
+		int64 getModTime(const char * filename);
+
+		// Listing of the game source, built by setSource. Null if
+		// there is no source.
+		SourceIndex * sourceIndex;
+
+		enum SaveType
+		{
+			SAVE_NONE,
+			SAVE_FILE,
+			SAVE_DIRECTORY,
+		};
+
+		// What is known about paths in the save directory. Cleared
+		// whenever the save directory is written to. Guarded by
+		// saveMutex, as files are also written on other threads.
+		std::map<std::string, int> saveTypes;
+		std::map<std::string, std::vector<std::string> > saveLists;
+		thread::Mutex saveMutex;
+
+		SaveType getSaveType(const std::string & path);
+		void getSaveList(const std::string & dir, std::vector<std::string> & files);
+
+		// Started by the first asynchronous request.
+		AsyncIO * async;
+		AsyncIO * getAsyncIO(love::event::Event * target);
+
 	protected:
 
 	public:
@@ -144,6 +211,12 @@ namespace physfs
 		**/
 		bool setSource(const char * source);
 
+		/**
+		* Forgets what is known about the save directory. Must be
+		* called whenever it is written to.
+		**/
+		void invalidateSaveCache();
+
 		/**
 		* Creates a new file.
 		**/
@@ -279,15 +352,48 @@ namespace physfs
 		**/
 		int load(lua_State * L);
 
+		/**
+		* Enables or disables the compiled chunk cache. When enabled,
+		* load stores the bytecode (lua_dump) of each file it compiles
+		* in the save directory, keyed by path, size and modification
+		* time, and loads that instead of parsing the file again.
+		* Bytecode can also be shipped in place of the .lua source.
+		**/
+		void setChunkCache(bool enable);
+		bool hasChunkCache() const;
+
 		int getLastModified(lua_State * L);
 
+		/**
+		* Reads a whole file on an I/O thread. The contents are
+		* delivered as a LOVE_ASYNC_IO_EVENT message (see AsyncIO).
+		* @param filename The file to read.
+		* @param target The event module to deliver the completion to.
+		* @return The id of the request.
+		**/
+		int readAsync(const char * filename, love::event::Event * target);
+
+		/**
+		* Writes a whole file on an I/O thread. The data is copied.
+		* @return The id of the request.
+		**/
+		int writeAsync(const char * filename, const void * data, size_t size, love::event::Event * target);
+
 		/**
 		* Text file line-reading iterator function used and
 		* pushed on the Lua stack by love.filesystem.lines
 		* and File:lines.
+		* Upvalues: the File, the saved position and mode (File:lines
+		* only, nil otherwise) and the buffer from pushLinesBuffer.
+		* The file is read sequentially and never seeked backwards.
 		**/
 		static int lines_i(lua_State * L);
 
+		/**
+		* Pushes a new read buffer for lines_i onto the Lua stack.
+		**/
+		static void pushLinesBuffer(lua_State * L);
+
 	}; // Filesystem
 
 } // physfs
@@ -0,0 +1,375 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+
+#include "PackArchive.h"
+
+// STD
+#include <algorithm>
+#include <cstring>
+
+// LOVE
+#include <common/Exception.h>
+#include <filesystem/FileData.h>
+
+// zlib
+#include <zlib.h>
+
+namespace love
+{
+namespace filesystem
+{
+namespace physfs
+{
+	static const int PACK_HEADER_SIZE = 24;
+	static const int PACK_FANOUT_SIZE = 256 * 4;
+	static const int PACK_ENTRY_SIZE = 40;
+
+	static inline uint32 read32(const unsigned char * p)
+	{
+		return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32) p[3] << 24);
+	}
+
+	static inline int64 read64(const unsigned char * p)
+	{
+		return (int64) ((uint64) read32(p) | ((uint64) read32(p + 4) << 32));
+	}
+
+	PackArchive::PackArchive(ArchiveIO * io)
+		: io(io), blocksize(0), cachedOffset(-1), cachedBlock(-1)
+	{
+		io->retain();
+
+		try
+		{
+			readIndex();
+		}
+		catch (love::Exception &)
+		{
+			io->release();
+			throw;
+		}
+	}
+
+	PackArchive::~PackArchive()
+	{
+		io->release();
+	}
+
+	bool PackArchive::isPack(ArchiveIO * io)
+	{
+		char magic[8];
+		if (io->getSize() < PACK_HEADER_SIZE || !io->read(magic, 0, sizeof(magic)))
+			return false;
+		return memcmp(magic, LOVE_PACK_MAGIC, sizeof(magic)) == 0;
+	}
+
+	uint32 PackArchive::hash(const std::string & path)
+	{
+		uint32 h = 2166136261u;
+		for (size_t i = 0; i < path.size(); i++)
+			h = (h ^ (unsigned char) path[i]) * 16777619u;
+		return h;
+	}
+
+	void PackArchive::readIndex()
+	{
+		int64 size = io->getSize();
+		unsigned char header[PACK_HEADER_SIZE];
+		if (size < PACK_HEADER_SIZE || !io->read(header, 0, PACK_HEADER_SIZE))
+			throw love::Exception("Not a pack file.");
+		if (memcmp(header, LOVE_PACK_MAGIC, 8) != 0)
+			throw love::Exception("Not a pack file.");
+
+		uint32 count = read32(header + 8);
+		blocksize = read32(header + 12);
+		uint32 namesize = read32(header + 16);
+
+		// The fan-out table, index and names are read at once.
+		int64 indexsize = PACK_FANOUT_SIZE + (int64) count * PACK_ENTRY_SIZE + namesize;
+		if (blocksize == 0 || PACK_HEADER_SIZE + indexsize > size)
+			throw love::Exception("Corrupt pack index.");
+
+		std::vector<unsigned char> index((size_t) indexsize);
+		if (!io->read(&index[0], PACK_HEADER_SIZE, indexsize))
+			throw love::Exception("Could not read pack index.");
+
+		for (int i = 0; i < 256; i++)
+			fanout[i] = read32(&index[i * 4]);
+		if (fanout[255] != count)
+			throw love::Exception("Corrupt pack index.");
+
+		const unsigned char * p = &index[PACK_FANOUT_SIZE];
+		const char * names = (const char *) p + (size_t) count * PACK_ENTRY_SIZE;
+
+		entries.resize(count);
+		dirs[""];
+
+		for (uint32 i = 0; i < count; i++, p += PACK_ENTRY_SIZE)
+		{
+			Entry & e = entries[i];
+			e.hash = read32(p);
+			e.flags = read32(p + 4);
+			uint32 name = read32(p + 8);
+			uint32 namelen = read32(p + 12);
+			e.offset = read64(p + 16);
+			e.size = read64(p + 24);
+			e.modtime = read64(p + 32);
+
+			if ((uint64) name + namelen > namesize || e.offset < 0 || e.offset > size)
+				throw love::Exception("Corrupt pack index.");
+			e.name.assign(names + name, namelen);
+
+			std::string::size_type slash = e.name.rfind('/');
+			std::string parent = (slash == std::string::npos) ? "" : e.name.substr(0, slash);
+			addDirectory(parent);
+			dirs[parent].push_back(e.name.substr(slash + 1));
+		}
+	}
+
+	void PackArchive::addDirectory(const std::string & path)
+	{
+		if (path.empty() || dirs.find(path) != dirs.end())
+			return;
+
+		dirs[path];
+
+		std::string::size_type slash = path.rfind('/');
+		std::string parent = (slash == std::string::npos) ? "" : path.substr(0, slash);
+		addDirectory(parent);
+		dirs[parent].push_back(path.substr(slash + 1));
+	}
+
+	const PackArchive::Entry * PackArchive::findEntry(const std::string & path) const
+	{
+		uint32 h = hash(path);
+		uint32 top = h >> 24;
+
+		// The fan-out table narrows the search to the files sharing the
+		// top byte of the hash, of which there are few.
+		uint32 first = (top == 0) ? 0 : fanout[top - 1];
+		uint32 last = fanout[top];
+
+		while (first < last)
+		{
+			uint32 mid = first + (last - first) / 2;
+			if (entries[mid].hash < h)
+				first = mid + 1;
+			else
+				last = mid;
+		}
+
+		for (uint32 i = first; i < entries.size() && entries[i].hash == h; i++)
+		{
+			if (entries[i].name == path)
+				return &entries[i];
+		}
+
+		return 0;
+	}
+
+	bool PackArchive::exists(const std::string & path)
+	{
+		return findEntry(path) != 0 || dirs.find(path) != dirs.end();
+	}
+
+	bool PackArchive::isDirectory(const std::string & path)
+	{
+		return dirs.find(path) != dirs.end();
+	}
+
+	void PackArchive::enumerate(const std::string & dir, std::vector<std::string> & files)
+	{
+		std::map<std::string, std::vector<std::string> >::iterator it = dirs.find(dir);
+		if (it != dirs.end())
+			files.insert(files.end(), it->second.begin(), it->second.end());
+	}
+
+	int64 PackArchive::getLastModified(const std::string & path)
+	{
+		const Entry * e = findEntry(path);
+		return (e != 0) ? e->modtime : -1;
+	}
+
+	int64 PackArchive::getSize(const std::string & path)
+	{
+		const Entry * e = findEntry(path);
+		return (e != 0) ? e->size : -1;
+	}
+
+	Data * PackArchive::read(const std::string & path)
+	{
+		const Entry * e = findEntry(path);
+		if (e == 0)
+			return 0;
+		return readRange(*e, 0, e->size);
+	}
+
+	Data * PackArchive::read(const std::string & path, int64 offset, int64 size)
+	{
+		const Entry * e = findEntry(path);
+		if (e == 0)
+			return 0;
+
+		offset = std::min(std::max(offset, (int64) 0), e->size);
+		size = std::min(std::max(size, (int64) 0), e->size - offset);
+		return readRange(*e, offset, size);
+	}
+
+	bool PackArchive::hasRangeReads() const
+	{
+		return true;
+	}
+
+	Data * PackArchive::readRange(const Entry & e, int64 offset, int64 size)
+	{
+		if (e.flags & PACK_COMPRESSED)
+			return readCompressed(e, offset, size);
+
+		// Stored files of a source in memory need no copy at all.
+		const void * src = io->getPointer(e.offset + offset, size);
+		if (src != 0)
+			return new FileData((void *) src, size, e.name, io);
+
+		FileData * data = new FileData(size, e.name);
+		thread::Lock lock(mutex);
+		if (size > 0 && !io->read(data->getData(), e.offset + offset, size))
+		{
+			data->release();
+			return 0;
+		}
+		return data;
+	}
+
+	static bool inflateBlock(const unsigned char * src, int64 insize, unsigned char * dst, int64 outsize)
+	{
+		if (insize == outsize)
+		{
+			memcpy(dst, src, (size_t) outsize);
+			return true;
+		}
+
+		z_stream z;
+		memset(&z, 0, sizeof(z));
+		z.next_in = (Bytef *) src;
+		z.avail_in = (uInt) insize;
+		z.next_out = (Bytef *) dst;
+		z.avail_out = (uInt) outsize;
+
+		int status = Z_DATA_ERROR;
+		if (inflateInit2(&z, -MAX_WBITS) == Z_OK)
+		{
+			status = inflate(&z, Z_FINISH);
+			inflateEnd(&z);
+		}
+
+		return status == Z_STREAM_END && z.total_out == (uLong) outsize;
+	}
+
+	Data * PackArchive::readCompressed(const Entry & e, int64 offset, int64 size)
+	{
+		FileData * data = new FileData(size, e.name);
+		if (size == 0)
+			return data;
+
+		// Only the blocks covering the range are read and inflated.
+		int64 nblocks = (e.size + blocksize - 1) / blocksize;
+		int64 first = offset / blocksize;
+		int64 last = (offset + size - 1) / blocksize + 1;
+
+		std::vector<unsigned char> table((size_t) last * 4);
+
+		thread::Lock lock(mutex);
+
+		if (!io->read(&table[0], e.offset, last * 4))
+		{
+			data->release();
+			return 0;
+		}
+
+		int64 start = e.offset + nblocks * 4;
+		for (int64 i = 0; i < first; i++)
+			start += read32(&table[(size_t) i * 4]);
+
+		int64 compressed = 0;
+		for (int64 i = first; i < last; i++)
+			compressed += read32(&table[(size_t) i * 4]);
+
+		// The blocks of the range are read at once.
+		std::vector<unsigned char> in;
+		const unsigned char * src = (const unsigned char *) io->getPointer(start, compressed);
+		if (src == 0)
+		{
+			in.resize((size_t) compressed + 1);
+			if (compressed > 0 && !io->read(&in[0], start, compressed))
+			{
+				data->release();
+				return 0;
+			}
+			src = &in[0];
+		}
+
+		unsigned char * dst = (unsigned char *) data->getData();
+
+		for (int64 i = first; i < last; i++)
+		{
+			int64 insize = read32(&table[(size_t) i * 4]);
+			int64 blockstart = i * blocksize;
+			int64 outsize = std::min(blocksize, e.size - blockstart);
+
+			// The part of this block inside the range.
+			int64 lo = std::max(offset, blockstart) - blockstart;
+			int64 hi = std::min(offset + size, blockstart + outsize) - blockstart;
+
+			if (lo == 0 && hi == outsize)
+			{
+				if (!inflateBlock(src, insize, dst, outsize))
+				{
+					data->release();
+					return 0;
+				}
+			}
+			else
+			{
+				if (cachedOffset != e.offset || cachedBlock != i)
+				{
+					cache.resize((size_t) blocksize);
+					cachedOffset = -1;
+					if (!inflateBlock(src, insize, &cache[0], outsize))
+					{
+						data->release();
+						return 0;
+					}
+					cachedOffset = e.offset;
+					cachedBlock = i;
+				}
+				memcpy(dst, &cache[(size_t) lo], (size_t) (hi - lo));
+			}
+
+			src += insize;
+			dst += hi - lo;
+		}
+
+		return data;
+	}
+
+} // physfs
+} // filesystem
+} // love
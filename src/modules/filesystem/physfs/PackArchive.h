@@ -0,0 +1,153 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+
+#ifndef LOVE_FILESYSTEM_PHYSFS_PACK_ARCHIVE_H
+#define LOVE_FILESYSTEM_PHYSFS_PACK_ARCHIVE_H
+
+// STD
+#include <map>
+#include <string>
+#include <vector>
+
+// LOVE
+#include <thread/threads.h>
+#include "Archive.h"
+
+// First bytes of a pack file.
+#define LOVE_PACK_MAGIC "LOVEPAK1"
+
+namespace love
+{
+namespace filesystem
+{
+namespace physfs
+{
+	/**
+	* An indexed pack file, as written by script/make_pack.py. All
+	* numbers are little-endian.
+	*
+	* Header (24 bytes):
+	*   char magic[8]          LOVE_PACK_MAGIC
+	*   uint32 count           Number of files.
+	*   uint32 blocksize       Uncompressed size of compressed blocks.
+	*   uint32 namesize        Size of the name table.
+	*   uint32 reserved
+	* Fan-out table: uint32[256], where entry i is the number of files
+	*   whose hash has a top byte of at most i.
+	* Index: count entries of 40 bytes, sorted by hash:
+	*   uint32 hash            FNV-1a of the normalized path.
+	*   uint32 flags           PACK_COMPRESSED or 0.
+	*   uint32 name            Offset of the path in the name table.
+	*   uint32 namelen
+	*   uint64 offset          Offset of the file data in the pack.
+	*   uint64 size            Uncompressed size of the file.
+	*   uint64 modtime
+	* Name table: namesize bytes of paths, not terminated.
+	* File data.
+	*
+	* Stored files are their bytes as-is. Compressed files are split
+	* into blocks of blocksize bytes (the last may be shorter), each
+	* raw-deflated on its own, and start with a uint32 table of the
+	* compressed size of each block. A block whose compressed size
+	* equals its uncompressed size is stored.
+	**/
+	class PackArchive : public Archive
+	{
+	private:
+
+		enum
+		{
+			PACK_COMPRESSED = 1,
+		};
+
+		struct Entry
+		{
+			uint32 hash;
+			uint32 flags;
+			std::string name;
+			int64 offset;
+			int64 size;
+			int64 modtime;
+		};
+
+		// The source of the pack file.
+		ArchiveIO * io;
+
+		int64 blocksize;
+
+		// Sorted by hash, as in the file.
+		std::vector<Entry> entries;
+		uint32 fanout[256];
+
+		// The names in each directory ("" is the root).
+		std::map<std::string, std::vector<std::string> > dirs;
+
+		// The last block inflated to read part of it, so that reading
+		// a file in small pieces inflates each block once.
+		int64 cachedOffset;
+		int64 cachedBlock;
+		std::vector<unsigned char> cache;
+
+		// Guards reads from io and the cached block.
+		thread::Mutex mutex;
+
+		void readIndex();
+		void addDirectory(const std::string & path);
+		const Entry * findEntry(const std::string & path) const;
+		Data * readRange(const Entry & e, int64 offset, int64 size);
+		Data * readCompressed(const Entry & e, int64 offset, int64 size);
+
+	public:
+
+		/**
+		* Reads the index of a pack file.
+		* @param io The source of the pack file. Will be retained.
+		**/
+		PackArchive(ArchiveIO * io);
+		virtual ~PackArchive();
+
+		/**
+		* Checks whether a source starts with LOVE_PACK_MAGIC.
+		**/
+		static bool isPack(ArchiveIO * io);
+
+		/**
+		* Hashes a normalized path as the index does.
+		**/
+		static uint32 hash(const std::string & path);
+
+		// Implements Archive.
+		bool exists(const std::string & path);
+		bool isDirectory(const std::string & path);
+		void enumerate(const std::string & dir, std::vector<std::string> & files);
+		int64 getLastModified(const std::string & path);
+		int64 getSize(const std::string & path);
+		Data * read(const std::string & path);
+		Data * read(const std::string & path, int64 offset, int64 size);
+		bool hasRangeReads() const;
+
+	}; // PackArchive
+
+} // physfs
+} // filesystem
+} // love
+
+#endif // LOVE_FILESYSTEM_PHYSFS_PACK_ARCHIVE_H
@@ -0,0 +1,131 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+
+#include "SourceIndex.h"
+#include "Archive.h"
+
+// PhysFS
+#ifdef LOVE_MACOSX // wacky Mac behavior means different #include syntax!
+#include <physfs/physfs.h>
+#else
+#include <physfs.h>
+#endif
+
+namespace love
+{
+namespace filesystem
+{
+namespace physfs
+{
+	SourceIndex::SourceIndex()
+	{
+		entries[""].directory = true;
+	}
+
+	void SourceIndex::buildPhysFS(const std::string & source)
+	{
+		addPhysFS("", source);
+	}
+
+	void SourceIndex::buildArchive(Archive * archive)
+	{
+		addArchive("", archive);
+	}
+
+	void SourceIndex::addPhysFS(const std::string & dir, const std::string & source)
+	{
+		char ** rc = PHYSFS_enumerateFiles(dir.c_str());
+		for (char ** i = rc; *i != 0; i++)
+		{
+			std::string path = dir.empty() ? std::string(*i) : dir + "/" + *i;
+
+			// Skip whatever else is in the search path.
+			const char * realdir = PHYSFS_getRealDir(path.c_str());
+			if (realdir == 0 || source != realdir)
+				continue;
+
+			bool directory = PHYSFS_isDirectory(path.c_str()) != 0;
+			add(path, directory);
+			if (directory)
+				addPhysFS(path, source);
+		}
+		PHYSFS_freeList(rc);
+	}
+
+	void SourceIndex::addArchive(const std::string & dir, Archive * archive)
+	{
+		std::vector<std::string> files;
+		archive->enumerate(dir, files);
+		for (size_t i = 0; i < files.size(); i++)
+		{
+			std::string path = dir.empty() ? files[i] : dir + "/" + files[i];
+			bool directory = archive->isDirectory(path);
+			add(path, directory);
+			if (directory)
+				addArchive(path, archive);
+		}
+	}
+
+	void SourceIndex::add(const std::string & path, bool directory)
+	{
+		std::map<std::string, Entry>::iterator it = entries.find(path);
+		if (it != entries.end())
+		{
+			it->second.directory = it->second.directory || directory;
+			return;
+		}
+
+		Entry & entry = entries[path];
+		entry.directory = directory;
+
+		size_t slash = path.rfind('/');
+		std::string parent = (slash == std::string::npos) ? "" : path.substr(0, slash);
+		std::string name = (slash == std::string::npos) ? path : path.substr(slash + 1);
+
+		if (!path.empty())
+		{
+			add(parent, true);
+			entries[parent].children.push_back(name);
+		}
+	}
+
+	bool SourceIndex::exists(const std::string & path) const
+	{
+		return entries.find(path) != entries.end();
+	}
+
+	bool SourceIndex::isDirectory(const std::string & path) const
+	{
+		std::map<std::string, Entry>::const_iterator it = entries.find(path);
+		return it != entries.end() && it->second.directory;
+	}
+
+	const std::vector<std::string> * SourceIndex::enumerate(const std::string & dir) const
+	{
+		std::map<std::string, Entry>::const_iterator it = entries.find(dir);
+		if (it == entries.end() || !it->second.directory)
+			return 0;
+		return &it->second.children;
+	}
+
+} // physfs
+} // filesystem
+} // love
@@ -0,0 +1,94 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+
+#ifndef LOVE_FILESYSTEM_PHYSFS_SOURCE_INDEX_H
+#define LOVE_FILESYSTEM_PHYSFS_SOURCE_INDEX_H
+
+// STD
+#include <map>
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace filesystem
+{
+namespace physfs
+{
+	class Archive;
+
+	/**
+	* An in-memory listing of the game source, which is read-only,
+	* so that lookups don't have to go through PhysFS or the archive.
+	* Paths are normalized (see Archive::normalize); the root is "".
+	**/
+	class SourceIndex
+	{
+	private:
+
+		struct Entry
+		{
+			bool directory;
+			std::vector<std::string> children;
+		};
+
+		std::map<std::string, Entry> entries;
+
+		void addPhysFS(const std::string & dir, const std::string & source);
+		void addArchive(const std::string & dir, Archive * archive);
+
+	public:
+
+		SourceIndex();
+
+		/**
+		* Indexes the PhysFS files which come from a source directory
+		* or archive.
+		* @param source The source as it was added to the search path.
+		**/
+		void buildPhysFS(const std::string & source);
+
+		/**
+		* Indexes the files of a mounted archive.
+		**/
+		void buildArchive(Archive * archive);
+
+		/**
+		* Adds an entry, and the entries of its parent directories.
+		**/
+		void add(const std::string & path, bool directory);
+
+		bool exists(const std::string & path) const;
+		bool isDirectory(const std::string & path) const;
+
+		/**
+		* Gets the names of the entries in a directory, or 0 if the
+		* index has no such directory.
+		**/
+		const std::vector<std::string> * enumerate(const std::string & dir) const;
+
+	}; // SourceIndex
+
+} // physfs
+} // filesystem
+} // love
+
+#endif // LOVE_FILESYSTEM_PHYSFS_SOURCE_INDEX_H
@@ -0,0 +1,409 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+#include "ZipArchive.h"
+
+// STD
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+
+// LOVE
+#include <common/Exception.h>
+#include <filesystem/FileData.h>
+
+// zlib
+#include <zlib.h>
+
+namespace love
+{
+namespace filesystem
+{
+namespace physfs
+{
+	// Zip record signatures and sizes.
+	static const uint32 ZIP_LOCAL_SIG = 0x04034b50;
+	static const uint32 ZIP_CENTRAL_SIG = 0x02014b50;
+	static const uint32 ZIP_END_SIG = 0x06054b50;
+	static const int ZIP_LOCAL_SIZE = 30;
+	static const int ZIP_CENTRAL_SIZE = 46;
+	static const int ZIP_END_SIZE = 22;
+
+	// Extra bytes read in case a local extra field is longer than the
+	// central one (Info-ZIP timestamps are).
+	static const int ZIP_LOCAL_SLACK = 64;
+
+	static inline uint32 read16(const unsigned char * p)
+	{
+		return p[0] | (p[1] << 8);
+	}
+
+	static inline uint32 read32(const unsigned char * p)
+	{
+		return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32) p[3] << 24);
+	}
+
+	static int64 dosTime(uint32 time, uint32 date)
+	{
+		struct tm t;
+		memset(&t, 0, sizeof(t));
+		t.tm_sec = (time & 0x1F) * 2;
+		t.tm_min = (time >> 5) & 0x3F;
+		t.tm_hour = (time >> 11) & 0x1F;
+		t.tm_mday = date & 0x1F;
+		t.tm_mon = ((date >> 5) & 0x0F) - 1;
+		t.tm_year = ((date >> 9) & 0x7F) + 80;
+		t.tm_isdst = -1;
+		return (int64) mktime(&t);
+	}
+
+	ZipArchive::ZipArchive(ArchiveIO * io)
+		: io(io), cacheSize(0), cacheLimit(io->getCacheLimit())
+	{
+		io->retain();
+
+		try
+		{
+			readCentralDirectory();
+		}
+		catch (love::Exception &)
+		{
+			io->release();
+			throw;
+		}
+	}
+
+	ZipArchive::~ZipArchive()
+	{
+		std::map<std::string, CacheItem>::iterator it;
+		for (it = cache.begin(); it != cache.end(); ++it)
+			it->second.data->release();
+
+		io->release();
+	}
+
+	void ZipArchive::readCentralDirectory()
+	{
+		int64 size = io->getSize();
+		if (size < ZIP_END_SIZE)
+			throw love::Exception("Not a zip file.");
+
+		// The end record is followed by a comment of at most 64 KB.
+		int64 tail = std::min<int64>(size, ZIP_END_SIZE + 0xFFFF);
+		std::vector<unsigned char> buf((size_t) tail);
+		if (!io->read(&buf[0], size - tail, tail))
+			throw love::Exception("Could not read zip end record.");
+
+		int64 end = -1;
+		for (int64 i = tail - ZIP_END_SIZE; i >= 0; i--)
+		{
+			if (read32(&buf[(size_t) i]) == ZIP_END_SIG)
+			{
+				end = i;
+				break;
+			}
+		}
+
+		if (end < 0)
+			throw love::Exception("Not a zip file.");
+
+		const unsigned char * e = &buf[(size_t) end];
+		uint32 count = read16(e + 10);
+		int64 cdsize = read32(e + 12);
+		int64 cdoffset = read32(e + 16);
+
+		if (cdoffset + cdsize > size)
+			throw love::Exception("Corrupt zip central directory.");
+
+		std::vector<unsigned char> cd((size_t) cdsize + 1);
+		if (cdsize > 0 && !io->read(&cd[0], cdoffset, cdsize))
+			throw love::Exception("Could not read zip central directory.");
+
+		dirs[""];
+
+		const unsigned char * p = &cd[0];
+		const unsigned char * last = p + cdsize;
+
+		for (uint32 i = 0; i < count; i++)
+		{
+			if (p + ZIP_CENTRAL_SIZE > last || read32(p) != ZIP_CENTRAL_SIG)
+				throw love::Exception("Corrupt zip central directory.");
+
+			uint32 namelen = read16(p + 28);
+			uint32 extralen = read16(p + 30);
+			uint32 commentlen = read16(p + 32);
+
+			if (p + ZIP_CENTRAL_SIZE + namelen > last)
+				throw love::Exception("Corrupt zip central directory.");
+
+			std::string name((const char *) p + ZIP_CENTRAL_SIZE, namelen);
+			bool directory = !name.empty() && name[name.size() - 1] == '/';
+			name = normalize(name.c_str());
+
+			if (directory)
+				addDirectory(name);
+			else if (!name.empty())
+			{
+				Entry entry;
+				entry.header = read32(p + 42);
+				entry.namelen = namelen;
+				entry.extralen = extralen;
+				entry.offset = -1;
+				entry.compressed = read32(p + 20);
+				entry.uncompressed = read32(p + 24);
+				entry.method = read16(p + 10);
+				entry.modtime = dosTime(read16(p + 12), read16(p + 14));
+
+				std::string::size_type slash = name.rfind('/');
+				std::string parent = (slash == std::string::npos) ? "" : name.substr(0, slash);
+				addDirectory(parent);
+
+				if (files.find(name) == files.end())
+					dirs[parent].push_back(name.substr(slash + 1));
+				files[name] = entry;
+			}
+
+			p += ZIP_CENTRAL_SIZE + namelen + extralen + commentlen;
+		}
+	}
+
+	void ZipArchive::addDirectory(const std::string & path)
+	{
+		if (path.empty() || dirs.find(path) != dirs.end())
+			return;
+
+		dirs[path];
+
+		std::string::size_type slash = path.rfind('/');
+		std::string parent = (slash == std::string::npos) ? "" : path.substr(0, slash);
+		addDirectory(parent);
+		dirs[parent].push_back(path.substr(slash + 1));
+	}
+
+	bool ZipArchive::exists(const std::string & path)
+	{
+		return files.find(path) != files.end() || dirs.find(path) != dirs.end();
+	}
+
+	bool ZipArchive::isDirectory(const std::string & path)
+	{
+		return dirs.find(path) != dirs.end();
+	}
+
+	void ZipArchive::enumerate(const std::string & dir, std::vector<std::string> & files)
+	{
+		std::map<std::string, std::vector<std::string> >::iterator it = dirs.find(dir);
+		if (it != dirs.end())
+			files.insert(files.end(), it->second.begin(), it->second.end());
+	}
+
+	int64 ZipArchive::getLastModified(const std::string & path)
+	{
+		std::map<std::string, Entry>::iterator it = files.find(path);
+		if (it == files.end())
+			return -1;
+		return it->second.modtime;
+	}
+
+	int64 ZipArchive::getSize(const std::string & path)
+	{
+		std::map<std::string, Entry>::iterator it = files.find(path);
+		if (it == files.end())
+			return -1;
+		return it->second.uncompressed;
+	}
+
+	Data * ZipArchive::readEntry(const std::string & path, Entry & e)
+	{
+		std::vector<unsigned char> in;
+		const unsigned char * src = 0;
+
+		if (e.offset < 0)
+		{
+			const unsigned char * header = (const unsigned char *) io->getPointer(e.header, ZIP_LOCAL_SIZE);
+			if (header != 0)
+			{
+				if (read32(header) != ZIP_LOCAL_SIG)
+					return 0;
+				e.offset = e.header + ZIP_LOCAL_SIZE + read16(header + 26) + read16(header + 28);
+			}
+			else
+			{
+				// Read the local header together with the data. The local
+				// extra field usually matches the central one, give or take.
+				int64 guess = ZIP_LOCAL_SIZE + e.namelen + e.extralen + ZIP_LOCAL_SLACK + e.compressed;
+				guess = std::min(guess, io->getSize() - e.header);
+				if (guess < ZIP_LOCAL_SIZE)
+					return 0;
+
+				in.resize((size_t) guess);
+				if (!io->read(&in[0], e.header, guess) || read32(&in[0]) != ZIP_LOCAL_SIG)
+					return 0;
+
+				int64 start = ZIP_LOCAL_SIZE + read16(&in[26]) + read16(&in[28]);
+				e.offset = e.header + start;
+
+				if (start + e.compressed <= guess)
+					src = &in[(size_t) start];
+			}
+		}
+
+		if (src == 0)
+		{
+			src = (const unsigned char *) io->getPointer(e.offset, e.compressed);
+
+			// Stored entries of a source in memory need no copy at all.
+			if (src != 0 && e.method == 0 && e.uncompressed == e.compressed)
+				return new FileData((void *) src, e.uncompressed, path, io);
+		}
+
+		if (src == 0)
+		{
+			in.resize((size_t) e.compressed + 1);
+			if (e.compressed > 0 && !io->read(&in[0], e.offset, e.compressed))
+				return 0;
+			src = &in[0];
+		}
+
+		FileData * data = new FileData(e.uncompressed, path);
+
+		if (e.method == 0)
+		{
+			if (e.uncompressed == e.compressed)
+			{
+				memcpy(data->getData(), src, (size_t) e.uncompressed);
+				return data;
+			}
+		}
+		else if (e.method == Z_DEFLATED)
+		{
+			z_stream z;
+			memset(&z, 0, sizeof(z));
+			z.next_in = (Bytef *) src;
+			z.avail_in = (uInt) e.compressed;
+			z.next_out = (Bytef *) data->getData();
+			z.avail_out = (uInt) e.uncompressed;
+
+			// Negative window bits: raw deflate data without a zlib header.
+			if (inflateInit2(&z, -MAX_WBITS) == Z_OK)
+			{
+				int status = inflate(&z, Z_FINISH);
+				inflateEnd(&z);
+				if (status == Z_STREAM_END && z.total_out == (uLong) e.uncompressed)
+					return data;
+			}
+		}
+
+		data->release();
+		return 0;
+	}
+
+	void ZipArchive::addToCache(const std::string & path, Data * data)
+	{
+		if (data->getSize() > cacheLimit)
+			return;
+
+		// Evict the least recently used entries to make room.
+		while (!lru.empty() && cacheSize + data->getSize() > cacheLimit)
+		{
+			std::map<std::string, CacheItem>::iterator it = cache.find(lru.back());
+			cacheSize -= it->second.data->getSize();
+			it->second.data->release();
+			cache.erase(it);
+			lru.pop_back();
+		}
+
+		data->retain();
+		lru.push_front(path);
+
+		CacheItem item;
+		item.data = data;
+		item.lru = lru.begin();
+		cache[path] = item;
+		cacheSize += data->getSize();
+	}
+
+	Data * ZipArchive::read(const std::string & path)
+	{
+		thread::Lock lock(mutex);
+
+		std::map<std::string, CacheItem>::iterator cached = cache.find(path);
+		if (cached != cache.end())
+		{
+			lru.splice(lru.begin(), lru, cached->second.lru);
+			cached->second.data->retain();
+			return cached->second.data;
+		}
+
+		std::map<std::string, Entry>::iterator it = files.find(path);
+		if (it == files.end())
+			return 0;
+
+		Data * data = readEntry(path, it->second);
+		if (data != 0 && cacheLimit > 0)
+			addToCache(path, data);
+
+		return data;
+	}
+
+	void ZipArchive::prefetch(const std::vector<std::string> & paths)
+	{
+		for (size_t i = 0; i < paths.size(); i++)
+		{
+			Data * data = read(normalize(paths[i].c_str()));
+			if (data != 0)
+				data->release();
+		}
+	}
+
+	void ZipArchive::prefetchManifest()
+	{
+		if (cacheLimit <= 0)
+			return;
+
+		Data * manifest = read(LOVE_ZIP_PREFETCH_MANIFEST);
+		if (manifest == 0)
+			return;
+
+		std::vector<std::string> paths;
+		const char * p = (const char *) manifest->getData();
+		const char * end = p + manifest->getSize();
+
+		while (p < end)
+		{
+			const char * nl = (const char *) memchr(p, '\n', end - p);
+			const char * last = (nl != 0) ? nl : end;
+			std::string line(p, last - p);
+
+			if (!line.empty() && line[line.size() - 1] == '\r')
+				line.erase(line.size() - 1);
+			if (!line.empty())
+				paths.push_back(line);
+
+			p = last + 1;
+		}
+
+		manifest->release();
+		prefetch(paths);
+	}
+
+} // physfs
+} // filesystem
+} // love
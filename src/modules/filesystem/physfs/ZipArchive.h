@@ -0,0 +1,140 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+#ifndef LOVE_FILESYSTEM_PHYSFS_ZIP_ARCHIVE_H
+#define LOVE_FILESYSTEM_PHYSFS_ZIP_ARCHIVE_H
+
+// STD
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+// LOVE
+#include <thread/threads.h>
+#include "Archive.h"
+
+// Name of the optional list of files (one per line) to read
+// into the entry cache when the archive is mounted.
+#define LOVE_ZIP_PREFETCH_MANIFEST ".prefetch"
+
+namespace love
+{
+namespace filesystem
+{
+namespace physfs
+{
+	/**
+	* A zip file (such as a .love) read through an ArchiveIO. Only the
+	* central directory is read up front; entries are read on demand,
+	* each with a single ranged read when possible. Decoded entries
+	* are kept in an LRU cache bounded by ArchiveIO::getCacheLimit.
+	**/
+	class ZipArchive : public Archive
+	{
+	private:
+
+		struct Entry
+		{
+			// Offset of the local file header.
+			int64 header;
+
+			// Name and extra field lengths from the central directory,
+			// used to guess the size of the local header.
+			int64 namelen;
+			int64 extralen;
+
+			// Offset of the entry data, or -1 until it is known.
+			int64 offset;
+
+			int64 compressed;
+			int64 uncompressed;
+
+			// 0 is stored, 8 is deflated.
+			int method;
+
+			int64 modtime;
+		};
+
+		// The source of the zip file.
+		ArchiveIO * io;
+
+		// All files, by normalized path.
+		std::map<std::string, Entry> files;
+
+		// The names in each directory ("" is the root).
+		std::map<std::string, std::vector<std::string> > dirs;
+
+		struct CacheItem
+		{
+			Data * data;
+			std::list<std::string>::iterator lru;
+		};
+
+		// Decoded entries; the most recently used is at the front of lru.
+		std::map<std::string, CacheItem> cache;
+		std::list<std::string> lru;
+		int64 cacheSize;
+		int64 cacheLimit;
+
+		// Guards the entries and the cache.
+		thread::Mutex mutex;
+
+		void readCentralDirectory();
+		void addDirectory(const std::string & path);
+		Data * readEntry(const std::string & path, Entry & e);
+		void addToCache(const std::string & path, Data * data);
+
+	public:
+
+		/**
+		* Reads the central directory of a zip file.
+		* @param io The source of the zip file. Will be retained.
+		**/
+		ZipArchive(ArchiveIO * io);
+		virtual ~ZipArchive();
+
+		// Implements Archive.
+		bool exists(const std::string & path);
+		bool isDirectory(const std::string & path);
+		void enumerate(const std::string & dir, std::vector<std::string> & files);
+		int64 getLastModified(const std::string & path);
+		int64 getSize(const std::string & path);
+		Data * read(const std::string & path);
+
+		/**
+		* Reads files into the entry cache ahead of use.
+		* @param paths The files to read.
+		**/
+		void prefetch(const std::vector<std::string> & paths);
+
+		/**
+		* Prefetches the files listed in LOVE_ZIP_PREFETCH_MANIFEST,
+		* if the archive has one and caching is enabled.
+		**/
+		void prefetchManifest();
+
+	}; // ZipArchive
+
+} // physfs
+} // filesystem
+} // love
+
+#endif // LOVE_FILESYSTEM_PHYSFS_ZIP_ARCHIVE_H
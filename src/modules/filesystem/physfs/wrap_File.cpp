@@ -169,6 +169,45 @@ namespace physfs
 		return 1;
 	}
 
+	int w_File_setBuffer(lua_State * L)
+	{
+		File * file = luax_checkfile(L, 1);
+		const char * str = luaL_checkstring(L, 2);
+		lua_Number size = luaL_optnumber(L, 3, 0);
+
+		File::BufferMode mode;
+		if (!File::getConstant(str, mode))
+			return luaL_error(L, "Incorrect file buffer mode: %s", str);
+
+		if (size < 0.0 || size >= 9007199254740992.0)
+			luax_pushboolean(L, false);
+		else
+			luax_pushboolean(L, file->setBuffer(mode, (int64) size));
+		return 1;
+	}
+
+	int w_File_getBuffer(lua_State * L)
+	{
+		File * file = luax_checkfile(L, 1);
+		int64 size = 0;
+		File::BufferMode mode = file->getBuffer(size);
+
+		const char * str = 0;
+		if (!File::getConstant(mode, str))
+			return luaL_error(L, "Unknown file buffer mode.");
+
+		lua_pushstring(L, str);
+		lua_pushnumber(L, (lua_Number) size);
+		return 2;
+	}
+
+	int w_File_flush(lua_State * L)
+	{
+		File * file = luax_checkfile(L, 1);
+		luax_pushboolean(L, file->flush());
+		return 1;
+	}
+
 	int w_File_lines(lua_State * L)
 	{
 		File * file;
@@ -176,7 +215,7 @@ namespace physfs
 		if (luax_istype(L, 1, FILESYSTEM_FILE_T))
 		{
 			file = luax_checktype<File>(L, 1, "File", FILESYSTEM_FILE_T);
-			lua_pushnumber(L, 0); // File position.
+			lua_pushnumber(L, 0); // Marks that the file position must be restored.
 			luax_pushboolean(L, file->getMode() != File::CLOSED); // Save current file mode.
 		}
 		else
@@ -198,7 +237,8 @@ namespace physfs
 			}
 		}
 
-		lua_pushcclosure(L, Filesystem::lines_i, 3);
+		Filesystem::pushLinesBuffer(L);
+		lua_pushcclosure(L, Filesystem::lines_i, 4);
 		return 1;
 	}
 
@@ -211,6 +251,9 @@ namespace physfs
 		{ "eof", w_File_eof },
 		{ "tell", w_File_tell },
 		{ "seek", w_File_seek },
+		{ "setBuffer", w_File_setBuffer },
+		{ "getBuffer", w_File_getBuffer },
+		{ "flush", w_File_flush },
 		{ "lines", w_File_lines },
 		{ 0, 0 }
 	};
@@ -41,6 +41,9 @@ namespace physfs
 	int w_File_eof(lua_State * L);
 	int w_File_tell(lua_State * L);
 	int w_File_seek(lua_State * L);
+	int w_File_setBuffer(lua_State * L);
+	int w_File_getBuffer(lua_State * L);
+	int w_File_flush(lua_State * L);
 	int w_File_lines(lua_State * L);
 	extern "C" int luaopen_file(lua_State * L);
 } // physfs
@@ -21,6 +21,11 @@
 // LOVE
 #include "wrap_Filesystem.h"
 
+#include <event/Event.h>
+
+// HACK(binji)
+#include "window/ppapi/FilesystemHack.h"
+
 namespace love
 {
 namespace filesystem
@@ -36,6 +41,12 @@ namespace physfs
 		return false;
 	}
 
+	void hack_invalidateSaveCache()
+	{
+		if (instance != 0)
+			instance->invalidateSaveCache();
+	}
+
 	int w_init(lua_State * L)
 	{
 		const char * arg0 = luaL_checkstring(L, 1);
@@ -240,7 +251,10 @@ namespace physfs
 		else
 			return luaL_error(L, "Expected filename.");
 
-		lua_pushcclosure(L, Filesystem::lines_i, 1);
+		lua_pushnil(L); // No saved file position.
+		lua_pushnil(L); // No saved file mode.
+		Filesystem::pushLinesBuffer(L);
+		lua_pushcclosure(L, Filesystem::lines_i, 4);
 		return 1;
 	}
 
@@ -256,11 +270,159 @@ namespace physfs
 		}
 	}
 
+	int w_setChunkCache(lua_State * L)
+	{
+		instance->setChunkCache(luax_toboolean(L, 1));
+		return 0;
+	}
+
+	int w_hasChunkCache(lua_State * L)
+	{
+		luax_pushboolean(L, instance->hasChunkCache());
+		return 1;
+	}
+
 	int w_getLastModified(lua_State * L)
 	{
 		return instance->getLastModified(L);
 	}
 
+	// Returns how the save directory is being mirrored to persistent
+	// storage: bytes copied, files copied, and copies and directory
+	// creations that were avoided by batching.
+	int w_getSyncStats(lua_State * L)
+	{
+		love::window::ppapi::WriteBehind::Stats stats;
+		love::window::ppapi::GetFilesystemHackStats(&stats);
+		lua_pushnumber(L, (lua_Number) stats.bytes_copied);
+		lua_pushinteger(L, stats.files_copied);
+		lua_pushinteger(L, stats.copies_avoided);
+		lua_pushinteger(L, stats.directories_avoided);
+		return 4;
+	}
+
+	// Registry field of the table which maps the ids of pending
+	// asynchronous requests to their callbacks.
+	static const char * ASYNC_CALLBACKS = "love.filesystem.async";
+
+	// Checks the callback argument, before the request is queued.
+	static void checkAsyncCallback(lua_State * L, int idx)
+	{
+		if (!lua_isnoneornil(L, idx))
+			luaL_checktype(L, idx, LUA_TFUNCTION);
+	}
+
+	static void setAsyncCallback(lua_State * L, int id, int idx)
+	{
+		if (lua_isnoneornil(L, idx))
+			return;
+
+		lua_getfield(L, LUA_REGISTRYINDEX, ASYNC_CALLBACKS);
+		if (lua_isnil(L, -1))
+		{
+			lua_pop(L, 1);
+			lua_newtable(L);
+			lua_pushvalue(L, -1);
+			lua_setfield(L, LUA_REGISTRYINDEX, ASYNC_CALLBACKS);
+		}
+		lua_pushvalue(L, idx);
+		lua_rawseti(L, -2, id);
+		lua_pop(L, 1);
+	}
+
+	int w_readAsync(lua_State * L)
+	{
+		const char * filename = luaL_checkstring(L, 1);
+		checkAsyncCallback(L, 2);
+		love::event::Event * event = luax_getmodule<love::event::Event>(L, "event", MODULE_T);
+
+		int id;
+		try
+		{
+			id = instance->readAsync(filename, event);
+		}
+		catch (love::Exception & e)
+		{
+			return luaL_error(L, "%s", e.what());
+		}
+
+		setAsyncCallback(L, id, 2);
+		lua_pushinteger(L, id);
+		return 1;
+	}
+
+	int w_writeAsync(lua_State * L)
+	{
+		const char * filename = luaL_checkstring(L, 1);
+
+		size_t length = 0;
+		const char * input;
+		if (lua_isstring(L, 2))
+			input = lua_tolstring(L, 2, &length);
+		else if (luax_istype(L, 2, DATA_T))
+		{
+			love::Data * data = luax_totype<love::Data>(L, 2, "Data", DATA_T);
+			length = data->getSize();
+			input = (const char *) data->getData();
+		}
+		else
+			return luaL_error(L, "Expected string or data for argument #2.");
+
+		checkAsyncCallback(L, 3);
+		love::event::Event * event = luax_getmodule<love::event::Event>(L, "event", MODULE_T);
+
+		int id;
+		try
+		{
+			id = instance->writeAsync(filename, input, length, event);
+		}
+		catch (love::Exception & e)
+		{
+			return luaL_error(L, "%s", e.what());
+		}
+
+		setAsyncCallback(L, id, 3);
+		lua_pushinteger(L, id);
+		return 1;
+	}
+
+	// Called by the LOVE_ASYNC_IO_EVENT handler in boot.lua with the
+	// arguments of the message. Calls the callback of the request with
+	// the contents (true for writes), or with nil and the error.
+	int w_completeAsync(lua_State * L)
+	{
+		int id = luaL_checkint(L, 1);
+		bool success = luax_toboolean(L, 2);
+
+		lua_getfield(L, LUA_REGISTRYINDEX, ASYNC_CALLBACKS);
+		if (lua_isnil(L, -1))
+			return 0;
+
+		lua_rawgeti(L, -1, id);
+		if (lua_isnil(L, -1))
+			return 0;
+
+		// The callback runs once.
+		lua_pushnil(L);
+		lua_rawseti(L, -3, id);
+
+		if (success)
+		{
+			if (lua_isnoneornil(L, 3))
+				lua_pushboolean(L, 1);
+			else
+				lua_pushvalue(L, 3);
+			lua_call(L, 1, 0);
+		}
+		else
+		{
+			lua_pushnil(L);
+			lua_pushvalue(L, 3);
+			lua_call(L, 2, 0);
+		}
+		return 0;
+	}
+
 	int loader(lua_State * L)
 	{
 		const char * filename = lua_tostring(L, -1);
@@ -385,7 +547,13 @@ namespace physfs
 		{ "enumerate",  w_enumerate },
 		{ "lines",  w_lines },
 		{ "load",  w_load },
+		{ "setChunkCache", w_setChunkCache },
+		{ "hasChunkCache", w_hasChunkCache },
 		{ "getLastModified", w_getLastModified },
+		{ "readAsync", w_readAsync },
+		{ "writeAsync", w_writeAsync },
+		{ "completeAsync", w_completeAsync },
+		{ "getSyncStats", w_getSyncStats },
 		{ "newFileData", w_newFileData },
 		{ 0, 0 }
 	};
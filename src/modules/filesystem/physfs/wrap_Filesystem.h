@@ -36,6 +36,7 @@ namespace filesystem
 namespace physfs
 {
 	bool hack_setupWriteDirectory();
+	void hack_invalidateSaveCache();
 	int w_init(lua_State * L);
 	int w_setRelease(lua_State * L);
 	int w_setIdentity(lua_State * L);
@@ -62,6 +63,10 @@ namespace physfs
 	int w_lines(lua_State * L);
 	int w_load(lua_State * L);
 	int w_getLastModified(lua_State * L);
+	int w_readAsync(lua_State * L);
+	int w_writeAsync(lua_State * L);
+	int w_completeAsync(lua_State * L);
+	int w_getSyncStats(lua_State * L);
 	int loader(lua_State * L);
 	int extloader(lua_State * L);
 	extern "C" LOVE_EXPORT int luaopen_love_filesystem(lua_State * L);
@@ -36,6 +36,11 @@ namespace graphics
 	{
 	}
 
+	bool Image::deferDestruction() const
+	{
+		return !Volatile::isGraphicsThread();
+	}
+
 	bool Image::getConstant(const char * in, FilterMode & out)
 	{
 		return filterModes.find(in, out);
@@ -72,6 +72,11 @@ namespace graphics
 		static bool getConstant(const char * in, WrapMode & out);
 		static bool getConstant(WrapMode in, const char *& out);
 
+	protected:
+
+		// Implements Object.
+		bool deferDestruction() const;
+
 	private:
 
 		static StringMap<FilterMode, FILTER_MAX_ENUM>::Entry filterModeEntries[];
@@ -20,6 +20,9 @@
 
 #include "Volatile.h"
 
+// LOVE
+#include <thread/threads.h>
+
 namespace love
 {
 namespace graphics
@@ -27,6 +30,7 @@ namespace graphics
 
 	// Static members.
 	std::list<Volatile *> Volatile::all;
+	unsigned int Volatile::graphicsThread = 0;
 
 	Volatile::Volatile()
 	{
@@ -65,5 +69,15 @@ namespace graphics
 		}
 	}
 
+	void Volatile::setGraphicsThread()
+	{
+		graphicsThread = thread::ThreadBase::threadId();
+	}
+
+	bool Volatile::isGraphicsThread()
+	{
+		return graphicsThread == 0 || graphicsThread == thread::ThreadBase::threadId();
+	}
+
 } // graphics
 } // love
@@ -42,6 +42,9 @@ namespace graphics
 		// A list of all Volatile object currently alive.
 		static std::list<Volatile *> all;
 
+		// The thread which owns the graphics context, or 0.
+		static unsigned int graphicsThread;
+
 	public:
 
 		/**
@@ -84,6 +87,22 @@ namespace graphics
 		**/
 		static void unloadAll();
 
+		/**
+		* Makes the calling thread the one which owns the graphics
+		* context.
+		**/
+		static void setGraphicsThread();
+
+		/**
+		* Checks whether the calling thread owns the graphics context.
+		* Objects holding graphics resources (and the list of volatiles)
+		* may only be destroyed there; they use this to defer their
+		* destruction when released elsewhere.
+		*
+		* @return True if it does, or if no thread has been set.
+		**/
+		static bool isGraphicsThread();
+
 	}; // Volatile
 
 } // graphics
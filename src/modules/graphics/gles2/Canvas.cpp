@@ -68,6 +68,11 @@ namespace gles2
 		unloadVolatile();
 	}
 
+	bool Canvas::deferDestruction() const
+	{
+		return !Volatile::isGraphicsThread();
+	}
+
 	bool Canvas::isSupported()
 	{
 		return true;
@@ -80,6 +80,11 @@ namespace gles2
 
 		GLuint getTextureName() const { return img; }
 
+	protected:
+
+		// Implements Object.
+		bool deferDestruction() const;
+
 	private:
 		friend class PixelEffect;
 
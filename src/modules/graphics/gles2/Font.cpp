@@ -68,6 +68,11 @@ namespace gles2
 		unloadVolatile();
 	}
 
+	bool Font::deferDestruction() const
+	{
+		return !Volatile::isGraphicsThread();
+	}
+
 	void Font::createTexture()
 	{
 		texture_x = texture_y = rowHeight = TEXTURE_PADDING;
@@ -207,6 +207,11 @@ namespace gles2
 		int getDescent() const;
 		float getBaseline() const;
 
+	protected:
+
+		// Implements Object.
+		bool deferDestruction() const;
+
 	}; // Font
 
 } // gles2
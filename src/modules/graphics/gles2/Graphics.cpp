@@ -42,6 +42,7 @@ namespace gles2
 		: currentFont(0), currentImageFilter(), lineStyle(LINE_SMOOTH), lineWidth(1), matrixLimit(0), userMatrices(0)
 	{
 		currentWindow = (love::window::ppapi::Window*)love::window::ppapi::Window::getSingleton();
+		Volatile::setGraphicsThread();
 	}
 
 	Graphics::~Graphics()
@@ -49,6 +50,8 @@ namespace gles2
 		if (currentFont != 0)
 			currentFont->release();
 
+		Object::destroyDeferred();
+
 		currentWindow->release();
 	}
 
@@ -199,6 +202,9 @@ namespace gles2
 	void Graphics::present()
 	{
 		currentWindow->swapBuffers();
+
+		// Graphics objects last released on other threads.
+		Object::destroyDeferred();
 	}
 
 	void Graphics::setIcon(Image * image)
@@ -100,6 +100,11 @@ Shader::~Shader()
 	unloadVolatile();
 }
 
+bool Shader::deferDestruction() const
+{
+	return !Volatile::isGraphicsThread();
+}
+
 void Shader::checkCodeCompleteness()
 {
 	// Fill in any missing shader code using the default sources
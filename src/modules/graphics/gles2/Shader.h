@@ -146,6 +146,11 @@ public:
 	static std::string getGLSLVersion();
 	static bool isSupported();
 
+protected:
+
+	// Implements Object.
+	bool deferDestruction() const;
+
 private:
 
 	/**
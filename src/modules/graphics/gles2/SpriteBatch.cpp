@@ -91,6 +91,11 @@ namespace gles2
 		delete element_buf;
 	}
 
+	bool SpriteBatch::deferDestruction() const
+	{
+		return !Volatile::isGraphicsThread();
+	}
+
 	int SpriteBatch::add(float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky, int index /*= -1*/)
 	{
 		// Only do this if there's a free slot.
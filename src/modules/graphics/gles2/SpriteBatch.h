@@ -111,6 +111,11 @@ namespace gles2
 		static bool getConstant(const char * in, UsageHint & out);
 		static bool getConstant(UsageHint in, const char *& out);
 
+	protected:
+
+		// Implements Object.
+		bool deferDestruction() const;
+
 	private:
 
 		void addv(const vertex * v, int index);
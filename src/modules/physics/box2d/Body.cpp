@@ -44,7 +44,8 @@ namespace box2d
 		// Box2D body holds a reference to the love Body.
 		this->retain();
 		this->setType(type);
-		Memoizer::add(body, this);
+		body->SetUserData(this);
+		savePreviousTransform();
 	}
 
 	Body::Body(b2Body * b)
@@ -54,7 +55,8 @@ namespace box2d
 		world->retain();
 		// Box2D body holds a reference to the love Body.
 		this->retain();
-		Memoizer::add(body, this);
+		body->SetUserData(this);
+		savePreviousTransform();
 	}
 
 	Body::~Body()
@@ -80,6 +82,26 @@ namespace box2d
 		y_o = v.y;
 	}
 
+	void Body::getInterpolatedPosition(float & x_o, float & y_o)
+	{
+		float alpha = world->getInterpolationAlpha();
+		b2Vec2 v = Physics::scaleUp(previousPosition + alpha * (body->GetPosition() - previousPosition));
+		x_o = v.x;
+		y_o = v.y;
+	}
+
+	float Body::getInterpolatedAngle()
+	{
+		float alpha = world->getInterpolationAlpha();
+		return previousAngle + alpha * (body->GetAngle() - previousAngle);
+	}
+
+	void Body::savePreviousTransform()
+	{
+		previousPosition = body->GetPosition();
+		previousAngle = body->GetAngle();
+	}
+
 	void Body::getLinearVelocity(float & x_o, float & y_o)
 	{
 		b2Vec2 v = Physics::scaleUp(body->GetLinearVelocity());
@@ -202,11 +224,13 @@ namespace box2d
 	void Body::setX(float x)
 	{
 		body->SetTransform(Physics::scaleDown(b2Vec2(x, getY())), getAngle());
+		savePreviousTransform();
 	}
 
 	void Body::setY(float y)
 	{
 		body->SetTransform(Physics::scaleDown(b2Vec2(getX(), y)), getAngle());
+		savePreviousTransform();
 	}
 
 	void Body::setLinearVelocity(float x, float y)
@@ -217,6 +241,7 @@ namespace box2d
 	void Body::setAngle(float d)
 	{
 		body->SetTransform(body->GetPosition(), d);
+		savePreviousTransform();
 	}
 
 	void Body::setAngularVelocity(float r)
@@ -227,6 +252,7 @@ namespace box2d
 	void Body::setPosition(float x, float y)
 	{
 		body->SetTransform(Physics::scaleDown(b2Vec2(x, y)), body->GetAngle());
+		savePreviousTransform();
 	}
 
 	void Body::setAngularDamping(float d)
@@ -422,11 +448,8 @@ namespace box2d
 		do {
 			if (!f)
 				break;
-			Fixture * fixture = (Fixture *)Memoizer::find(f);
-			if (!fixture)
-				throw love::Exception("A fixture has escaped Memoizer!");
-			fixture->retain();
-			luax_newtype(L, "Fixture", PHYSICS_FIXTURE_T, (void*)fixture);
+			Fixture * fixture = ((fixtureudata *)f->GetUserData())->fixture;
+			luax_pushtype(L, "Fixture", PHYSICS_FIXTURE_T, fixture);
 			lua_rawseti(L, -2, i);
 			i++;
 		} while ((f = f->GetNext()));
@@ -450,7 +473,7 @@ namespace box2d
 
 	void Body::destroy()
 	{
-		if (world->world->IsLocked())
+		if (world->isLocked())
 		{
 			// Called during time step. Save reference for destruction afterwards.
 			this->retain();
@@ -459,7 +482,6 @@ namespace box2d
 		}
 
 		world->world->DestroyBody(body);
-		Memoizer::remove(body);
 		body = NULL;
 
 		// Box2D body destroyed. Release its reference to the love Body.
@@ -68,6 +68,11 @@ namespace box2d
 		// once all bodies have been destroyed too.
 		World * world;
 
+		// The transform before the last time step, for
+		// interpolation. See World::setInterpolation.
+		b2Vec2 previousPosition;
+		float previousAngle;
+
 	public:
 
 		// The Box2D body. (Should not be public?)
@@ -106,6 +111,25 @@ namespace box2d
 		**/
 		void getPosition(float & x_o, float & y_o);
 
+		/**
+		* Gets the position of the Body between the last two
+		* time steps of its World, when it interpolates.
+		* @returns The interpolated position.
+		**/
+		void getInterpolatedPosition(float & x_o, float & y_o);
+
+		/**
+		* Gets the angle of the Body between the last two
+		* time steps of its World, when it interpolates.
+		**/
+		float getInterpolatedAngle();
+
+		/**
+		* Saves the current transform as the one before
+		* the next time step.
+		**/
+		void savePreviousTransform();
+
 		/**
 		* Gets the velocity in the current center of mass.
 		* @returns The velocity in the current center of mass.
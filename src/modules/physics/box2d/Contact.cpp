@@ -22,8 +22,6 @@
 #include "World.h"
 #include "Physics.h"
 
-#include <common/Memoizer.h>
-
 namespace love
 {
 namespace physics
@@ -33,12 +31,18 @@ namespace box2d
 	Contact::Contact(b2Contact * contact)
 		: contact(contact)
 	{
-		Memoizer::add(contact, this);
+		contact->SetUserData(this);
 	}
 
 	Contact::~Contact()
 	{
-		Memoizer::remove(contact);
+		if (contact != 0)
+			contact->SetUserData(0);
+	}
+
+	bool Contact::isValid() const
+	{
+		return contact != 0;
 	}
 
 	int Contact::getPositions(lua_State * L)
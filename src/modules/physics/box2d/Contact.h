@@ -55,15 +55,21 @@ namespace box2d
 	public:
 
 		/**
-		* Creates a new Contact by copying a Box2D contact
-		* point. It does not store the pointer, but copy the
-		* data pointed to.
-		* @param point Pointer to the Box2D contact.
+		* Creates a new Contact wrapping a Box2D contact.
+		* The Contact is stored in the user data of the
+		* Box2D contact, and is invalidated when Box2D
+		* destroys it.
+		* @param contact Pointer to the Box2D contact.
 		**/
 		Contact(b2Contact * contact);
 
 		virtual ~Contact();
 
+		/**
+		* Returns true if the Box2D contact still exists.
+		**/
+		bool isValid() const;
+
 		/**
 		* Gets the position of each point of contact.
 		* @return The position along the x-axis.
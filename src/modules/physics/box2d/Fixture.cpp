@@ -25,7 +25,8 @@
 #include "World.h"
 #include "Physics.h"
 
-#include <common/Memoizer.h>
+// LOVE
+#include <graphics/gles2/Quad.h>
 
 // STD
 #include <bitset>
@@ -41,30 +42,35 @@ namespace box2d
 	{
 		data = new fixtureudata();
 		data->ref = 0;
+		data->fixture = this;
+		data->sprite = -1;
+		data->spriteOx = data->spriteOy = 0.0f;
+		data->spriteQuad = 0;
 		b2FixtureDef def;
 		def.shape = shape->shape;
 		def.userData = (void *)data;
 		def.density = density;
 		fixture = body->body->CreateFixture(&def);
 		this->retain();
-		Memoizer::add(fixture, this);
 	}
 
 	Fixture::Fixture(b2Fixture * f)
 		: fixture(f)
 	{
 		data = (fixtureudata *)f->GetUserData();
-		body = (Body *)Memoizer::find(f->GetBody());
+		data->fixture = this;
+		body = (Body *)f->GetBody()->GetUserData();
 		if (!body)
 			body = new Body(f->GetBody());
 		this->retain();
-		Memoizer::add(fixture, this);
 	}
 
 	Fixture::~Fixture()
 	{
 		if (data->ref != 0)
 			delete data->ref;
+		if (data->spriteQuad != 0)
+			data->spriteQuad->release();
 
 		delete data;
 		data = NULL;
@@ -249,6 +255,37 @@ namespace box2d
 		return 1;
 	}
 
+	void Fixture::setSprite(int index, float ox, float oy, love::graphics::gles2::Quad * quad)
+	{
+		if (quad)
+			quad->retain();
+		if (data->spriteQuad)
+			data->spriteQuad->release();
+
+		data->sprite = index;
+		data->spriteOx = ox;
+		data->spriteOy = oy;
+		data->spriteQuad = quad;
+	}
+
+	int Fixture::getSprite(lua_State * L)
+	{
+		if (data->sprite < 0)
+		{
+			lua_pushnil(L);
+			return 1;
+		}
+
+		lua_pushinteger(L, data->sprite);
+		lua_pushnumber(L, data->spriteOx);
+		lua_pushnumber(L, data->spriteOy);
+		if (data->spriteQuad)
+			luax_pushtype(L, "Quad", GRAPHICS_QUAD_T, data->spriteQuad);
+		else
+			lua_pushnil(L);
+		return 4;
+	}
+
 	bool Fixture::testPoint(float x, float y) const
 	{
 		return fixture->TestPoint(Physics::scaleDown(b2Vec2(x, y)));
@@ -301,7 +338,7 @@ namespace box2d
 
 	void Fixture::destroy(bool implicit)
 	{
-		if (body->world->world->IsLocked())
+		if (body->world->isLocked())
 		{
 			// Called during time step. Save reference for destruction afterwards.
 			this->retain();
@@ -311,7 +348,6 @@ namespace box2d
 
 		if (!implicit && fixture != 0)
 			body->body->DestroyFixture(fixture);
-		Memoizer::remove(fixture);
 		fixture = NULL;
 
 		// Box2D fixture destroyed. Release its reference to the love Fixture.
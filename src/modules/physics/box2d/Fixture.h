@@ -33,20 +33,39 @@
 
 namespace love
 {
+namespace graphics
+{
+namespace gles2
+{
+	class Quad;
+} // gles2
+} // graphics
+
 namespace physics
 {
 namespace box2d
 {
+	class Fixture;
+
 	/**
 	* This struct is stored in a void pointer
-	* in the Box2D Fixture class. For now, all we
-	* need is a Lua reference to arbitrary data,
-	* but we might need more later.
+	* in the Box2D Fixture class. It holds a Lua
+	* reference to arbitrary data, and the love
+	* Fixture which owns the Box2D Fixture.
 	**/
 	struct fixtureudata
 	{
 		// Reference to arbitrary data.
 		Reference * ref;
+
+		// The love Fixture.
+		Fixture * fixture;
+
+		// The sprite which World::getBodyStates moves with
+		// this Fixture (-1 for none), its origin and Quad.
+		int sprite;
+		float spriteOx, spriteOy;
+		love::graphics::gles2::Quad * spriteQuad;
 	};
 
 	/**
@@ -141,6 +160,23 @@ namespace box2d
 		**/
 		int getUserData(lua_State * L);
 
+		/**
+		* Sets the sprite of a SpriteBatch which is moved
+		* with the Body of this Fixture.
+		* @param index The index of the sprite, or -1 for none. With
+		* a Quad, the sprite must already be in the SpriteBatch.
+		* @param ox The origin of the sprite (x-component).
+		* @param oy The origin of the sprite (y-component).
+		* @param quad The Quad of the sprite, or NULL for the whole Image.
+		* @see World::getBodyStates
+		**/
+		void setSprite(int index, float ox, float oy, love::graphics::gles2::Quad * quad);
+
+		/**
+		* Gets the sprite index (nil if none), origin and Quad.
+		**/
+		int getSprite(lua_State * L);
+
 		/**
 		* Sets the friction of the Fixture.
 		* @param friction The new friction.
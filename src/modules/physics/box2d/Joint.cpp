@@ -23,9 +23,6 @@
 // STD
 #include <bitset>
 
-// LOVE
-#include <common/Memoizer.h>
-
 // Module
 #include "Body.h"
 #include "World.h"
@@ -112,7 +109,7 @@ namespace box2d
 	b2Joint * Joint::createJoint(b2JointDef * def)
 	{
 		joint = world->world->CreateJoint(def);
-		Memoizer::add(joint, this);
+		joint->SetUserData(this);
 		// Box2D joint has a reference to this love Joint.
 		this->retain();
 		return joint;
@@ -120,7 +117,7 @@ namespace box2d
 
 	void Joint::destroyJoint(bool implicit)
 	{
-		if (world->world->IsLocked())
+		if (world->isLocked())
 		{
 			// Called during time step. Save reference for destruction afterwards.
 			this->retain();
@@ -130,7 +127,6 @@ namespace box2d
 
 		if (!implicit && joint != 0)
 			world->world->DestroyJoint(joint);
-		Memoizer::remove(joint);
 		joint = NULL;
 		// Release the reference of the Box2D joint.
 		this->release();
@@ -26,6 +26,16 @@
 #include "Physics.h"
 #include <common/Memoizer.h>
 #include <common/Reference.h>
+#include <common/atomic.h>
+
+#include <thread/JobSystem.h>
+
+#include <graphics/gles2/SpriteBatch.h>
+#include <graphics/gles2/Quad.h>
+
+// STD
+#include <cmath>
+#include <string>
 
 namespace love
 {
@@ -33,7 +43,6 @@ namespace physics
 {
 namespace box2d
 {
-
 	World::ContactCallback::ContactCallback()
 		: ref(0)
 	{
@@ -53,33 +62,21 @@ namespace box2d
 			lua_State * L = ref->getL();
 			ref->push();
 
-			// Push first fixture.
-			{
-				Fixture * a = (Fixture *)Memoizer::find(contact->GetFixtureA());
-				if (a != 0)
-				{
-					a->retain();
-					luax_newtype(L, "Fixture", PHYSICS_FIXTURE_T, (void*)a);
-				}
-				else
-					throw love::Exception("A fixture has escaped Memoizer!");
-			}
-
-			// Push second fixture.
-			{
-				Fixture * b = (Fixture *)Memoizer::find(contact->GetFixtureB());
-				if (b != 0)
-				{
-					b->retain();
-					luax_newtype(L, "Fixture", PHYSICS_FIXTURE_T, (void*)b);
-				}
-				else
-					throw love::Exception("A fixture has escaped Memoizer!");
-			}
-
-			Contact * c = new Contact(contact);
-
-			luax_newtype(L, "Contact", (PHYSICS_CONTACT_T), (void*)c);
+			// Push both fixtures.
+			fixtureudata * a = (fixtureudata *)contact->GetFixtureA()->GetUserData();
+			luax_pushtype(L, "Fixture", PHYSICS_FIXTURE_T, a->fixture);
+			fixtureudata * b = (fixtureudata *)contact->GetFixtureB()->GetUserData();
+			luax_pushtype(L, "Fixture", PHYSICS_FIXTURE_T, b->fixture);
+
+			// The same b2Contact is reported every step while it is
+			// touching, so its wrapper (and Lua value) is reused.
+			Contact * c = (Contact *)contact->GetUserData();
+			if (c == 0)
+				c = new Contact(contact);
+			else
+				c->retain();
+			luax_pushtype(L, "Contact", PHYSICS_CONTACT_T, c);
+			c->release();
 
 			int args = 3;
 			if (impulse)
@@ -129,8 +126,8 @@ namespace box2d
 		{
 			lua_State * L = ref->getL();
 			ref->push();
-			luax_newtype(L, "Fixture", PHYSICS_FIXTURE_T, (void*)a);
-			luax_newtype(L, "Fixture", PHYSICS_FIXTURE_T, (void*)b);
+			luax_pushtype(L, "Fixture", PHYSICS_FIXTURE_T, a);
+			luax_pushtype(L, "Fixture", PHYSICS_FIXTURE_T, b);
 			lua_call(L, 2, 1);
 			return luax_toboolean(L, -1);
 		}
@@ -154,11 +151,8 @@ namespace box2d
 		{
 			lua_State * L = ref->getL();
 			ref->push();
-			Fixture * f = (Fixture *)Memoizer::find(fixture);
-			if (!f)
-				throw love::Exception("A fixture has escaped Memoizer!");
-			f->retain();
-			luax_newtype(L, "Fixture", PHYSICS_FIXTURE_T, (void*)f);
+			Fixture * f = ((fixtureudata *)fixture->GetUserData())->fixture;
+			luax_pushtype(L, "Fixture", PHYSICS_FIXTURE_T, f);
 			lua_call(L, 1, 1);
 			return luax_toboolean(L, -1);
 		}
@@ -182,11 +176,8 @@ namespace box2d
 		{
 			lua_State * L = ref->getL();
 			ref->push();
-			Fixture * f = (Fixture *)Memoizer::find(fixture);
-			if (!f)
-				throw love::Exception("A fixture has escaped Memoizer!");
-			f->retain();
-			luax_newtype(L, "Fixture", PHYSICS_FIXTURE_T, (void*)f);
+			Fixture * f = ((fixtureudata *)fixture->GetUserData())->fixture;
+			luax_pushtype(L, "Fixture", PHYSICS_FIXTURE_T, f);
 			b2Vec2 scaledPoint = Physics::scaleUp(point);
 			lua_pushnumber(L, scaledPoint.x);
 			lua_pushnumber(L, scaledPoint.y);
@@ -204,20 +195,79 @@ namespace box2d
 
 	void World::SayGoodbye(b2Fixture* fixture)
 	{
-		Fixture * f = (Fixture *)Memoizer::find(fixture);
+		fixtureudata * data = (fixtureudata *)fixture->GetUserData();
 		// Hint implicit destruction with true.
-		if (f) f->destroy(true);
+		if (data && data->fixture) data->fixture->destroy(true);
 	}
 
 	void World::SayGoodbye(b2Joint* joint)
 	{
-		Joint * j = (Joint *)Memoizer::find(joint);
+		Joint * j = (Joint *)joint->GetUserData();
 		// Hint implicit destruction with true.
 		if (j) j->destroyJoint(true);
 	}
 
+	namespace
+	{
+		struct TaskRanges
+		{
+			thread::JobSystem * jobs;
+			b2TaskRunner::Task task;
+			void * data;
+			volatile int failed;
+			std::string error;
+		};
+
+		void runTaskRange(void * data, int first, int last)
+		{
+			TaskRanges * r = (TaskRanges *) data;
+			try
+			{
+				r->task(r->data, r->jobs->getWorkerIndex(), first, last);
+			}
+			catch (love::Exception & e)
+			{
+				// Jobs must not throw, so keep the first error for
+				// ParallelFor.
+				if (atomicCompareAndSwap(&r->failed, 0, 1))
+					r->error = e.what();
+			}
+		}
+	}
+
+	World::TaskRunner::TaskRunner()
+		: jobs(0)
+	{
+	}
+
+	World::TaskRunner::~TaskRunner()
+	{
+		if (jobs)
+			jobs->release();
+	}
+
+	int32 World::TaskRunner::GetThreadCount() const
+	{
+		return jobs ? jobs->getWorkerCount() + 1 : 1;
+	}
+
+	void World::TaskRunner::ParallelFor(int32 count, Task task, void * data)
+	{
+		TaskRanges r;
+		r.jobs = jobs;
+		r.task = task;
+		r.data = data;
+		r.failed = 0;
+		jobs->parallelFor(count, 0, runTaskRange, &r);
+
+		if (r.failed)
+			throw love::Exception("%s", r.error.c_str());
+	}
+
 	World::World()
-		: world(NULL), destructWorld(false)
+		: world(NULL), destructWorld(false), velocityIterations(8), positionIterations(6)
+		, fixedStep(0.0f), maxSteps(8), accumulator(0.0f), interpolate(false)
+		, bufferContacts(false), delivering(false), callbackFailed(false)
 	{
 		world = new b2World(b2Vec2(0,0));
 		this->retain(); // The Box2D world holds a reference to this World.
@@ -231,7 +281,9 @@ namespace box2d
 	}
 
 	World::World(b2Vec2 gravity, bool sleep)
-		: world(NULL), destructWorld(false)
+		: world(NULL), destructWorld(false), velocityIterations(8), positionIterations(6)
+		, fixedStep(0.0f), maxSteps(8), accumulator(0.0f), interpolate(false)
+		, bufferContacts(false), delivering(false), callbackFailed(false)
 	{
 		world = new b2World(Physics::scaleDown(gravity));
 		// The Box2D world holds a reference to this World.
@@ -249,9 +301,67 @@ namespace box2d
 	{
 	}
 
-	void World::update(float dt)
+	int World::update(float dt)
 	{
-		world->Step(dt, 8, 6);
+		if (delivering)
+			throw love::Exception("World:update can not be called from a contact callback.");
+
+		// getContactEvents returns the events of every step of this update.
+		clearContactEvents(deliveredEvents);
+		callbackFailed = false;
+		callbackError.clear();
+
+		if (fixedStep <= 0.0f)
+		{
+			step(dt);
+			return 1;
+		}
+
+		accumulator += dt;
+		int steps = 0;
+		while (accumulator >= fixedStep && steps < maxSteps && isValid())
+		{
+			step(fixedStep);
+			accumulator -= fixedStep;
+			steps++;
+
+			// The error is passed on once this update returns.
+			if (callbackFailed)
+				break;
+		}
+
+		// Drop the steps there was no time for, rather than fall
+		// further behind with every update.
+		if (accumulator >= fixedStep)
+			accumulator = fmodf(accumulator, fixedStep);
+
+		return steps;
+	}
+
+	bool World::takeCallbackError(std::string & error)
+	{
+		if (!callbackFailed)
+			return false;
+
+		error.swap(callbackError);
+		callbackError.clear();
+		callbackFailed = false;
+		return true;
+	}
+
+	void World::step(float dt)
+	{
+		if (interpolate && fixedStep > 0.0f)
+		{
+			for (b2Body * b = world->GetBodyList(); b; b = b->GetNext())
+			{
+				if (b != groundBody && b->GetType() != b2_staticBody)
+					((Body *)b->GetUserData())->savePreviousTransform();
+			}
+		}
+
+		world->Step(dt, velocityIterations, positionIterations);
+		flushContactEvents();
 
 		// Destroy all objects marked during the time step.
 		for (std::vector<Body*>::iterator i = destructBodies.begin(); i < destructBodies.end(); i++)
@@ -283,14 +393,152 @@ namespace box2d
 			destroy();
 	}
 
+	void World::recordContactEvent(ContactEventType type, b2Contact * contact, const b2ContactImpulse * impulse)
+	{
+		ContactEvent e;
+		e.type = type;
+		e.a = ((fixtureudata *)contact->GetFixtureA()->GetUserData())->fixture;
+		e.b = ((fixtureudata *)contact->GetFixtureB()->GetUserData())->fixture;
+		e.a->retain();
+		e.b->retain();
+
+		e.points = contact->GetManifold()->pointCount;
+		e.normal.SetZero();
+		if (e.points > 0)
+		{
+			b2WorldManifold manifold;
+			contact->GetWorldManifold(&manifold);
+			e.normal = manifold.normal;
+			for (int i = 0; i < e.points; i++)
+			{
+				e.positions[i] = manifold.points[i];
+				e.normalImpulses[i] = impulse ? impulse->normalImpulses[i] : 0.0f;
+				e.tangentImpulses[i] = impulse ? impulse->tangentImpulses[i] : 0.0f;
+			}
+		}
+
+		pendingEvents.push_back(e);
+	}
+
+	void World::flushContactEvents()
+	{
+		// The references of the events move along with them.
+		size_t first = deliveredEvents.size();
+		deliveredEvents.insert(deliveredEvents.end(), pendingEvents.begin(), pendingEvents.end());
+		pendingEvents.clear();
+
+		Reference * ref = begin.ref ? begin.ref : (end.ref ? end.ref : postsolve.ref);
+		if (deliveredEvents.size() == first || ref == 0)
+			return;
+
+		// Bodies, Fixtures and Joints destroyed by the callbacks are
+		// destroyed after the last one, like during the time step.
+		delivering = true;
+
+		lua_State * L = ref->getL();
+		lua_createtable(L, 0, 14);
+		int event = lua_gettop(L);
+
+		// The callbacks get the events of this step only.
+		for (size_t i = first; i < deliveredEvents.size(); i++)
+		{
+			const ContactEvent & e = deliveredEvents[i];
+			ContactCallback & callback = e.type == CONTACT_BEGIN ? begin : (e.type == CONTACT_END ? end : postsolve);
+			if (callback.ref == 0)
+				continue;
+
+			callback.ref->push();
+			luax_pushtype(L, "Fixture", PHYSICS_FIXTURE_T, e.a);
+			luax_pushtype(L, "Fixture", PHYSICS_FIXTURE_T, e.b);
+			setContactEventFields(L, event, e);
+			lua_pushvalue(L, event);
+			if (lua_pcall(L, 3, 0, 0) != 0)
+			{
+				// Keep the error for the caller of update, and skip the
+				// rest of the events, so the step can finish.
+				const char * error = lua_tostring(L, -1);
+				callbackError = error ? error : "Error in a contact callback.";
+				callbackFailed = true;
+				lua_pop(L, 1);
+				break;
+			}
+		}
+
+		lua_pop(L, 1);
+		delivering = false;
+	}
+
+	void World::clearContactEvents(std::vector<ContactEvent> & events)
+	{
+		for (size_t i = 0; i < events.size(); i++)
+		{
+			events[i].a->release();
+			events[i].b->release();
+		}
+		events.clear();
+	}
+
+	void World::setContactEventFields(lua_State * L, int idx, const ContactEvent & e)
+	{
+		static const char * types[] = { "begin", "end", "postsolve" };
+		static const char * xs[] = { "x1", "x2" };
+		static const char * ys[] = { "y1", "y2" };
+		static const char * normalImpulses[] = { "normalImpulse1", "normalImpulse2" };
+		static const char * tangentImpulses[] = { "tangentImpulse1", "tangentImpulse2" };
+
+		lua_pushstring(L, types[e.type]);
+		lua_setfield(L, idx, "type");
+		luax_pushtype(L, "Fixture", PHYSICS_FIXTURE_T, e.a);
+		lua_setfield(L, idx, "fixtureA");
+		luax_pushtype(L, "Fixture", PHYSICS_FIXTURE_T, e.b);
+		lua_setfield(L, idx, "fixtureB");
+		lua_pushnumber(L, e.normal.x);
+		lua_setfield(L, idx, "normalX");
+		lua_pushnumber(L, e.normal.y);
+		lua_setfield(L, idx, "normalY");
+		lua_pushinteger(L, e.points);
+		lua_setfield(L, idx, "points");
+
+		// Fields for missing points are cleared, as the table may
+		// have held another event.
+		for (int i = 0; i < b2_maxManifoldPoints; i++)
+		{
+			bool point = i < e.points;
+			bool impulse = point && e.type == CONTACT_POSTSOLVE;
+			b2Vec2 position = Physics::scaleUp(e.positions[i]);
+			point ? lua_pushnumber(L, position.x) : lua_pushnil(L);
+			lua_setfield(L, idx, xs[i]);
+			point ? lua_pushnumber(L, position.y) : lua_pushnil(L);
+			lua_setfield(L, idx, ys[i]);
+			impulse ? lua_pushnumber(L, Physics::scaleUp(e.normalImpulses[i])) : lua_pushnil(L);
+			lua_setfield(L, idx, normalImpulses[i]);
+			impulse ? lua_pushnumber(L, Physics::scaleUp(e.tangentImpulses[i])) : lua_pushnil(L);
+			lua_setfield(L, idx, tangentImpulses[i]);
+		}
+	}
+
 	void World::BeginContact(b2Contact* contact)
 	{
-		begin.process(contact);
+		if (bufferContacts)
+			recordContactEvent(CONTACT_BEGIN, contact);
+		else
+			begin.process(contact);
 	}
 
 	void World::EndContact(b2Contact* contact)
 	{
-		end.process(contact);
+		if (bufferContacts)
+			recordContactEvent(CONTACT_END, contact);
+		else
+			end.process(contact);
+	}
+
+	void World::DestroyContact(b2Contact* contact)
+	{
+		// The Lua side may still hold the Contact, so it outlives the
+		// Box2D contact.
+		Contact * c = (Contact *)contact->GetUserData();
+		if (c) c->contact = 0;
 	}
 
 	void World::PreSolve(b2Contact* contact, const b2Manifold* oldManifold)
@@ -301,20 +549,16 @@ namespace box2d
 
 	void World::PostSolve(b2Contact* contact, const b2ContactImpulse* impulse)
 	{
-		postsolve.process(contact, impulse);
+		if (bufferContacts)
+			recordContactEvent(CONTACT_POSTSOLVE, contact, impulse);
+		else
+			postsolve.process(contact, impulse);
 	}
 
 	bool World::ShouldCollide(b2Fixture * fixtureA, b2Fixture * fixtureB)
 	{
-		// Fixtures should be memoized, if we created them
-		Fixture * a = (Fixture *)Memoizer::find(fixtureA);
-		if (!a)
-			throw love::Exception("A fixture has escaped Memoizer!");
-		a->retain();
-		Fixture * b = (Fixture *)Memoizer::find(fixtureB);
-		if (!b)
-			throw love::Exception("A fixture has escaped Memoizer!");
-		b->retain();
+		Fixture * a = ((fixtureudata *)fixtureA->GetUserData())->fixture;
+		Fixture * b = ((fixtureudata *)fixtureB->GetUserData())->fixture;
 		return filter.process(a, b);
 	}
 
@@ -360,6 +604,135 @@ namespace box2d
 		return 4;
 	}
 
+	void World::setIterations(int velocity, int position)
+	{
+		if (velocity < 1 || position < 1)
+			throw love::Exception("The number of iterations must be at least 1.");
+
+		velocityIterations = velocity;
+		positionIterations = position;
+	}
+
+	void World::getIterations(int & velocity_o, int & position_o) const
+	{
+		velocity_o = velocityIterations;
+		position_o = positionIterations;
+	}
+
+	void World::setFixedTimestep(float step, int maxSteps)
+	{
+		if (step < 0.0f)
+			throw love::Exception("The time step must not be negative.");
+		if (maxSteps < 1)
+			throw love::Exception("The maximum number of steps must be at least 1.");
+
+		fixedStep = step;
+		this->maxSteps = maxSteps;
+		accumulator = 0.0f;
+	}
+
+	void World::getFixedTimestep(float & step_o, int & maxSteps_o) const
+	{
+		step_o = fixedStep;
+		maxSteps_o = maxSteps;
+	}
+
+	void World::setInterpolation(bool interpolate)
+	{
+		this->interpolate = interpolate;
+	}
+
+	bool World::getInterpolation() const
+	{
+		return interpolate;
+	}
+
+	float World::getInterpolationAlpha() const
+	{
+		if (!interpolate || fixedStep <= 0.0f)
+			return 1.0f;
+		return accumulator / fixedStep;
+	}
+
+	void World::setThreaded(bool threaded)
+	{
+		if (world->IsLocked())
+			throw love::Exception("World:setThreaded can not be called during a time step.");
+
+		if (threaded == getThreaded())
+			return;
+
+		if (threaded)
+		{
+			taskRunner.jobs = thread::JobSystem::acquire();
+			world->SetTaskRunner(&taskRunner);
+		}
+		else
+		{
+			world->SetTaskRunner(NULL);
+			taskRunner.jobs->release();
+			taskRunner.jobs = 0;
+		}
+	}
+
+	bool World::getThreaded() const
+	{
+		return taskRunner.jobs != 0;
+	}
+
+	void World::setContactBuffering(bool buffer)
+	{
+		bufferContacts = buffer;
+		if (!buffer)
+			clearContactEvents(pendingEvents);
+	}
+
+	bool World::getContactBuffering() const
+	{
+		return bufferContacts;
+	}
+
+	int World::getContactEvents(lua_State * L)
+	{
+		if (lua_istable(L, 1))
+			lua_settop(L, 1);
+		else
+		{
+			lua_settop(L, 0);
+			lua_createtable(L, (int)deliveredEvents.size(), 0);
+		}
+
+		int n = (int)deliveredEvents.size();
+		for (int i = 0; i < n; i++)
+		{
+			lua_rawgeti(L, 1, i+1);
+			if (!lua_istable(L, -1))
+			{
+				lua_pop(L, 1);
+				lua_createtable(L, 0, 14);
+				lua_pushvalue(L, -1);
+				lua_rawseti(L, 1, i+1);
+			}
+			setContactEventFields(L, lua_gettop(L), deliveredEvents[i]);
+			lua_pop(L, 1);
+		}
+
+		// Clear what is left of a reused array.
+		for (int i = n+1; ; i++)
+		{
+			lua_rawgeti(L, 1, i);
+			bool empty = lua_isnil(L, -1);
+			lua_pop(L, 1);
+			if (empty)
+				break;
+			lua_pushnil(L);
+			lua_rawseti(L, 1, i);
+		}
+
+		lua_pushinteger(L, n);
+		return 2;
+	}
+
 	int World::setContactFilter(lua_State * L)
 	{
 		luax_assert_argc(L, 1);
@@ -400,7 +773,7 @@ namespace box2d
 
 	bool World::isLocked() const
 	{
-		return world->IsLocked();
+		return world->IsLocked() || delivering;
 	}
 
 	int World::getBodyCount() const
@@ -428,17 +801,114 @@ namespace box2d
 				break;
 			if (b == groundBody)
 				continue;
-			Body * body = (Body *)Memoizer::find(b);
-			if (!body)
-				throw love::Exception("A body has escaped Memoizer!");
-			body->retain();
-			luax_newtype(L, "Body", PHYSICS_BODY_T, (void*)body);
+			Body * body = (Body *)b->GetUserData();
+			luax_pushtype(L, "Body", PHYSICS_BODY_T, body);
 			lua_rawseti(L, -2, i);
 			i++;
 		} while ((b = b->GetNext()));
 		return 1;
 	}
 
+	int World::getBodyStates(lua_State * L)
+	{
+		if (luax_istype(L, 1, GRAPHICS_SPRITE_BATCH_T))
+		{
+			love::graphics::gles2::SpriteBatch * batch;
+			batch = luax_totype<love::graphics::gles2::SpriteBatch>(L, 1, "SpriteBatch", GRAPHICS_SPRITE_BATCH_T);
+			int sprites = 0;
+			for (b2Body * b = world->GetBodyList(); b; b = b->GetNext())
+			{
+				if (b == groundBody)
+					continue;
+
+				Body * body = (Body *)b->GetUserData();
+				float x, y;
+				body->getInterpolatedPosition(x, y);
+				float a = body->getInterpolatedAngle();
+
+				for (b2Fixture * f = b->GetFixtureList(); f; f = f->GetNext())
+				{
+					fixtureudata * data = (fixtureudata *)f->GetUserData();
+					if (data->sprite < 0)
+						continue;
+					int index;
+					if (data->spriteQuad)
+						index = batch->addq(data->spriteQuad, x, y, a, 1, 1, data->spriteOx, data->spriteOy, 0, 0, data->sprite);
+					else
+						index = batch->add(x, y, a, 1, 1, data->spriteOx, data->spriteOy, 0, 0, data->sprite);
+					if (index >= 0)
+						sprites++;
+				}
+			}
+			lua_pushinteger(L, sprites);
+			return 1;
+		}
+
+		bool velocity = luax_toboolean(L, 2);
+		if (lua_istable(L, 1))
+			lua_settop(L, 1);
+		else
+		{
+			lua_settop(L, 0);
+			lua_createtable(L, world->GetBodyCount() * (velocity ? 6 : 4), 0);
+		}
+
+		int i = 1;
+		int bodies = 0;
+		for (b2Body * b = world->GetBodyList(); b; b = b->GetNext())
+		{
+			if (b == groundBody || b->GetType() == b2_staticBody || !b->IsAwake())
+				continue;
+
+			Body * body = (Body *)b->GetUserData();
+			float x, y;
+			body->getInterpolatedPosition(x, y);
+
+			// The order of the bodies rarely changes, so a reused
+			// array usually has this Body here already.
+			lua_rawgeti(L, 1, i);
+			bool same = luax_istype(L, -1, PHYSICS_BODY_T) && ((Proxy *)lua_touserdata(L, -1))->data == body;
+			lua_pop(L, 1);
+			if (!same)
+			{
+				luax_pushtype(L, "Body", PHYSICS_BODY_T, body);
+				lua_rawseti(L, 1, i);
+			}
+			i++;
+
+			lua_pushnumber(L, x);
+			lua_rawseti(L, 1, i++);
+			lua_pushnumber(L, y);
+			lua_rawseti(L, 1, i++);
+			lua_pushnumber(L, body->getInterpolatedAngle());
+			lua_rawseti(L, 1, i++);
+			if (velocity)
+			{
+				b2Vec2 v = Physics::scaleUp(b->GetLinearVelocity());
+				lua_pushnumber(L, v.x);
+				lua_rawseti(L, 1, i++);
+				lua_pushnumber(L, v.y);
+				lua_rawseti(L, 1, i++);
+			}
+			bodies++;
+		}
+
+		// Clear what is left of a reused array.
+		for (;; i++)
+		{
+			lua_rawgeti(L, 1, i);
+			bool empty = lua_isnil(L, -1);
+			lua_pop(L, 1);
+			if (empty)
+				break;
+			lua_pushnil(L);
+			lua_rawseti(L, 1, i);
+		}
+
+		lua_pushinteger(L, bodies);
+		return 2;
+	}
+
 	int World::getJointList(lua_State * L) const
 	{
 		lua_newtable(L);
@@ -446,8 +916,7 @@ namespace box2d
 		int i = 1;
 		do {
 			if (!j) break;
-			Joint * joint = (Joint *)Memoizer::find(j);
-			if (!joint) throw love::Exception("A joint has escaped Memoizer!");
+			Joint * joint = (Joint *)j->GetUserData();
 			joint->retain();
 			luax_newtype(L, "Joint", PHYSICS_JOINT_T, (void*)joint);
 			lua_rawseti(L, -2, i);
@@ -463,10 +932,13 @@ namespace box2d
 		int i = 1;
 		do {
 			if (!c) break;
-			Contact * contact = (Contact *)Memoizer::find(c);
-			if (!contact) throw love::Exception("A contact has escaped Memoizer!");
-			contact->retain();
-			luax_newtype(L, "Contact", PHYSICS_CONTACT_T, (void*)contact);
+			Contact * contact = (Contact *)c->GetUserData();
+			if (contact == 0)
+				contact = new Contact(c);
+			else
+				contact->retain();
+			luax_pushtype(L, "Contact", PHYSICS_CONTACT_T, contact);
+			contact->release();
 			lua_rawseti(L, -2, i);
 			i++;
 		} while ((c = c->GetNext()));
@@ -512,7 +984,7 @@ namespace box2d
 
 	void World::destroy()
 	{
-		if (world->IsLocked())
+		if (isLocked())
 		{
 			destructWorld = true;
 			return;
@@ -526,13 +998,13 @@ namespace box2d
 			b = b->GetNext();
 			if (t == groundBody)
 				continue;
-			Body * body = (Body *)Memoizer::find(t);
-			if (!body)
-				throw love::Exception("A body has escaped Memoizer!");
+			Body * body = (Body *)t->GetUserData();
 			body->destroy();
 		}
 
 		world->DestroyBody(groundBody);
+		clearContactEvents(pendingEvents);
+		clearContactEvents(deliveredEvents);
 		Memoizer::remove(world);
 		delete world;
 		world = 0;
@@ -28,12 +28,18 @@
 
 // STD
 #include <vector>
+#include <string>
 
 // Box2D
 #include <Box2D/Box2D.h>
 
 namespace love
 {
+namespace thread
+{
+	class JobSystem;
+}
+
 namespace physics
 {
 namespace box2d
@@ -102,8 +108,47 @@ namespace box2d
 			virtual float32 ReportFixture(b2Fixture * fixture, const b2Vec2& point, const b2Vec2& normal, float32 fraction);
 		};
 
+		/**
+		* Solves Box2D islands on the workers of the job system.
+		* An error on a worker is thrown again on the calling thread.
+		**/
+		class TaskRunner : public b2TaskRunner
+		{
+		public:
+			thread::JobSystem * jobs;
+			TaskRunner();
+			~TaskRunner();
+			virtual int32 GetThreadCount() const;
+			virtual void ParallelFor(int32 count, Task task, void * data);
+		};
+
 	private:
 
+		enum ContactEventType
+		{
+			CONTACT_BEGIN,
+			CONTACT_END,
+			CONTACT_POSTSOLVE
+		};
+
+		/**
+		* A begin, end or postsolve event, recorded when contacts
+		* are buffered. It holds a copy of the contact data, since
+		* the Box2D contact may be gone by the time the event is
+		* read. Both Fixtures are retained while it is held.
+		**/
+		struct ContactEvent
+		{
+			ContactEventType type;
+			Fixture * a;
+			Fixture * b;
+			int points;
+			b2Vec2 normal;
+			b2Vec2 positions[b2_maxManifoldPoints];
+			float32 normalImpulses[b2_maxManifoldPoints];
+			float32 tangentImpulses[b2_maxManifoldPoints];
+		};
+
 		// Pointer to the Box2D world.
 		b2World * world;
 
@@ -121,6 +166,40 @@ namespace box2d
 		ContactFilter filter;
 		QueryCallback query;
 		RayCastCallback	raycast;
+		TaskRunner taskRunner;
+
+		// Solver iterations for each time step.
+		int velocityIterations;
+		int positionIterations;
+
+		// The fixed time step, or 0 for one step of the
+		// given length per update. Time which is left over
+		// is kept in the accumulator for the next update.
+		float fixedStep;
+		int maxSteps;
+		float accumulator;
+		bool interpolate;
+
+		// Buffered contact events. Events are recorded into
+		// pendingEvents, and appended to deliveredEvents after each
+		// time step. deliveredEvents is cleared by each update, so
+		// it holds the events of all its steps. Both vectors keep
+		// their storage.
+		bool bufferContacts;
+		bool delivering;
+		std::vector<ContactEvent> pendingEvents;
+		std::vector<ContactEvent> deliveredEvents;
+
+		// The message of a contact callback which raised an error.
+		// Delivery stops there, and update returns after the step.
+		bool callbackFailed;
+		std::string callbackError;
+
+		void step(float dt);
+		void recordContactEvent(ContactEventType type, b2Contact * contact, const b2ContactImpulse * impulse = NULL);
+		void flushContactEvents();
+		static void clearContactEvents(std::vector<ContactEvent> & events);
+		static void setContactEventFields(lua_State * L, int idx, const ContactEvent & e);
 
 	public:
 
@@ -143,14 +222,85 @@ namespace box2d
 		/**
 		* Updates everything in the world one timestep.
 		* This is called update() and not step() to conform
-		* with all other objects in LOVE.
+		* with all other objects in LOVE. With a fixed time
+		* step, it takes as many steps as fit in dt and the
+		* time left over from before.
 		* @param dt The timestep.
+		* @return The number of steps taken.
+		**/
+		int update(float dt);
+
+		/**
+		* Gets the error raised by a contact callback during the last
+		* update, and forgets it.
+		* @return False if there was none.
+		**/
+		bool takeCallbackError(std::string & error);
+
+		/**
+		* Sets the number of velocity and position iterations
+		* of the solver. Fewer are cheaper, and less accurate.
+		* The defaults are 8 and 6.
+		**/
+		void setIterations(int velocity, int position);
+
+		/**
+		* Gets the number of velocity and position iterations.
+		**/
+		void getIterations(int & velocity_o, int & position_o) const;
+
+		/**
+		* Sets a fixed time step. Each update then takes as
+		* many steps of this length as fit, but at most maxSteps;
+		* whole steps past that are dropped, so that a slow frame
+		* does not cause ever more steps. A step of 0 turns the
+		* fixed time step off.
+		**/
+		void setFixedTimestep(float step, int maxSteps);
+
+		/**
+		* Gets the fixed time step (0 if off) and the most
+		* steps taken by one update.
+		**/
+		void getFixedTimestep(float & step_o, int & maxSteps_o) const;
+
+		/**
+		* Sets whether the transform of each Body is saved
+		* before each fixed time step, so it can be drawn
+		* between the last two steps.
+		* @see Body::getInterpolatedPosition
+		**/
+		void setInterpolation(bool interpolate);
+
+		/**
+		* Returns whether Body transforms are interpolated.
 		**/
-		void update(float dt);
+		bool getInterpolation() const;
+
+		/**
+		* Gets how far the time left over from the last update
+		* is into the next fixed time step, from 0 to 1. This
+		* is 1 when the World does not interpolate.
+		**/
+		float getInterpolationAlpha() const;
+
+		/**
+		* Sets whether islands (groups of bodies which touch or are
+		* joined) are solved in parallel, on the workers of the job
+		* system. The results are the same either way. Postsolve
+		* callbacks are then made once all islands are solved.
+		**/
+		void setThreaded(bool threaded);
+
+		/**
+		* Returns whether islands are solved in parallel.
+		**/
+		bool getThreaded() const;
 
 		// From b2ContactListener
 		void BeginContact(b2Contact* contact);
 		void EndContact(b2Contact* contact);
+		void DestroyContact(b2Contact* contact);
 		void PreSolve(b2Contact* contact, const b2Manifold* oldManifold);
 		void PostSolve(b2Contact* contact, const b2ContactImpulse* impulse);
 
@@ -179,6 +329,31 @@ namespace box2d
 		**/
 		int getCallbacks(lua_State * L);
 
+		/**
+		* Sets whether begin, end and postsolve contact events are
+		* buffered. Buffered events are recorded during the time step,
+		* and passed to the callbacks after it, when the World may be
+		* changed. Each callback then gets both Fixtures and a table
+		* describing the event, which is reused between calls. The
+		* presolve callback is still called during the time step.
+		* @param buffer True to buffer contact events.
+		**/
+		void setContactBuffering(bool buffer);
+
+		/**
+		* Returns whether contact events are buffered.
+		**/
+		bool getContactBuffering() const;
+
+		/**
+		* Returns the contact events buffered during the last call
+		* to update, as an array of tables. A table may be passed in
+		* to be filled instead; the tables already in it are reused.
+		* @return The array of events.
+		* @return The number of events.
+		**/
+		int getContactEvents(lua_State * L);
+
 		/**
 		* Sets the ContactFilter callback.
 		**/
@@ -217,7 +392,8 @@ namespace box2d
 
 		/**
 		* Returns whether this World is currently locked.
-		* If it's locked, it's in the middle of a timestep.
+		* If it's locked, it's in the middle of a timestep,
+		* or passing buffered contact events to callbacks.
 		* @return Whether the World is locked.
 		**/
 		bool isLocked() const;
@@ -246,6 +422,21 @@ namespace box2d
 		**/
 		int getBodyList(lua_State * L) const;
 
+		/**
+		* Writes the state of every awake, non-static Body into a
+		* flat array: the Body, x, y and angle, and the linear
+		* velocity if the second argument is true. A table may be
+		* passed in to be filled. Positions are interpolated if the
+		* World interpolates.
+		*
+		* Given a SpriteBatch instead, it moves the sprite set with
+		* Fixture::setSprite of every Fixture to its Body, and
+		* returns the number of sprites moved. Sprites the batch
+		* can't set are skipped: an index past its size, or, for a
+		* Quad, a sprite which has not been added to it yet.
+		**/
+		int getBodyStates(lua_State * L);
+
 		/**
 		* Get an array of all the Joints in the World.
 		* @return An array of Joints.
@@ -68,6 +68,25 @@ namespace box2d
 		return 2;
 	}
 
+	int w_Body_getInterpolatedPosition(lua_State * L)
+	{
+		Body * t = luax_checkbody(L, 1);
+
+		float x_o, y_o;
+		t->getInterpolatedPosition(x_o, y_o);
+		lua_pushnumber(L, x_o);
+		lua_pushnumber(L, y_o);
+
+		return 2;
+	}
+
+	int w_Body_getInterpolatedAngle(lua_State * L)
+	{
+		Body * t = luax_checkbody(L, 1);
+		lua_pushnumber(L, t->getInterpolatedAngle());
+		return 1;
+	}
+
 	int w_Body_getLinearVelocity(lua_State * L)
 	{
 		Body * t = luax_checkbody(L, 1);
@@ -538,6 +557,8 @@ namespace box2d
 		{ "getY", w_Body_getY },
 		{ "getAngle", w_Body_getAngle },
 		{ "getPosition", w_Body_getPosition },
+		{ "getInterpolatedPosition", w_Body_getInterpolatedPosition },
+		{ "getInterpolatedAngle", w_Body_getInterpolatedAngle },
 		{ "getLinearVelocity", w_Body_getLinearVelocity },
 		{ "getWorldCenter", w_Body_getWorldCenter },
 		{ "getLocalCenter", w_Body_getLocalCenter },
@@ -37,6 +37,8 @@ namespace box2d
 	int w_Body_getY(lua_State * L);
 	int w_Body_getAngle(lua_State * L);
 	int w_Body_getPosition(lua_State * L);
+	int w_Body_getInterpolatedPosition(lua_State * L);
+	int w_Body_getInterpolatedAngle(lua_State * L);
 	int w_Body_getLinearVelocity(lua_State * L);
 	int w_Body_getWorldCenter(lua_State * L);
 	int w_Body_getLocalCenter(lua_State * L);
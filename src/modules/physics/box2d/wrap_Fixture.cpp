@@ -20,6 +20,7 @@
 
 #include "wrap_Fixture.h"
 #include <common/StringMap.h>
+#include <graphics/gles2/Quad.h>
 
 namespace love
 {
@@ -110,8 +111,7 @@ namespace box2d
 		Body * body = t->getBody();
 		if (body == 0)
 			return 0;
-		body->retain();
-		luax_newtype(L, "Body", PHYSICS_BODY_T, (void*)body);
+		luax_pushtype(L, "Body", PHYSICS_BODY_T, body);
 		return 1;
 	}
 
@@ -221,6 +221,39 @@ namespace box2d
 		return t->getUserData(L);
 	}
 
+	int w_Fixture_setSprite(lua_State * L)
+	{
+		Fixture * t = luax_checkfixture(L, 1);
+		if (lua_isnoneornil(L, 2))
+		{
+			t->setSprite(-1, 0.0f, 0.0f, 0);
+			return 0;
+		}
+
+		int index = luaL_checkint(L, 2);
+		if (index < 0)
+			return luaL_error(L, "Invalid sprite index: %d", index);
+
+		int idx = 3;
+		love::graphics::gles2::Quad * quad = 0;
+		if (luax_istype(L, 3, GRAPHICS_QUAD_T))
+		{
+			quad = luax_totype<love::graphics::gles2::Quad>(L, 3, "Quad", GRAPHICS_QUAD_T);
+			idx = 4;
+		}
+		float ox = (float)luaL_optnumber(L, idx, 0.0f);
+		float oy = (float)luaL_optnumber(L, idx+1, 0.0f);
+		t->setSprite(index, ox, oy, quad);
+		return 0;
+	}
+
+	int w_Fixture_getSprite(lua_State * L)
+	{
+		Fixture * t = luax_checkfixture(L, 1);
+		lua_remove(L, 1);
+		return t->getSprite(L);
+	}
+
 	int w_Fixture_getBoundingBox(lua_State * L)
 	{
 		Fixture * t = luax_checkfixture(L, 1);
@@ -287,6 +320,8 @@ namespace box2d
 		{ "getMask", w_Fixture_getMask },
 		{ "setUserData", w_Fixture_setUserData },
 		{ "getUserData", w_Fixture_getUserData },
+		{ "setSprite", w_Fixture_setSprite },
+		{ "getSprite", w_Fixture_getSprite },
 		{ "getBoundingBox", w_Fixture_getBoundingBox },
 		{ "getMassData", w_Fixture_getMassData },
 		{ "getGroupIndex", w_Fixture_getGroupIndex },
@@ -54,6 +54,8 @@ namespace box2d
 	int w_Fixture_getMask(lua_State * L);
 	int w_Fixture_setUserData(lua_State * L);
 	int w_Fixture_getUserData(lua_State * L);
+	int w_Fixture_setSprite(lua_State * L);
+	int w_Fixture_getSprite(lua_State * L);
 	int w_Fixture_getBoundingBox(lua_State * L);
 	int w_Fixture_getMassData(lua_State * L);
 	int w_Fixture_getGroupIndex(lua_State * L);
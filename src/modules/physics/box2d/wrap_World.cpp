@@ -39,10 +39,98 @@ namespace box2d
 	{
 		World * t = luax_checkworld(L, 1);
 		float dt = (float)luaL_checknumber(L, 2);
-		t->update(dt);
+		int steps = 0;
+		ASSERT_GUARD(steps = t->update(dt);)
+
+		// A contact callback raised an error, which is raised again
+		// here, in the caller's state.
+		std::string error;
+		if (t->takeCallbackError(error))
+		{
+			lua_pushlstring(L, error.data(), error.size());
+			return lua_error(L);
+		}
+
+		lua_pushinteger(L, steps);
+		return 1;
+	}
+
+	int w_World_setIterations(lua_State * L)
+	{
+		World * t = luax_checkworld(L, 1);
+		int velocity = luaL_checkint(L, 2);
+		int position = luaL_checkint(L, 3);
+		ASSERT_GUARD(t->setIterations(velocity, position);)
+		return 0;
+	}
+
+	int w_World_getIterations(lua_State * L)
+	{
+		World * t = luax_checkworld(L, 1);
+		int velocity, position;
+		t->getIterations(velocity, position);
+		lua_pushinteger(L, velocity);
+		lua_pushinteger(L, position);
+		return 2;
+	}
+
+	int w_World_setFixedTimestep(lua_State * L)
+	{
+		World * t = luax_checkworld(L, 1);
+		float step = (float)luaL_checknumber(L, 2);
+		int maxSteps = luaL_optint(L, 3, 8);
+		ASSERT_GUARD(t->setFixedTimestep(step, maxSteps);)
+		return 0;
+	}
+
+	int w_World_getFixedTimestep(lua_State * L)
+	{
+		World * t = luax_checkworld(L, 1);
+		float step;
+		int maxSteps;
+		t->getFixedTimestep(step, maxSteps);
+		lua_pushnumber(L, step);
+		lua_pushinteger(L, maxSteps);
+		return 2;
+	}
+
+	int w_World_setInterpolation(lua_State * L)
+	{
+		World * t = luax_checkworld(L, 1);
+		bool b = luax_toboolean(L, 2);
+		t->setInterpolation(b);
+		return 0;
+	}
+
+	int w_World_getInterpolation(lua_State * L)
+	{
+		World * t = luax_checkworld(L, 1);
+		luax_pushboolean(L, t->getInterpolation());
+		return 1;
+	}
+
+	int w_World_getInterpolationAlpha(lua_State * L)
+	{
+		World * t = luax_checkworld(L, 1);
+		lua_pushnumber(L, t->getInterpolationAlpha());
+		return 1;
+	}
+
+	int w_World_setThreaded(lua_State * L)
+	{
+		World * t = luax_checkworld(L, 1);
+		bool b = luax_toboolean(L, 2);
+		ASSERT_GUARD(t->setThreaded(b);)
 		return 0;
 	}
 
+	int w_World_getThreaded(lua_State * L)
+	{
+		World * t = luax_checkworld(L, 1);
+		luax_pushboolean(L, t->getThreaded());
+		return 1;
+	}
+
 	int w_World_setCallbacks(lua_State * L)
 	{
 		World * t = luax_checkworld(L, 1);
@@ -57,6 +145,28 @@ namespace box2d
 		return t->getCallbacks(L);
 	}
 
+	int w_World_setContactBuffering(lua_State * L)
+	{
+		World * t = luax_checkworld(L, 1);
+		bool b = luax_toboolean(L, 2);
+		t->setContactBuffering(b);
+		return 0;
+	}
+
+	int w_World_getContactBuffering(lua_State * L)
+	{
+		World * t = luax_checkworld(L, 1);
+		luax_pushboolean(L, t->getContactBuffering());
+		return 1;
+	}
+
+	int w_World_getContactEvents(lua_State * L)
+	{
+		World * t = luax_checkworld(L, 1);
+		lua_remove(L, 1);
+		return t->getContactEvents(L);
+	}
+
 	int w_World_setContactFilter(lua_State * L)
 	{
 		World * t = luax_checkworld(L, 1);
@@ -137,6 +247,13 @@ namespace box2d
 		return t->getBodyList(L);
 	}
 
+	int w_World_getBodyStates(lua_State * L)
+	{
+		World * t = luax_checkworld(L, 1);
+		lua_remove(L, 1);
+		return t->getBodyStates(L);
+	}
+
 	int w_World_getJointList(lua_State * L)
 	{
 		World * t = luax_checkworld(L, 1);
@@ -182,8 +299,20 @@ namespace box2d
 
 	static const luaL_Reg functions[] = {
 		{ "update", w_World_update },
+		{ "setIterations", w_World_setIterations },
+		{ "getIterations", w_World_getIterations },
+		{ "setFixedTimestep", w_World_setFixedTimestep },
+		{ "getFixedTimestep", w_World_getFixedTimestep },
+		{ "setInterpolation", w_World_setInterpolation },
+		{ "getInterpolation", w_World_getInterpolation },
+		{ "getInterpolationAlpha", w_World_getInterpolationAlpha },
+		{ "setThreaded", w_World_setThreaded },
+		{ "getThreaded", w_World_getThreaded },
 		{ "setCallbacks", w_World_setCallbacks },
 		{ "getCallbacks", w_World_getCallbacks },
+		{ "setContactBuffering", w_World_setContactBuffering },
+		{ "getContactBuffering", w_World_getContactBuffering },
+		{ "getContactEvents", w_World_getContactEvents },
 		{ "setContactFilter", w_World_setContactFilter },
 		{ "getContactFilter", w_World_getContactFilter },
 		{ "setGravity", w_World_setGravity },
@@ -195,6 +324,7 @@ namespace box2d
 		{ "getJointCount", w_World_getJointCount },
 		{ "getContactCount", w_World_getContactCount },
 		{ "getBodyList", w_World_getBodyList },
+		{ "getBodyStates", w_World_getBodyStates },
 		{ "getJointList", w_World_getJointList },
 		{ "getContactList", w_World_getContactList },
 		{ "queryBoundingBox", w_World_queryBoundingBox },
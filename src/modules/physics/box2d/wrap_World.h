@@ -35,8 +35,20 @@ namespace box2d
 {
 	World * luax_checkworld(lua_State * L, int idx);
 	int w_World_update(lua_State * L);
+	int w_World_setIterations(lua_State * L);
+	int w_World_getIterations(lua_State * L);
+	int w_World_setFixedTimestep(lua_State * L);
+	int w_World_getFixedTimestep(lua_State * L);
+	int w_World_setInterpolation(lua_State * L);
+	int w_World_getInterpolation(lua_State * L);
+	int w_World_getInterpolationAlpha(lua_State * L);
+	int w_World_setThreaded(lua_State * L);
+	int w_World_getThreaded(lua_State * L);
 	int w_World_setCallbacks(lua_State * L);
 	int w_World_getCallbacks(lua_State * L);
+	int w_World_setContactBuffering(lua_State * L);
+	int w_World_getContactBuffering(lua_State * L);
+	int w_World_getContactEvents(lua_State * L);
 	int w_World_setContactFilter(lua_State * L);
 	int w_World_getContactFilter(lua_State * L);
 	int w_World_setGravity(lua_State * L);
@@ -48,6 +60,7 @@ namespace box2d
 	int w_World_getJointCount(lua_State * L);
 	int w_World_getContactCount(lua_State * L);
 	int w_World_getBodyList(lua_State * L);
+	int w_World_getBodyStates(lua_State * L);
 	int w_World_getJointList(lua_State * L);
 	int w_World_getContactList(lua_State * L);
 	int w_World_queryBoundingBox(lua_State * L);
@@ -0,0 +1,215 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+#include "Channel.h"
+
+// LOVE
+#include <common/atomic.h>
+
+namespace love
+{
+namespace thread
+{
+	// Distance from a to b on the wrapping position counters.
+	static inline int distance(unsigned int a, unsigned int b)
+	{
+		return (int) (b - a);
+	}
+
+	Channel::Channel(int capacity)
+		: head(0), tail(0), peekers(0), waiters(0)
+	{
+		int size = 2;
+		while (size < capacity)
+			size *= 2;
+
+		cells = new Cell[size];
+		mask = size - 1;
+
+		for (int i = 0; i < size; i++)
+		{
+			cells[i].sequence = i;
+			cells[i].value = 0;
+		}
+	}
+
+	Channel::~Channel()
+	{
+		clear();
+		delete [] cells;
+	}
+
+	bool Channel::push(Variant * v)
+	{
+		Cell * cell;
+		unsigned int pos = atomicLoad(&head);
+
+		while (true)
+		{
+			cell = &cells[pos & mask];
+			unsigned int seq = atomicLoad(&cell->sequence);
+			int dif = distance(pos, seq);
+
+			if (dif == 0)
+			{
+				if (atomicCompareAndSwap(&head, pos, pos + 1))
+					break;
+				pos = atomicLoad(&head);
+			}
+			else if (dif < 0)
+				return false; // Full.
+			else
+				pos = atomicLoad(&head);
+		}
+
+		cell->value = v;
+		atomicStore(&cell->sequence, pos + 1);
+
+		if (atomicLoad(&waiters) > 0)
+		{
+			Lock lock(mutex);
+			cond.signal();
+		}
+
+		return true;
+	}
+
+	Variant * Channel::pop()
+	{
+		Cell * cell;
+		unsigned int pos = atomicLoad(&tail);
+
+		while (true)
+		{
+			cell = &cells[pos & mask];
+			unsigned int seq = atomicLoad(&cell->sequence);
+			int dif = distance(pos + 1, seq);
+
+			if (dif == 0)
+			{
+				if (atomicCompareAndSwap(&tail, pos, pos + 1))
+					break;
+				pos = atomicLoad(&tail);
+			}
+			else if (dif < 0)
+				return 0; // Empty.
+			else
+				pos = atomicLoad(&tail);
+		}
+
+		Variant * v = cell->value;
+		atomicStore(&cell->sequence, pos + mask + 1);
+
+		// A peek which saw the value before it was popped may still be
+		// converting it. Peeks are short.
+		while (atomicLoad(&peekers) > 0)
+			;
+
+		return v;
+	}
+
+	Variant * Channel::demand(int timeout)
+	{
+		Variant * v = pop();
+		if (v != 0)
+			return v;
+
+		Lock lock(mutex);
+		atomicAdd(&waiters, 1);
+
+		while ((v = pop()) == 0)
+		{
+			if (!cond.wait(&mutex, timeout))
+			{
+				v = pop();
+				break;
+			}
+		}
+
+		atomicAdd(&waiters, -1);
+		return v;
+	}
+
+	void Channel::peek(lua_State * L)
+	{
+		Variant * v = 0;
+		atomicAdd(&peekers, 1);
+
+		while (true)
+		{
+			unsigned int pos = atomicLoad(&tail);
+			Cell * cell = &cells[pos & mask];
+			unsigned int seq = atomicLoad(&cell->sequence);
+			int dif = distance(pos + 1, seq);
+
+			if (dif < 0)
+				break; // Empty.
+
+			if (dif == 0)
+			{
+				v = cell->value;
+
+				// Still the front value, so it has not been released,
+				// and our own reference keeps it alive from here on.
+				if (atomicLoad(&cell->sequence) == seq && atomicLoad(&tail) == pos)
+				{
+					v->retain();
+					break;
+				}
+				v = 0;
+			}
+		}
+
+		// Popping threads spin until this, so the conversion, which
+		// may allocate, happens after it.
+		atomicAdd(&peekers, -1);
+
+		if (v == 0)
+		{
+			lua_pushnil(L);
+			return;
+		}
+
+		v->toLua(L);
+		v->release();
+	}
+
+	int Channel::getCount()
+	{
+		int count = distance(atomicLoad(&tail), atomicLoad(&head));
+		if (count < 0)
+			return 0;
+		return (count > mask + 1) ? mask + 1 : count;
+	}
+
+	int Channel::getCapacity() const
+	{
+		return mask + 1;
+	}
+
+	void Channel::clear()
+	{
+		Variant * v;
+		while ((v = pop()) != 0)
+			v->release();
+	}
+
+} // thread
+} // love
@@ -0,0 +1,134 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+#ifndef LOVE_THREAD_CHANNEL_H
+#define LOVE_THREAD_CHANNEL_H
+
+// LOVE
+#include <common/Object.h>
+#include <common/Variant.h>
+#include <thread/threads.h>
+
+// Capacity of channels created without one.
+#define LOVE_CHANNEL_DEFAULT_CAPACITY 1024
+
+namespace love
+{
+namespace thread
+{
+	/**
+	* A bounded first-in first-out queue of Variants, which any
+	* number of threads may push to and pop from at once. Pushing and
+	* popping don't lock; only demand sleeps on a mutex while the
+	* channel is empty.
+	*
+	* The ring is Dmitry Vyukov's bounded MPMC queue: each cell has a
+	* sequence number saying whether it is ready to be written or read
+	* for the current lap, and producers and consumers claim positions
+	* with a compare-and-swap.
+	**/
+	class Channel : public Object
+	{
+	public:
+
+		/**
+		* @param capacity The most values the channel holds. Rounded
+		* up to a power of two.
+		**/
+		Channel(int capacity = LOVE_CHANNEL_DEFAULT_CAPACITY);
+		virtual ~Channel();
+
+		/**
+		* Adds a value at the back of the channel. The channel takes
+		* over the caller's reference on success.
+		* @return False if the channel is full.
+		**/
+		bool push(Variant * v);
+
+		/**
+		* Removes the value at the front of the channel. The caller
+		* gets the channel's reference.
+		* @return The value, or 0 if the channel is empty.
+		**/
+		Variant * pop();
+
+		/**
+		* Like pop, but waits for a value if the channel is empty.
+		* @param timeout Milliseconds to wait, or -1 to wait forever.
+		* @return The value, or 0 on timeout.
+		**/
+		Variant * demand(int timeout = -1);
+
+		/**
+		* Pushes the value at the front of the channel onto the Lua
+		* stack without removing it, or nil if the channel is empty.
+		* The value is converted while it is known to be alive, which
+		* is why this does not return the Variant.
+		**/
+		void peek(lua_State * L);
+
+		/**
+		* Gets the number of values in the channel. Only a snapshot
+		* when other threads use the channel.
+		**/
+		int getCount();
+
+		int getCapacity() const;
+
+		/**
+		* Pops and releases all values.
+		**/
+		void clear();
+
+	private:
+
+		struct Cell
+		{
+			volatile unsigned int sequence;
+			Variant * value;
+		};
+
+		Cell * cells;
+		int mask;
+
+		// Positions are kept apart so producers and consumers don't
+		// share a cache line. They wrap around, which is only defined
+		// for unsigned ints.
+		char pad0[64];
+		volatile unsigned int head;
+		char pad1[64];
+		volatile unsigned int tail;
+		char pad2[64];
+
+		// Number of peeks under way. Popped values are not released
+		// while a peek may be reading them.
+		volatile int peekers;
+
+		// Number of threads sleeping in demand.
+		volatile int waiters;
+		Mutex mutex;
+		Conditional cond;
+
+	}; // Channel
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_CHANNEL_H
@@ -0,0 +1,110 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+#include "Job.h"
+#include "JobPool.h"
+
+// LOVE
+#include <common/atomic.h>
+
+namespace love
+{
+namespace thread
+{
+	Job::Job(JobPool * pool, const std::string & function, Variant * arg, int count, int grain)
+		: pool(pool), system(pool->system), function(function), arg(arg), count(count), grain(grain), dependencies(1)
+	{
+		pool->retain();
+
+		int n = 1;
+		if (count >= 0)
+			n = (count + grain - 1) / grain;
+
+		chunks.resize(n);
+		results.resize(n, 0);
+		for (int i = 0; i < n; i++)
+		{
+			chunks[i].job = this;
+			chunks[i].index = i;
+		}
+	}
+
+	Job::~Job()
+	{
+		wait();
+
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			if (results[i])
+				results[i]->release();
+		}
+
+		if (arg)
+			arg->release();
+
+		pool->release();
+	}
+
+	bool Job::isDone() const
+	{
+		return counter.isDone();
+	}
+
+	void Job::wait()
+	{
+		system->wait(&counter);
+	}
+
+	const std::string & Job::getError() const
+	{
+		return error;
+	}
+
+	void Job::setError(const char * message)
+	{
+		Lock lock(errorMutex);
+		if (error.empty())
+			error = message ? message : "Unknown error.";
+	}
+
+	void Job::pushResults(lua_State * L)
+	{
+		if (count < 0)
+		{
+			if (results[0])
+				results[0]->toLua(L);
+			else
+				lua_pushnil(L);
+			return;
+		}
+
+		// Chunks which returned nothing leave holes.
+		lua_createtable(L, (int) results.size(), 0);
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			if (!results[i])
+				continue;
+			results[i]->toLua(L);
+			lua_rawseti(L, -2, (int) i + 1);
+		}
+	}
+
+} // thread
+} // love
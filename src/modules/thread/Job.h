@@ -0,0 +1,112 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+#ifndef LOVE_THREAD_JOB_H
+#define LOVE_THREAD_JOB_H
+
+// LOVE
+#include <common/Object.h>
+#include <common/Variant.h>
+#include "JobSystem.h"
+
+// STD
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace thread
+{
+	class JobPool;
+
+	/**
+	* A call to a job function in a JobPool, or a set of calls over the
+	* chunks of a range. Created by JobPool::submit and parallelFor.
+	**/
+	class Job : public Object
+	{
+	public:
+
+		/**
+		* Waits for the job to finish, since the workers still use it
+		* until then.
+		**/
+		virtual ~Job();
+
+		bool isDone() const;
+
+		/**
+		* Waits for all chunks of the job to finish.
+		**/
+		void wait();
+
+		/**
+		* Gets the error raised by a chunk, if any. Only valid after
+		* wait.
+		**/
+		const std::string & getError() const;
+
+		/**
+		* Pushes the results onto the stack: the returned value for a
+		* submitted job, or a table of the values returned by each
+		* chunk for a parallelFor. Only valid after wait.
+		**/
+		void pushResults(lua_State * L);
+
+	private:
+
+		friend class JobPool;
+
+		struct Chunk
+		{
+			Job * job;
+			int index;
+		};
+
+		Job(JobPool * pool, const std::string & function, Variant * arg, int count, int grain);
+
+		// Keeps the first error any chunk raises.
+		void setError(const char * message);
+
+		JobPool * pool;
+		JobSystem * system;
+		std::string function;
+		Variant * arg;
+
+		// -1 for a job which is not a parallelFor.
+		int count;
+		int grain;
+
+		std::vector<Chunk> chunks;
+		std::vector<Variant *> results;
+
+		// Jobs this one still waits for, plus one for the submitter.
+		volatile int dependencies;
+		JobCounter counter;
+
+		Mutex errorMutex;
+		std::string error;
+
+	}; // Job
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_JOB_H
@@ -0,0 +1,175 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+#include "JobPool.h"
+
+// LOVE
+#include <common/atomic.h>
+#include <common/Exception.h>
+
+#ifdef LOVE_BUILD_STANDALONE
+extern "C" int luaopen_love(lua_State * L);
+#endif // LOVE_BUILD_STANDALONE
+extern "C" int luaopen_love_thread(lua_State *L);
+
+namespace love
+{
+namespace thread
+{
+	JobPool::JobPool(love::Data * code)
+		: system(JobSystem::acquire())
+	{
+		int count = system->getWorkerCount();
+		for (int i = 0; i < count; i++)
+		{
+			lua_State * L = lua_open();
+			luaL_openlibs(L);
+		#ifdef LOVE_BUILD_STANDALONE
+			love::luax_preload(L, luaopen_love, "love");
+			luaopen_love(L);
+		#endif // LOVE_BUILD_STANDALONE
+			luaopen_love_thread(L);
+			lua_settop(L, 0);
+			states.push_back(L);
+
+			if (luaL_loadbuffer(L, (const char *) code->getData(), code->getSize(), "JobPool") != 0
+				|| lua_pcall(L, 0, 0, 0) != 0)
+			{
+				const char * message = lua_tostring(L, -1);
+				std::string error = message ? message : "Could not load the job code.";
+				for (size_t j = 0; j < states.size(); j++)
+					lua_close(states[j]);
+				system->release();
+				throw love::Exception("%s", error.c_str());
+			}
+		}
+	}
+
+	JobPool::~JobPool()
+	{
+		// Jobs hold a reference to the pool, so none are left.
+		for (size_t i = 0; i < states.size(); i++)
+			lua_close(states[i]);
+		system->release();
+	}
+
+	Job * JobPool::submit(const std::string & function, Variant * arg, const std::vector<Job *> & after)
+	{
+		Job * job = new Job(this, function, arg, -1, 0);
+
+		atomicAdd(&job->dependencies, (int) after.size());
+		for (size_t i = 0; i < after.size(); i++)
+			system->submit(releaseDependency, job, &job->counter, &after[i]->counter);
+
+		releaseDependency(job);
+		return job;
+	}
+
+	Job * JobPool::parallelFor(const std::string & function, Variant * arg, int count, int grain)
+	{
+		if (grain <= 0)
+		{
+			grain = count / (getWorkerCount() * 4);
+			if (grain < 1)
+				grain = 1;
+		}
+
+		Job * job = new Job(this, function, arg, count, grain);
+		releaseDependency(job);
+		return job;
+	}
+
+	int JobPool::getWorkerCount() const
+	{
+		return (int) states.size();
+	}
+
+	void JobPool::runChunk(void * data)
+	{
+		Job::Chunk * chunk = (Job::Chunk *) data;
+		Job * job = chunk->job;
+		JobPool * pool = job->pool;
+
+		int index = pool->system->getWorkerIndex();
+		if (index == 0)
+		{
+			job->setError("Job ran outside of a worker.");
+			return;
+		}
+
+		lua_State * L = pool->states[index - 1];
+		int top = lua_gettop(L);
+
+		lua_getglobal(L, job->function.c_str());
+		if (!lua_isfunction(L, -1))
+		{
+			std::string message = "No job function named '" + job->function + "'.";
+			job->setError(message.c_str());
+			lua_settop(L, top);
+			return;
+		}
+
+		int args = 1;
+		if (job->arg)
+			job->arg->toLua(L);
+		else
+			lua_pushnil(L);
+
+		if (job->count >= 0)
+		{
+			int first = chunk->index * job->grain;
+			int last = first + job->grain;
+			lua_pushinteger(L, first + 1);
+			lua_pushinteger(L, last < job->count ? last : job->count);
+			args += 2;
+		}
+
+		if (lua_pcall(L, args, 1, 0) != 0)
+			job->setError(lua_tostring(L, -1));
+		else if (!lua_isnil(L, -1))
+		{
+			Variant * v = Variant::fromLua(L, -1);
+			if (v)
+				job->results[chunk->index] = v;
+			else
+			{
+				std::string message = "Job function '" + job->function + "' returned a value which can't be stored safely.";
+				job->setError(message.c_str());
+			}
+		}
+
+		lua_settop(L, top);
+	}
+
+	void JobPool::releaseDependency(void * data)
+	{
+		Job * job = (Job *) data;
+		if (atomicAdd(&job->dependencies, -1) == 0)
+			job->pool->start(job);
+	}
+
+	void JobPool::start(Job * job)
+	{
+		for (size_t i = 0; i < job->chunks.size(); i++)
+			system->submit(runChunk, &job->chunks[i], &job->counter);
+	}
+
+} // thread
+} // love
@@ -0,0 +1,92 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+#ifndef LOVE_THREAD_JOB_POOL_H
+#define LOVE_THREAD_JOB_POOL_H
+
+// LOVE
+#include <common/Object.h>
+#include <common/Data.h>
+#include <common/runtime.h>
+#include <common/Variant.h>
+#include "Job.h"
+#include "JobSystem.h"
+
+// STD
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace thread
+{
+	/**
+	* Runs named Lua functions on the job system's workers. Each worker
+	* gets its own lua_State, which runs the pool's code once when the
+	* pool is created, so jobs only have to look up a global function
+	* and call it.
+	**/
+	class JobPool : public Object
+	{
+	public:
+
+		/**
+		* @param code Lua code defining the job functions as globals.
+		**/
+		JobPool(love::Data * code);
+		virtual ~JobPool();
+
+		/**
+		* Calls function(arg) on a worker once all the jobs in after
+		* have finished.
+		* @param arg Passed to the function. May be 0; the job takes
+		* over the reference.
+		**/
+		Job * submit(const std::string & function, Variant * arg, const std::vector<Job *> & after);
+
+		/**
+		* Calls function(arg, first, last) for chunks of at most grain
+		* items covering 1 to count, spread over the workers.
+		* @param grain Items per chunk, or 0 to choose.
+		**/
+		Job * parallelFor(const std::string & function, Variant * arg, int count, int grain);
+
+		int getWorkerCount() const;
+
+	private:
+
+		friend class Job;
+
+		static void runChunk(void * data);
+		static void releaseDependency(void * data);
+
+		void start(Job * job);
+
+		JobSystem * system;
+
+		// One per worker, indexed by worker index - 1.
+		std::vector<lua_State *> states;
+
+	}; // JobPool
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_JOB_POOL_H
@@ -0,0 +1,401 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+#include "JobSystem.h"
+
+// LOVE
+#include <common/atomic.h>
+#include <common/Exception.h>
+
+#ifdef LOVE_WINDOWS
+#	include <windows.h>
+#else
+#	include <unistd.h>
+#endif
+
+namespace love
+{
+namespace thread
+{
+	namespace
+	{
+		volatile int instanceLock = 0;
+		JobSystem * instance = 0;
+
+		void lockInstance()
+		{
+			while (!atomicCompareAndSwap(&instanceLock, 0, 1))
+				;
+		}
+
+		void unlockInstance()
+		{
+			atomicStore(&instanceLock, 0);
+		}
+
+		int getProcessorCount()
+		{
+#ifdef LOVE_WINDOWS
+			SYSTEM_INFO info;
+			GetSystemInfo(&info);
+			int count = (int) info.dwNumberOfProcessors;
+#else
+			int count = (int) sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+			if (count < 1)
+				return 1;
+			if (count > LOVE_JOB_MAX_WORKERS)
+				return LOVE_JOB_MAX_WORKERS;
+			return count;
+		}
+
+		struct Ranges
+		{
+			RangeFunction function;
+			void * data;
+			int count;
+			int grain;
+			volatile int next;
+		};
+
+		// Runs ranges until none are left. Every thread working on a
+		// parallelFor runs this, so faster threads simply take more.
+		void runRanges(void * data)
+		{
+			Ranges * r = (Ranges *) data;
+			while (true)
+			{
+				int first = atomicAdd(&r->next, r->grain) - r->grain;
+				if (first >= r->count)
+					break;
+				int last = first + r->grain;
+				r->function(r->data, first, last < r->count ? last : r->count);
+			}
+		}
+	}
+
+	JobCounter::JobCounter()
+		: pending(0)
+	{
+	}
+
+	bool JobCounter::isDone() const
+	{
+		return atomicLoad(const_cast<volatile int *>(&pending)) == 0;
+	}
+
+	JobSystem::Worker::Worker(JobSystem * system, int index)
+		: system(system), index(index), id(0)
+	{
+	}
+
+	void JobSystem::Worker::main()
+	{
+		id = ThreadBase::threadId();
+
+		Job job;
+		while (atomicLoad(&system->running))
+		{
+			if (system->pop(index, job))
+				system->run(job);
+			else
+				system->sleep();
+		}
+	}
+
+	JobSystem * JobSystem::acquire()
+	{
+		lockInstance();
+		JobSystem * system = instance;
+		if (system)
+			system->retain();
+		unlockInstance();
+
+		if (system)
+			return system;
+
+		system = new JobSystem(getProcessorCount());
+
+		lockInstance();
+		if (instance)
+		{
+			// Another thread got there first.
+			instance->retain();
+			JobSystem * other = instance;
+			unlockInstance();
+			system->release();
+			return other;
+		}
+
+		// The instance keeps a reference of its own, so the job system
+		// lives until the process exits. Freeing it on the last release
+		// would race with an acquire retaining it at the same time.
+		system->retain();
+		instance = system;
+		unlockInstance();
+
+		return system;
+	}
+
+	JobSystem::JobSystem(int count)
+		: queued(0), nextWorker(0), running(1), sleepers(0)
+	{
+		for (int i = 0; i < count; i++)
+			workers.push_back(new Worker(this, i + 1));
+
+		for (int i = 0; i < count; i++)
+		{
+			if (!workers[i]->start())
+			{
+				// Stop the ones which did start.
+				for (int j = i; j < count; j++)
+					delete workers[j];
+				workers.resize(i);
+				stop();
+				throw love::Exception("Could not start job worker thread.");
+			}
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		stop();
+	}
+
+	void JobSystem::stop()
+	{
+		atomicStore(&running, 0);
+		{
+			Lock lock(sleepMutex);
+			sleepCond.broadcast();
+		}
+
+		for (size_t i = 0; i < workers.size(); i++)
+		{
+			workers[i]->wait();
+			delete workers[i];
+		}
+		workers.clear();
+	}
+
+	int JobSystem::getWorkerCount() const
+	{
+		return (int) workers.size();
+	}
+
+	int JobSystem::getWorkerIndex() const
+	{
+		unsigned int id = ThreadBase::threadId();
+		for (size_t i = 0; i < workers.size(); i++)
+		{
+			if (workers[i]->id == id)
+				return (int) i + 1;
+		}
+		return 0;
+	}
+
+	void JobSystem::submit(JobFunction function, void * data, JobCounter * counter, JobCounter * after)
+	{
+		if (counter)
+			atomicAdd(&counter->pending, 1);
+
+		Job job;
+		job.function = function;
+		job.data = data;
+		job.counter = counter;
+
+		if (after)
+		{
+			// Counters only reach zero under doneMutex, so this can't
+			// miss it.
+			Lock lock(doneMutex);
+			if (atomicLoad(&after->pending) > 0)
+			{
+				JobCounter::Continuation c;
+				c.function = function;
+				c.data = data;
+				c.counter = counter;
+				after->continuations.push_back(c);
+				return;
+			}
+		}
+
+		push(job);
+	}
+
+	void JobSystem::parallelFor(int count, int grain, RangeFunction function, void * data)
+	{
+		if (count <= 0)
+			return;
+
+		int threads = getWorkerCount() + 1;
+		if (grain <= 0)
+		{
+			// A few ranges per thread, so they can balance out.
+			grain = count / (threads * 4);
+			if (grain < 1)
+				grain = 1;
+		}
+
+		Ranges r;
+		r.function = function;
+		r.data = data;
+		r.count = count;
+		r.grain = grain;
+		r.next = 0;
+
+		int ranges = (count + grain - 1) / grain;
+		int helpers = ranges - 1 < getWorkerCount() ? ranges - 1 : getWorkerCount();
+
+		JobCounter counter;
+		for (int i = 0; i < helpers; i++)
+			submit(runRanges, &r, &counter);
+
+		runRanges(&r);
+		wait(&counter);
+	}
+
+	void JobSystem::wait(JobCounter * counter)
+	{
+		int index = getWorkerIndex();
+
+		if (index > 0)
+		{
+			// Blocking a worker could leave the jobs counted here with
+			// nobody to run them, so help instead.
+			Job job;
+			while (atomicLoad(&counter->pending) > 0)
+			{
+				if (pop(index, job))
+					run(job);
+				else
+				{
+					Lock lock(doneMutex);
+					if (atomicLoad(&counter->pending) > 0)
+						doneCond.wait(&doneMutex, 1);
+				}
+			}
+		}
+
+		// Also makes sure the thread which finished the last job is
+		// done with the counter.
+		Lock lock(doneMutex);
+		while (atomicLoad(&counter->pending) > 0)
+			doneCond.wait(&doneMutex);
+	}
+
+	void JobSystem::push(const Job & job)
+	{
+		int index = getWorkerIndex();
+		if (index == 0)
+			index = (int) ((unsigned int) atomicAdd(&nextWorker, 1) % workers.size()) + 1;
+
+		Worker * w = workers[index - 1];
+		{
+			Lock lock(w->mutex);
+			w->jobs.push_back(job);
+		}
+
+		atomicAdd(&queued, 1);
+		if (atomicLoad(&sleepers) > 0)
+		{
+			Lock lock(sleepMutex);
+			sleepCond.signal();
+		}
+	}
+
+	bool JobSystem::pop(int index, Job & job)
+	{
+		if (atomicLoad(&queued) == 0)
+			return false;
+
+		int count = (int) workers.size();
+
+		// Newest first from our own queue, while it is still warm.
+		{
+			Worker * w = workers[index - 1];
+			Lock lock(w->mutex);
+			if (!w->jobs.empty())
+			{
+				job = w->jobs.back();
+				w->jobs.pop_back();
+				atomicAdd(&queued, -1);
+				return true;
+			}
+		}
+
+		// Oldest first from the others.
+		for (int i = 1; i < count; i++)
+		{
+			Worker * w = workers[(index - 1 + i) % count];
+			Lock lock(w->mutex);
+			if (!w->jobs.empty())
+			{
+				job = w->jobs.front();
+				w->jobs.pop_front();
+				atomicAdd(&queued, -1);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void JobSystem::run(const Job & job)
+	{
+		job.function(job.data);
+		if (job.counter)
+			finish(job.counter);
+	}
+
+	void JobSystem::finish(JobCounter * counter)
+	{
+		std::vector<JobCounter::Continuation> ready;
+		{
+			Lock lock(doneMutex);
+			if (atomicAdd(&counter->pending, -1) == 0)
+			{
+				ready.swap(counter->continuations);
+				doneCond.broadcast();
+			}
+		}
+
+		// These were counted when they were submitted.
+		for (size_t i = 0; i < ready.size(); i++)
+		{
+			Job job;
+			job.function = ready[i].function;
+			job.data = ready[i].data;
+			job.counter = ready[i].counter;
+			push(job);
+		}
+	}
+
+	void JobSystem::sleep()
+	{
+		Lock lock(sleepMutex);
+		atomicAdd(&sleepers, 1);
+		if (atomicLoad(&queued) == 0 && atomicLoad(&running))
+			sleepCond.wait(&sleepMutex);
+		atomicAdd(&sleepers, -1);
+	}
+
+} // thread
+} // love
@@ -0,0 +1,191 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+#ifndef LOVE_THREAD_JOB_SYSTEM_H
+#define LOVE_THREAD_JOB_SYSTEM_H
+
+// LOVE
+#include <common/Object.h>
+#include <thread/threads.h>
+
+// STD
+#include <deque>
+#include <vector>
+
+// Most workers a job system starts, whatever the number of cores.
+#define LOVE_JOB_MAX_WORKERS 16
+
+namespace love
+{
+namespace thread
+{
+	class JobSystem;
+
+	typedef void (*JobFunction)(void * data);
+	typedef void (*RangeFunction)(void * data, int first, int last);
+
+	/**
+	* Counts jobs which have not finished yet. Jobs can be made to wait
+	* for a counter to reach zero before they are started, and threads
+	* can wait for it with JobSystem::wait.
+	*
+	* A counter must outlive the jobs it counts; waiting for it to
+	* reach zero is enough.
+	**/
+	class JobCounter
+	{
+	public:
+
+		JobCounter();
+
+		/**
+		* @return True if no jobs are counted.
+		**/
+		bool isDone() const;
+
+	private:
+
+		friend class JobSystem;
+
+		struct Continuation
+		{
+			JobFunction function;
+			void * data;
+			JobCounter * counter;
+		};
+
+		volatile int pending;
+		std::vector<Continuation> continuations;
+
+	}; // JobCounter
+
+	/**
+	* Runs small jobs on a pool of worker threads, one per core. Each
+	* worker has its own queue. A worker takes the newest job from its
+	* own queue, and when that is empty it steals the oldest job from
+	* another worker's queue. Jobs submitted by a worker go to its own
+	* queue; the others are spread over the workers in turn.
+	*
+	* There is one job system, shared by all modules. Once started,
+	* it runs until the process exits.
+	**/
+	class JobSystem : public Object
+	{
+	public:
+
+		/**
+		* Gets the job system, starting it if needed.
+		* @return The job system, retained for the caller.
+		**/
+		static JobSystem * acquire();
+
+		virtual ~JobSystem();
+
+		int getWorkerCount() const;
+
+		/**
+		* Gets the worker the calling thread is.
+		* @return 1 to getWorkerCount() on a worker, 0 on other threads.
+		**/
+		int getWorkerIndex() const;
+
+		/**
+		* Queues a job.
+		* @param function The function to call on a worker.
+		* @param data Passed to the function.
+		* @param counter Counts the job until it has finished. May be 0.
+		* @param after The job is queued once this reaches zero. May be 0.
+		**/
+		void submit(JobFunction function, void * data, JobCounter * counter = 0, JobCounter * after = 0);
+
+		/**
+		* Calls function(data, first, last) for ranges of at most grain
+		* items covering [0, count), spread over the workers and the
+		* calling thread. Returns once all ranges are done.
+		* @param grain Items per range, or 0 to choose.
+		**/
+		void parallelFor(int count, int grain, RangeFunction function, void * data);
+
+		/**
+		* Waits for a counter to reach zero. A worker runs other jobs
+		* while it waits; other threads sleep.
+		**/
+		void wait(JobCounter * counter);
+
+	private:
+
+		struct Job
+		{
+			JobFunction function;
+			void * data;
+			JobCounter * counter;
+		};
+
+		class Worker : public ThreadBase
+		{
+		public:
+			Worker(JobSystem * system, int index);
+
+			JobSystem * system;
+			int index;
+			volatile unsigned int id;
+
+			Mutex mutex;
+			std::deque<Job> jobs;
+
+		protected:
+			virtual void main();
+		};
+
+		JobSystem(int workers);
+
+		// Stops and deletes the workers. Queued jobs are dropped.
+		void stop();
+
+		void push(const Job & job);
+		bool pop(int index, Job & job);
+		void run(const Job & job);
+		void finish(JobCounter * counter);
+		void sleep();
+
+		std::vector<Worker *> workers;
+
+		// Jobs queued but not yet taken, and the index of the worker
+		// the next job from outside is given to.
+		volatile int queued;
+		volatile int nextWorker;
+		volatile int running;
+
+		// Idle workers sleep here.
+		volatile int sleepers;
+		Mutex sleepMutex;
+		Conditional sleepCond;
+
+		// Guards counters reaching zero and their continuations.
+		// Waiting threads sleep on doneCond.
+		Mutex doneMutex;
+		Conditional doneCond;
+
+	}; // JobSystem
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_JOB_SYSTEM_H
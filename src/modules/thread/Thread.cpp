@@ -182,7 +182,6 @@ namespace thread
 	{
 		if (handle)
 		{
-			Lock lock((Mutex *) _gcmutex);
 			handle->kill();
 			delete handle;
 			handle = 0;
@@ -266,6 +265,9 @@ namespace thread
 			i->second->kill();
 			delete i->second;
 		}
+
+		for (channellist_t::iterator i = channels.begin(); i != channels.end(); i++)
+			i->second->release();
 	}
 
 	Thread *ThreadModule::newThread(const std::string & name, love::Data *data)
@@ -308,6 +310,22 @@ namespace thread
 		threads.erase(i);
 	}
 
+	Channel *ThreadModule::getChannel(const std::string & name)
+	{
+		Lock lock(channelMutex);
+		channellist_t::iterator i = channels.find(name);
+		Channel *c;
+		if (i == channels.end())
+		{
+			c = new Channel();
+			channels[name] = c;
+		}
+		else
+			c = i->second;
+		c->retain();
+		return c;
+	}
+
 	const char *ThreadModule::getName() const
 	{
 		return "love.thread.sdl";
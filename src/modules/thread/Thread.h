@@ -33,6 +33,7 @@
 #include <common/Module.h>
 #include <common/Variant.h>
 #include <thread/threads.h>
+#include "Channel.h"
 
 namespace love
 {
@@ -106,12 +107,17 @@ namespace thread
 	}; // Thread
 
 	typedef std::map<std::string, Thread*> threadlist_t;
+	typedef std::map<std::string, Channel*> channellist_t;
 
 	class ThreadModule : public love::Module
 	{
 	private:
 		threadlist_t threads;
 
+		// Named channels, shared by all threads.
+		channellist_t channels;
+		Mutex channelMutex;
+
 	public:
 		ThreadModule();
 		virtual ~ThreadModule();
@@ -120,6 +126,12 @@ namespace thread
 		Thread *getThread(const std::string & name);
 		unsigned getThreadCount() const;
 		void unregister(const std::string & name);
+
+		/**
+		* Gets the channel with a name, creating it if needed.
+		* @return The channel, retained for the caller.
+		**/
+		Channel *getChannel(const std::string & name);
 		const char *getName() const;
 	}; // ThreadModule
 } // thread
@@ -0,0 +1,110 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+#include "wrap_Channel.h"
+
+namespace love
+{
+namespace thread
+{
+	Channel *luax_checkchannel(lua_State *L, int idx)
+	{
+		return luax_checktype<Channel>(L, idx, "Channel", THREAD_CHANNEL_T);
+	}
+
+	int w_Channel_push(lua_State *L)
+	{
+		Channel *c = luax_checkchannel(L, 1);
+		Variant *v = Variant::fromLua(L, 2);
+		if (!v)
+			return luaL_error(L, "Expected boolean, number, string, table or userdata");
+		bool pushed = c->push(v);
+		if (!pushed)
+			v->release();
+		luax_pushboolean(L, pushed);
+		return 1;
+	}
+
+	static int pushvariant(lua_State *L, Variant *v)
+	{
+		if (!v)
+		{
+			lua_pushnil(L);
+			return 1;
+		}
+		v->toLua(L);
+		v->release();
+		return 1;
+	}
+
+	int w_Channel_pop(lua_State *L)
+	{
+		Channel *c = luax_checkchannel(L, 1);
+		return pushvariant(L, c->pop());
+	}
+
+	int w_Channel_demand(lua_State *L)
+	{
+		Channel *c = luax_checkchannel(L, 1);
+		// Seconds, like the rest of LOVE.
+		int timeout = -1;
+		if (!lua_isnoneornil(L, 2))
+			timeout = (int) (luaL_checknumber(L, 2) * 1000);
+		return pushvariant(L, c->demand(timeout));
+	}
+
+	int w_Channel_peek(lua_State *L)
+	{
+		Channel *c = luax_checkchannel(L, 1);
+		c->peek(L);
+		return 1;
+	}
+
+	int w_Channel_getCount(lua_State *L)
+	{
+		Channel *c = luax_checkchannel(L, 1);
+		lua_pushinteger(L, c->getCount());
+		return 1;
+	}
+
+	int w_Channel_clear(lua_State *L)
+	{
+		Channel *c = luax_checkchannel(L, 1);
+		c->clear();
+		return 0;
+	}
+
+	static const luaL_Reg type_functions[] = {
+		{ "push", w_Channel_push },
+		{ "pop", w_Channel_pop },
+		{ "demand", w_Channel_demand },
+		{ "peek", w_Channel_peek },
+		{ "getCount", w_Channel_getCount },
+		{ "clear", w_Channel_clear },
+		{ 0, 0 }
+	};
+
+	extern "C" int luaopen_channel(lua_State *L)
+	{
+		return luax_register_type(L, "Channel", type_functions);
+	}
+
+} // thread
+} // love
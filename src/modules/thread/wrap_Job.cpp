@@ -0,0 +1,61 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+#include "wrap_Job.h"
+
+namespace love
+{
+namespace thread
+{
+	Job *luax_checkjob(lua_State *L, int idx)
+	{
+		return luax_checktype<Job>(L, idx, "Job", THREAD_JOB_T);
+	}
+
+	int w_Job_isDone(lua_State *L)
+	{
+		Job *j = luax_checkjob(L, 1);
+		luax_pushboolean(L, j->isDone());
+		return 1;
+	}
+
+	int w_Job_wait(lua_State *L)
+	{
+		Job *j = luax_checkjob(L, 1);
+		j->wait();
+		if (!j->getError().empty())
+			return luaL_error(L, "%s", j->getError().c_str());
+		j->pushResults(L);
+		return 1;
+	}
+
+	static const luaL_Reg type_functions[] = {
+		{ "isDone", w_Job_isDone },
+		{ "wait", w_Job_wait },
+		{ 0, 0 }
+	};
+
+	extern "C" int luaopen_job(lua_State *L)
+	{
+		return luax_register_type(L, "Job", type_functions);
+	}
+
+} // thread
+} // love
@@ -0,0 +1,93 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+#include "wrap_JobPool.h"
+#include "wrap_Job.h"
+
+namespace love
+{
+namespace thread
+{
+	JobPool *luax_checkjobpool(lua_State *L, int idx)
+	{
+		return luax_checktype<JobPool>(L, idx, "JobPool", THREAD_JOB_POOL_T);
+	}
+
+	static Variant *checkargument(lua_State *L, int idx)
+	{
+		if (lua_isnoneornil(L, idx))
+			return 0;
+		Variant *v = Variant::fromLua(L, idx);
+		if (!v)
+			luaL_error(L, "Expected boolean, number, string, table or userdata");
+		return v;
+	}
+
+	int w_JobPool_submit(lua_State *L)
+	{
+		JobPool *p = luax_checkjobpool(L, 1);
+		std::string function = luax_checkstring(L, 2);
+
+		std::vector<Job *> after;
+		for (int i = 4; i <= lua_gettop(L); i++)
+			after.push_back(luax_checkjob(L, i));
+
+		Variant *arg = checkargument(L, 3);
+		Job *j = p->submit(function, arg, after);
+		luax_newtype(L, "Job", THREAD_JOB_T, (void*)j);
+		return 1;
+	}
+
+	int w_JobPool_parallelFor(lua_State *L)
+	{
+		JobPool *p = luax_checkjobpool(L, 1);
+		std::string function = luax_checkstring(L, 2);
+		int count = luaL_checkint(L, 4);
+		int grain = luaL_optint(L, 5, 0);
+		if (count < 0)
+			return luaL_error(L, "Invalid count: %d", count);
+
+		Variant *arg = checkargument(L, 3);
+		Job *j = p->parallelFor(function, arg, count, grain);
+		luax_newtype(L, "Job", THREAD_JOB_T, (void*)j);
+		return 1;
+	}
+
+	int w_JobPool_getWorkerCount(lua_State *L)
+	{
+		JobPool *p = luax_checkjobpool(L, 1);
+		lua_pushinteger(L, p->getWorkerCount());
+		return 1;
+	}
+
+	static const luaL_Reg type_functions[] = {
+		{ "submit", w_JobPool_submit },
+		{ "parallelFor", w_JobPool_parallelFor },
+		{ "getWorkerCount", w_JobPool_getWorkerCount },
+		{ 0, 0 }
+	};
+
+	extern "C" int luaopen_jobpool(lua_State *L)
+	{
+		return luax_register_type(L, "JobPool", type_functions);
+	}
+
+} // thread
+} // love
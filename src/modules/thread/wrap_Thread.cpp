@@ -19,6 +19,10 @@
 **/
 
 #include "wrap_Thread.h"
+#include "wrap_Channel.h"
+#include "wrap_Job.h"
+#include "wrap_JobPool.h"
+#include <common/wrap_ByteData.h>
 
 namespace love
 {
@@ -66,9 +70,7 @@ namespace thread
 			return 1;
 		}
 		v->toLua(L);
-		t->lock();
 		v->release();
-		t->unlock();
 		return 1;
 	}
 
@@ -103,9 +105,7 @@ namespace thread
 			return 1;
 		}
 		v->toLua(L);
-		t->lock();
 		v->release();
-		t->unlock();
 		return 1;
 	}
 
@@ -122,9 +122,7 @@ namespace thread
 			return 1;
 		}
 		v->toLua(L);
-		t->lock();
 		v->release();
-		t->unlock();
 		return 1;
 	}
 
@@ -135,11 +133,9 @@ namespace thread
 		std::string name = luax_checkstring(L, 2);
 		Variant *v = Variant::fromLua(L, 3);
 		if (!v)
-			return luaL_error(L, "Expected boolean, number, string or userdata");
+			return luaL_error(L, "Expected boolean, number, string, table or userdata");
 		t->set(name, v);
-		t->lock();
 		v->release();
-		t->unlock();
 		return 0;
 	}
 
@@ -204,9 +200,7 @@ namespace thread
 			// allow names containing \0
 			luax_pushstring(L, list[i]->getName());
 			luax_newtype(L, "Thread", THREAD_THREAD_T, (void*) list[i]);
-			list[i]->lock();
 			list[i]->retain();
-			list[i]->unlock();
 			lua_settable(L, -3);
 		}
 		delete[] list;
@@ -226,26 +220,119 @@ namespace thread
 		if (t)
 		{
 			luax_newtype(L, "Thread", THREAD_THREAD_T, (void*)t);
-			t->lock();
 			t->retain();
-			t->unlock();
 		}
 		else
 			lua_pushnil(L);
 		return 1;
 	}
 
+	int w_newChannel(lua_State *L)
+	{
+		int capacity = luaL_optint(L, 1, LOVE_CHANNEL_DEFAULT_CAPACITY);
+		if (capacity <= 0)
+			return luaL_error(L, "Invalid channel capacity: %d", capacity);
+		Channel *c = new Channel(capacity);
+		luax_newtype(L, "Channel", THREAD_CHANNEL_T, (void*)c);
+		return 1;
+	}
+
+	int w_getChannel(lua_State *L)
+	{
+		std::string name = luax_checkstring(L, 1);
+		// getChannel returns a retained channel
+		Channel *c = instance->getChannel(name);
+		luax_newtype(L, "Channel", THREAD_CHANNEL_T, (void*)c);
+		return 1;
+	}
+
+	int w_newJobPool(lua_State *L)
+	{
+		love::Data *data;
+		if (lua_isstring(L, 1))
+			luax_convobj(L, 1, "filesystem", "newFile");
+		if (luax_istype(L, 1, FILESYSTEM_FILE_T))
+		{
+			try
+			{
+				data = luax_checktype<love::filesystem::File>(L, 1, "File", FILESYSTEM_FILE_T)->read();
+			}
+			catch (love::Exception & e)
+			{
+				return luaL_error(L, e.what());
+			}
+		}
+		else
+		{
+			data = luax_checktype<love::Data>(L, 1, "Data", DATA_T);
+			data->retain();
+		}
+
+		JobPool *p;
+		try
+		{
+			p = new JobPool(data);
+		}
+		catch (love::Exception & e)
+		{
+			data->release();
+			return luaL_error(L, e.what());
+		}
+		data->release();
+		luax_newtype(L, "JobPool", THREAD_JOB_POOL_T, (void*)p);
+		return 1;
+	}
+
+	int w_newByteData(lua_State *L)
+	{
+		ByteData *d = 0;
+		try
+		{
+			if (lua_type(L, 1) == LUA_TNUMBER)
+			{
+				int size = lua_tointeger(L, 1);
+				if (size < 0)
+					return luaL_error(L, "Invalid size: %d", size);
+				d = new ByteData(size);
+			}
+			else if (lua_isstring(L, 1))
+			{
+				size_t len;
+				const char *str = lua_tolstring(L, 1, &len);
+				d = new ByteData(str, (int) len);
+			}
+			else
+			{
+				love::Data *data = luax_checktype<love::Data>(L, 1, "Data", DATA_T);
+				d = new ByteData(data->getData(), data->getSize());
+			}
+		}
+		catch (love::Exception & e)
+		{
+			return luaL_error(L, e.what());
+		}
+		luax_newtype(L, "ByteData", BYTE_DATA_T, (void*)d);
+		return 1;
+	}
 
 	// List of functions to wrap.
 	static const luaL_Reg module_functions[] = {
 		{ "newThread", w_newThread },
 		{ "getThread", w_getThread },
 		{ "getThreads", w_getThreads },
+		{ "newChannel", w_newChannel },
+		{ "getChannel", w_getChannel },
+		{ "newJobPool", w_newJobPool },
+		{ "newByteData", w_newByteData },
 		{ 0, 0 }
 	};
 
 	static const lua_CFunction types[] = {
 		luaopen_thread,
+		luaopen_channel,
+		luaopen_jobpool,
+		luaopen_job,
+		luaopen_bytedata,
 		0
 	};
 
@@ -258,9 +345,7 @@ namespace thread
 				instance = new ThreadModule();
 				lua_getglobal(L, "love");
 				Thread *curthread = instance->getThread("main");
-				curthread->lock();
 				curthread->retain();
-				curthread->unlock();
 				luax_newtype(L, "Thread", THREAD_THREAD_T, (void*)curthread);
 				lua_setfield(L, -2, "_curthread");
 			}
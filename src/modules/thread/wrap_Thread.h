@@ -44,6 +44,10 @@ namespace thread
 	int w_newThread(lua_State *L);
 	int w_getThreads(lua_State *L);
 	int w_getThread(lua_State *L);
+	int w_newChannel(lua_State *L);
+	int w_getChannel(lua_State *L);
+	int w_newJobPool(lua_State *L);
+	int w_newByteData(lua_State *L);
 
 	extern "C" LOVE_EXPORT int luaopen_love_thread(lua_State * L);
 
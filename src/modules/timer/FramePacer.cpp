@@ -0,0 +1,141 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+#include "FramePacer.h"
+
+// LOVE
+#include <common/config.h>
+
+// STD
+#include <algorithm>
+
+#ifdef LOVE_WINDOWS
+#	include <windows.h>
+#else
+#	include <sys/time.h>
+#	include <time.h>
+#endif
+
+namespace love
+{
+namespace timer
+{
+	const double FramePacer::SPIN_TIME = 0.002;
+	const double FramePacer::SMOOTHING = 0.1;
+
+	FramePacer::FramePacer()
+		: period(0), deadline(0), smoothed(0), numFrames(0), nextFrame(0)
+	{
+	}
+
+	double FramePacer::now()
+	{
+#ifdef LOVE_WINDOWS
+		static LARGE_INTEGER freq = {0};
+		if (!freq.QuadPart)
+			QueryPerformanceFrequency(&freq);
+
+		LARGE_INTEGER t;
+		QueryPerformanceCounter(&t);
+		return (double) t.QuadPart / (double) freq.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+		timespec t;
+		clock_gettime(CLOCK_MONOTONIC, &t);
+		return t.tv_sec + t.tv_nsec / 1000000000.0;
+#else
+		timeval t;
+		gettimeofday(&t, NULL);
+		return t.tv_sec + t.tv_usec / 1000000.0;
+#endif
+	}
+
+	void FramePacer::setTargetFPS(double fps)
+	{
+		period = fps > 0 ? 1.0 / fps : 0;
+		deadline = 0;
+	}
+
+	double FramePacer::getTargetFPS() const
+	{
+		return period > 0 ? 1.0 / period : 0;
+	}
+
+	void FramePacer::limit()
+	{
+		if (period <= 0)
+			return;
+
+		double t = now();
+		if (deadline == 0 || t - deadline > period)
+			deadline = t;
+
+		double remaining = deadline - t;
+		if (remaining > SPIN_TIME)
+		{
+			double sleep = remaining - SPIN_TIME;
+#ifdef LOVE_WINDOWS
+			Sleep((DWORD) (sleep * 1000));
+#else
+			timespec ts;
+			ts.tv_sec = (time_t) sleep;
+			ts.tv_nsec = (long) ((sleep - ts.tv_sec) * 1000000000.0);
+			nanosleep(&ts, 0);
+#endif
+		}
+
+		while (now() < deadline)
+			;
+
+		deadline += period;
+	}
+
+	void FramePacer::addFrame(double dt)
+	{
+		if (numFrames == 0)
+			smoothed = dt;
+		else
+			smoothed += (dt - smoothed) * SMOOTHING;
+
+		frames[nextFrame] = dt;
+		nextFrame = (nextFrame + 1) % WINDOW_SIZE;
+		if (numFrames < WINDOW_SIZE)
+			numFrames++;
+	}
+
+	double FramePacer::getSmoothedDelta() const
+	{
+		return smoothed;
+	}
+
+	double FramePacer::getPercentile(double p) const
+	{
+		if (numFrames == 0)
+			return 0;
+
+		p = std::min(std::max(p, 0.0), 100.0);
+		int n = (int) (p / 100.0 * (numFrames - 1) + 0.5);
+
+		std::copy(frames, frames + numFrames, sorted);
+		std::nth_element(sorted, sorted + n, sorted + numFrames);
+		return sorted[n];
+	}
+
+} // timer
+} // love
@@ -0,0 +1,101 @@
+/**
+* Copyright (c) 2006-2012 LOVE Development Team
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+**/
+
+#ifndef LOVE_TIMER_FRAME_PACER_H
+#define LOVE_TIMER_FRAME_PACER_H
+
+namespace love
+{
+namespace timer
+{
+	/**
+	* Paces frames to a target rate and keeps statistics on frame times.
+	* Uses a monotonic clock and nothing from SDL, so it can be used (and
+	* tested) without a window.
+	**/
+	class FramePacer
+	{
+	public:
+
+		/**
+		* The number of recent frames the percentiles are taken over.
+		**/
+		static const int WINDOW_SIZE = 240;
+
+		FramePacer();
+
+		/**
+		* Gets the time in seconds from a monotonic clock, with an
+		* unspecified start.
+		**/
+		static double now();
+
+		/**
+		* Sets the rate limit() paces frames to. Zero turns pacing off.
+		**/
+		void setTargetFPS(double fps);
+		double getTargetFPS() const;
+
+		/**
+		* Waits until the next frame is due. Most of the wait is a sleep; the
+		* last SPIN_TIME seconds are spent polling the clock, as sleeps are
+		* not precise. A frame which is late by more than a whole period
+		* starts a new schedule, rather than shortening the frames after it.
+		**/
+		void limit();
+
+		/**
+		* Records the length of a frame.
+		**/
+		void addFrame(double dt);
+
+		/**
+		* Gets an exponential moving average of the frame time.
+		**/
+		double getSmoothedDelta() const;
+
+		/**
+		* Gets a percentile (0 to 100) of the recorded frame times, or 0 if
+		* none have been recorded.
+		**/
+		double getPercentile(double p) const;
+
+	private:
+
+		static const double SPIN_TIME;
+		static const double SMOOTHING;
+
+		double period;
+		double deadline;
+
+		double smoothed;
+		double frames[WINDOW_SIZE];
+		int numFrames;
+		int nextFrame;
+
+		// Scratch space for getPercentile.
+		mutable double sorted[WINDOW_SIZE];
+
+	}; // FramePacer
+
+} // timer
+} // love
+
+#endif // LOVE_TIMER_FRAME_PACER_H
@@ -77,6 +77,35 @@ namespace timer
 		 **/
 		virtual double getMicroTime() const = 0;
 
+		/**
+		* Sets the frame rate limit() paces to.
+		* @param fps The target rate, or zero for no limit.
+		**/
+		virtual void setTargetFPS(double fps) = 0;
+
+		/**
+		* Gets the frame rate limit() paces to, or zero for none.
+		**/
+		virtual double getTargetFPS() const = 0;
+
+		/**
+		* Waits until the next frame is due under the target frame rate. Does
+		* nothing if there is no target.
+		**/
+		virtual void limit() = 0;
+
+		/**
+		* Gets the frame time (as measured by step), smoothed over recent
+		* frames.
+		**/
+		virtual double getAverageDelta() const = 0;
+
+		/**
+		* Gets a percentile of the recent frame times.
+		* @param p The percentile, from 0 to 100.
+		**/
+		virtual double getDeltaPercentile(double p) const = 0;
+
 	}; // Timer
 
 } // timer
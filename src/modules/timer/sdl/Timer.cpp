@@ -37,12 +37,13 @@ namespace timer
 namespace sdl
 {
 	Timer::Timer()
-		: currTime(0), prevFpsUpdate(0), fps(0), fpsUpdateFrequency(1),
-		frames(0), dt(0)
+		: fps(0), fpsUpdateFrequency(1), frames(0), dt(0)
 	{
 		// Init the SDL timer system.
 		if (SDL_InitSubSystem(SDL_INIT_TIMER) < 0)
 			throw Exception(SDL_GetError());
+
+		currTime = prevFpsUpdate = FramePacer::now();
 	}
 
 	Timer::~Timer()
@@ -64,13 +65,12 @@ namespace sdl
 		// "Current" time is previous time by now.
 		prevTime = currTime;
 
-		// Get ticks from SDL
-		currTime = SDL_GetTicks();
+		currTime = FramePacer::now();
 
-		// Convert to number of seconds
-		dt = (currTime - prevTime)/1000.0;
+		dt = currTime - prevTime;
+		pacer.addFrame(dt);
 
-		double timeSinceLast = (currTime - prevFpsUpdate)/1000.0;
+		double timeSinceLast = currTime - prevFpsUpdate;
 		// Update FPS?
 		if (timeSinceLast > fpsUpdateFrequency)
 		{
@@ -128,6 +128,31 @@ namespace sdl
 #endif
 	}
 
+	void Timer::setTargetFPS(double fps)
+	{
+		pacer.setTargetFPS(fps);
+	}
+
+	double Timer::getTargetFPS() const
+	{
+		return pacer.getTargetFPS();
+	}
+
+	void Timer::limit()
+	{
+		pacer.limit();
+	}
+
+	double Timer::getAverageDelta() const
+	{
+		return pacer.getSmoothedDelta();
+	}
+
+	double Timer::getDeltaPercentile(double p) const
+	{
+		return pacer.getPercentile(p);
+	}
+
 } // sdl
 } // timer
 } // love
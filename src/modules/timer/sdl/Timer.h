@@ -26,6 +26,7 @@
 
 // LOVE
 #include <timer/Timer.h>
+#include <timer/FramePacer.h>
 
 namespace love
 {
@@ -58,16 +59,21 @@ namespace sdl
 		int getFPS() const;
 		double getTime() const;
 		double getMicroTime() const;
+		void setTargetFPS(double fps);
+		double getTargetFPS() const;
+		void limit();
+		double getAverageDelta() const;
+		double getDeltaPercentile(double p) const;
 
 	private:
 
 		// Timing vars for benchmarking.
 		Uint32 time_init;
 
-		// Frame delta vars.
-		Uint32 currTime;
-		Uint32 prevTime;
-		Uint32 prevFpsUpdate;
+		// Frame delta vars, in seconds from FramePacer::now.
+		double currTime;
+		double prevTime;
+		double prevFpsUpdate;
 
 		// Updated with a certain frequency.
 		int fps;
@@ -81,6 +87,8 @@ namespace sdl
 		// The current timestep.
 		double dt;
 
+		FramePacer pacer;
+
 	}; // Timer
 
 } // sdl
@@ -67,6 +67,39 @@ namespace timer
 		return 1;
 	}
 
+	int w_setTargetFPS(lua_State * L)
+	{
+		instance->setTargetFPS(luaL_optnumber(L, 1, 0));
+		return 0;
+	}
+
+	int w_getTargetFPS(lua_State * L)
+	{
+		lua_pushnumber(L, instance->getTargetFPS());
+		return 1;
+	}
+
+	int w_limit(lua_State *)
+	{
+		instance->limit();
+		return 0;
+	}
+
+	int w_getFrameStats(lua_State * L)
+	{
+		lua_pushnumber(L, instance->getAverageDelta());
+		lua_pushnumber(L, instance->getDeltaPercentile(50));
+		lua_pushnumber(L, instance->getDeltaPercentile(95));
+		lua_pushnumber(L, instance->getDeltaPercentile(99));
+		return 4;
+	}
+
+	int w_getDeltaPercentile(lua_State * L)
+	{
+		lua_pushnumber(L, instance->getDeltaPercentile(luaL_checknumber(L, 1)));
+		return 1;
+	}
+
 	// List of functions to wrap.
 	static const luaL_Reg functions[] = {
 		{ "step", w_step },
@@ -75,6 +108,11 @@ namespace timer
 		{ "sleep", w_sleep },
 		{ "getTime", w_getTime },
 		{ "getMicroTime", w_getMicroTime },
+		{ "setTargetFPS", w_setTargetFPS },
+		{ "getTargetFPS", w_getTargetFPS },
+		{ "limit", w_limit },
+		{ "getFrameStats", w_getFrameStats },
+		{ "getDeltaPercentile", w_getDeltaPercentile },
 		{ 0, 0 }
 	};
 
@@ -34,6 +34,11 @@ namespace timer
 	int w_sleep(lua_State * L);
 	int w_getTime(lua_State * L);
 	int w_getMicroTime(lua_State * L);
+	int w_setTargetFPS(lua_State * L);
+	int w_getTargetFPS(lua_State * L);
+	int w_limit(lua_State * L);
+	int w_getFrameStats(lua_State * L);
+	int w_getDeltaPercentile(lua_State * L);
 	extern "C" LOVE_EXPORT int luaopen_love_timer(lua_State * L);
 
 } // timer
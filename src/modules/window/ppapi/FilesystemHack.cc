@@ -8,7 +8,6 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
-#include <deque>
 #include <string>
 
 #include "ppapi/cpp/instance.h"
@@ -16,6 +15,8 @@
 
 #include "sdk_util/auto_lock.h"
 
+#include "WriteBehind.h"
+
 namespace love {
 namespace window {
 namespace ppapi {
@@ -34,51 +35,23 @@ enum FilesystemAccess {
   FILESYSTEM_ACCESS_DISALLOWED,
 };
 
+// Changes to the save directory are mirrored to html5fs after this many
+// milliseconds, so that a burst of writes to one file costs one copy.
+const int kWriteBehindDelayMs = 250;
+
 static bool s_requested_filesystem_access = false;
 static FilesystemAccess s_filesystem_access = FILESYSTEM_ACCESS_UNKNOWN;
 static pthread_mutex_t s_mutex;
+static WriteBehind* s_write_behind = NULL;
 
-enum FilesystemHackType {
-  FILESYSTEM_HACK_MAKE_DIRECTORY,
-  FILESYSTEM_HACK_REMOVE,
-  FILESYSTEM_HACK_WRITE,
-};
-
-struct FilesystemHackInfo {
-  FilesystemHackType type;
-  std::string path;
-};
-
-typedef std::deque<FilesystemHackInfo> InfoDeque;
-static InfoDeque s_info_deque;
-
-bool ReplacePath(const char* from, const char* to, std::string* path) {
-  size_t ix = path->find(from);
-  if (ix != 0) {
-    return false;
-  }
-  path->replace(0, strlen(from), to);
-  return true;
-}
-
-std::string PathJoin(const char* write_dir, const char* path) {
-  return std::string(write_dir) + '/' + path;
-}
-
-std::string GetRealPath(const char* write_dir, const char* path) {
-  std::string result(PathJoin(write_dir, path));
-  if (ReplacePath(kFakePersistentDir, kRealPersistentDir, &result)) {
-    return result;
-  }
-  return std::string();
-}
-
-void RequestFilesystemAccess() {
-  if (s_filesystem_access == FILESYSTEM_ACCESS_UNKNOWN &&
-      !s_requested_filesystem_access) {
-    s_requested_filesystem_access = true;
-    g_Instance->PostMessage(kRequestFilesystemMessage);
+// Gets |path| in |write_dir| relative to the fake persistent directory, or
+// an empty string if it is not in there.
+std::string GetPersistentPath(const char* write_dir, const char* path) {
+  std::string result(std::string(write_dir) + '/' + path);
+  if (result.find(kFakePersistentDir) != 0) {
+    return std::string();
   }
+  return result.substr(strlen(kFakePersistentDir));
 }
 
 bool MakeDirectoryInternal(const std::string& path) {
@@ -102,116 +75,12 @@ bool MakeDirectoryInternal(const std::string& path) {
   return true;
 }
 
-bool RemoveFileInternal(const std::string& path) {
-  if (remove(path.c_str()) != 0) {
-    fprintf(stderr, "remove(%s) failed with errno: %d\n", path.c_str(), errno);
-    return false;
-  }
-
-  return true;
-}
-
-void PrintCopyFileError(FILE* file, const char* path, const char* op,
-                        size_t op_bytes, size_t bytes_copied,
-                        size_t total_bytes) {
-  const char* error = "unknown";
-  if (feof(file)) {
-    error = "feof";
-  } else if (ferror(file)) {
-    error = "ferror";
-  }
-  fprintf(stderr, "CopyFile: %s(%s, %u) failed (%s). [%u/%u] bytes copied.\n",
-          op, path, op_bytes, error, bytes_copied, total_bytes);
-}
-
-bool CopyFile(const char* src_path, const char* dst_path) {
-  const size_t kMaxBufferSize = 32 * 1024;
-  FILE* src = NULL;
-  FILE* dst = NULL;
-  uint8_t* buffer = NULL;
-  bool result = false;
-  struct stat statbuf;
-  size_t size;
-  size_t buffer_size;
-  size_t bytes_left;
-
-  if (stat(src_path, &statbuf) != 0) {
-    fprintf(stderr, "stat(%s) failed with errno: %d\n", src_path, errno);
-    return false;
-  }
-
-  size = statbuf.st_size;
-
-  src = fopen(src_path, "r");
-  if (!src) {
-    fprintf(stderr, "fopen(%s) failed with errno: %d\n", src_path, errno);
-    goto cleanup;
-  }
-
-  dst = fopen(dst_path, "w");
-  if (!dst) {
-    fprintf(stderr, "fopen(%s) failed with errno: %d\n", dst_path, errno);
-    goto cleanup;
-  }
-
-  buffer_size = std::min(size, kMaxBufferSize);
-  buffer = new uint8_t[buffer_size];
-
-  bytes_left = size;
-  while (bytes_left > 0) {
-    size_t bytes_read = std::min(bytes_left, buffer_size);
-    if (fread(buffer, bytes_read, 1, src) != 1) {
-      PrintCopyFileError(src, src_path, "fread", bytes_read, size - bytes_left,
-                         size);
-      goto cleanup;
-    }
-
-    if (fwrite(buffer, bytes_read, 1, dst) != 1) {
-      PrintCopyFileError(dst, dst_path, "fwrite", bytes_read, size - bytes_left,
-                         size);
-      goto cleanup;
-    }
-
-    bytes_left -= bytes_read;
-  }
-
-  result = true;
-cleanup:
-  delete[] buffer;
-  if (dst) fclose(dst);
-  if (src) fclose(src);
-  return result;
-}
-
-bool CopyFileForWriteInternal(const std::string& src_path) {
-  std::string dst_path(src_path);
-  if (!ReplacePath(kFakePersistentDir, kRealPersistentDir, &dst_path)) {
-    fprintf(stderr, "Strange path: %s\n", src_path.c_str());
-    return false;
-  }
-
-  return CopyFile(src_path.c_str(), dst_path.c_str());
-}
-
-void ProcessInfoDeque() {
-  for (InfoDeque::const_iterator iter = s_info_deque.begin();
-       iter != s_info_deque.end();
-       ++iter) {
-    const FilesystemHackInfo& info = *iter;
-    switch (info.type) {
-      case FILESYSTEM_HACK_MAKE_DIRECTORY:
-        MakeDirectoryInternal(info.path);
-        break;
-      case FILESYSTEM_HACK_REMOVE:
-        RemoveFileInternal(info.path);
-        break;
-      case FILESYSTEM_HACK_WRITE:
-        CopyFileForWriteInternal(info.path);
-        break;
-    }
+void RequestFilesystemAccess() {
+  if (s_filesystem_access == FILESYSTEM_ACCESS_UNKNOWN &&
+      !s_requested_filesystem_access) {
+    s_requested_filesystem_access = true;
+    g_Instance->PostMessage(kRequestFilesystemMessage);
   }
-
-  s_info_deque.clear();
 }
 
 }  // namespace
@@ -219,6 +88,15 @@ void ProcessInfoDeque() {
 
 void InitializeFilesystemHack() {
   pthread_mutex_init(&s_mutex, NULL);
+  s_write_behind = new WriteBehind(kFakePersistentDir, kRealPersistentDir,
+                                   kWriteBehindDelayMs);
+  // Nothing is mirrored until access to html5fs is allowed.
+  s_write_behind->SetPaused(true);
+}
+
+void SetFilesystemFlushScheduler(WriteBehind::ScheduleFunc func,
+                                 void* user_data) {
+  s_write_behind->SetScheduler(func, user_data);
 }
 
 void SetFilesystemAccessAllowed(bool allowed) {
@@ -230,70 +108,71 @@ void SetFilesystemAccessAllowed(bool allowed) {
 
   if (allowed) {
     s_filesystem_access = FILESYSTEM_ACCESS_ALLOWED;
-    ProcessInfoDeque();
+    s_write_behind->SetPaused(false);
   } else {
     s_filesystem_access = FILESYSTEM_ACCESS_DISALLOWED;
-    s_info_deque.clear();
+    s_write_behind->Clear();
+  }
+}
+
+bool FlushFilesystemHack() {
+  {
+    AutoLock lock(&s_mutex);
+    if (s_filesystem_access != FILESYSTEM_ACCESS_ALLOWED) {
+      return false;
+    }
   }
+
+  return s_write_behind->Flush();
+}
+
+void GetFilesystemHackStats(WriteBehind::Stats* stats) {
+  *stats = s_write_behind->GetStats();
 }
 
 bool MakeDirectory(const char* writedir, const char* path) {
-  std::string abs_path = GetRealPath(writedir, path);
-  if (abs_path.empty()) {
+  std::string rel_path = GetPersistentPath(writedir, path);
+  if (rel_path.empty()) {
     fprintf(stderr, "Strange path: %s\n", path);
     return false;
   }
 
   AutoLock lock(&s_mutex);
   RequestFilesystemAccess();
-  if (s_filesystem_access == FILESYSTEM_ACCESS_ALLOWED) {
-    return MakeDirectoryInternal(abs_path);
-  } else if (s_filesystem_access == FILESYSTEM_ACCESS_UNKNOWN) {
-    // Queue up request.
-    FilesystemHackInfo info;
-    info.type = FILESYSTEM_HACK_MAKE_DIRECTORY;
-    info.path = abs_path;
-    s_info_deque.push_back(info);
+  if (s_filesystem_access != FILESYSTEM_ACCESS_DISALLOWED) {
+    s_write_behind->MakeDirectory(rel_path);
   }
 
   return true;
 }
 
 bool RemoveFile(const char* writedir, const char* path) {
-  std::string abs_path = GetRealPath(writedir, path);
-  if (abs_path.empty()) {
+  std::string rel_path = GetPersistentPath(writedir, path);
+  if (rel_path.empty()) {
     fprintf(stderr, "Strange path: %s\n", path);
     return false;
   }
 
   AutoLock lock(&s_mutex);
   RequestFilesystemAccess();
-  if (s_filesystem_access == FILESYSTEM_ACCESS_ALLOWED) {
-    return RemoveFileInternal(abs_path);
-  } else if (s_filesystem_access == FILESYSTEM_ACCESS_UNKNOWN) {
-    // Queue up request.
-    FilesystemHackInfo info;
-    info.type = FILESYSTEM_HACK_REMOVE;
-    info.path = abs_path;
-    s_info_deque.push_back(info);
+  if (s_filesystem_access != FILESYSTEM_ACCESS_DISALLOWED) {
+    s_write_behind->Remove(rel_path);
   }
 
   return true;
 }
 
 bool CopyFileForWrite(const char* writedir, const char* path) {
-  std::string src_path = PathJoin(writedir, path);
+  std::string rel_path = GetPersistentPath(writedir, path);
+  if (rel_path.empty()) {
+    fprintf(stderr, "Strange path: %s\n", path);
+    return false;
+  }
 
   AutoLock lock(&s_mutex);
   RequestFilesystemAccess();
-  if (s_filesystem_access == FILESYSTEM_ACCESS_ALLOWED) {
-    return CopyFileForWriteInternal(src_path);
-  } else if (s_filesystem_access == FILESYSTEM_ACCESS_UNKNOWN) {
-    // Queue up request.
-    FilesystemHackInfo info;
-    info.type = FILESYSTEM_HACK_WRITE;
-    info.path = src_path;
-    s_info_deque.push_back(info);
+  if (s_filesystem_access != FILESYSTEM_ACCESS_DISALLOWED) {
+    s_write_behind->Write(rel_path);
   }
 
   return true;
@@ -307,7 +186,7 @@ bool MakeDirectoryForRead(const char* path) {
 bool CopyFileForRead(const char* path) {
   std::string src_path = std::string(kRealPersistentDir) + path;
   std::string dst_path = std::string(kFakePersistentDir) + path;
-  return CopyFile(src_path.c_str(), dst_path.c_str());
+  return s_write_behind->CopyFile(src_path, dst_path);
 }
 
 }  // ppapi
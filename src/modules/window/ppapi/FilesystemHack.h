@@ -1,12 +1,22 @@
 #ifndef LOVE_WINDOW_PPAPI_FILESYSTEM_HACK_H_
 #define LOVE_WINDOW_PPAPI_FILESYSTEM_HACK_H_
 
+#include "WriteBehind.h"
+
 namespace love {
 namespace window {
 namespace ppapi {
 
 void InitializeFilesystemHack();
 void SetFilesystemAccessAllowed(bool allowed);
+
+// Changes to the save directory are mirrored to html5fs in batches. The
+// scheduler is asked to call FlushFilesystemHack when a batch is due.
+void SetFilesystemFlushScheduler(WriteBehind::ScheduleFunc func,
+                                 void* user_data);
+bool FlushFilesystemHack();
+void GetFilesystemHackStats(WriteBehind::Stats* stats);
+
 bool MakeDirectory(const char* writedir, const char* path);
 bool RemoveFile(const char* writedir, const char* path);
 bool CopyFileForWrite(const char* writedir, const char* path);
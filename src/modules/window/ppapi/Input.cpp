@@ -1,7 +1,8 @@
 #include "Input.h"
 
-#include <deque>
+#include <errno.h>
 #include <string.h>
+#include <sys/time.h>
 #include <ppapi/cpp/var.h>
 #include <pthread.h>
 #include "Window.h"
@@ -11,28 +12,43 @@ namespace window {
 namespace ppapi {
 
 
-int g_window_width = 800;
-int g_window_height = 600;
-int g_mouse_x = 0;
-int g_mouse_y = 0;
-bool g_mouse_button[MOUSE_BUTTON_MAX];
-bool g_keys[KEY_CODE_MAX];
+struct InputState {
+  int window_width;
+  int window_height;
+  int mouse_x;
+  int mouse_y;
+  bool mouse_button[MOUSE_BUTTON_MAX];
+  bool keys[KEY_CODE_MAX];
+};
+
+// The state seen by the game. Only used on the game's thread, and updated
+// as events are dequeued.
+InputState g_state = { 800, 600, 0, 0 };
+// The state after every event received so far, including the ones which
+// were filtered out. Guarded by g_event_queue_mutex, and copied to g_state
+// once the queue has been emptied, so that dropping an event can't leave
+// a key or button stuck down.
+InputState g_received_state = { 800, 600, 0, 0 };
 bool g_key_repeat = false;
+bool g_input_enabled[FILTER_MAX] = { true, true, true, true, false };
+bool g_coalesce_mouse_move = true;
 
-typedef std::deque<InputEvent> InputEventQueue;
-InputEventQueue g_input_event_queue;
+InputEvents g_input_event_queue;
 pthread_mutex_t g_event_queue_mutex;
 pthread_cond_t g_queue_non_empty;
+// Counts calls of WakeEventWaiters. Only changed under
+// g_event_queue_mutex.
+uint32_t g_wake_generation = 0;
 
-void UpdateInputState(const InputEvent& event);
-void UpdateInputState(const InputEvents& events);
+void UpdateInputState(InputState* state, const InputEvent& event);
+void HandleDequeuedEvent(const InputEvent& event);
 
-int ClampMouseX(int x) {
-  return std::min(std::max(x, 0), g_window_width - 1);
+int ClampMouseX(const InputState& state, int x) {
+  return std::min(std::max(x, 0), state.window_width - 1);
 }
 
-int ClampMouseY(int y) {
-  return std::min(std::max(y, 0), g_window_height - 1);
+int ClampMouseY(const InputState& state, int y) {
+  return std::min(std::max(y, 0), state.window_height - 1);
 }
 
 bool ConvertEvent(const pp::InputEvent& in_event, InputEvent* out_event) {
@@ -85,8 +101,8 @@ bool ConvertEvent(const pp::InputEvent& in_event, InputEvent* out_event) {
   switch (type) {
     case INPUT_MOUSE: {
       pp::MouseInputEvent mouse_event(in_event);
-      out_event->mouse.x = ClampMouseX(mouse_event.GetPosition().x());
-      out_event->mouse.y = ClampMouseY(mouse_event.GetPosition().y());
+      out_event->mouse.x = mouse_event.GetPosition().x();
+      out_event->mouse.y = mouse_event.GetPosition().y();
       out_event->mouse.movement_x = mouse_event.GetMovement().x();
       out_event->mouse.movement_y = mouse_event.GetMovement().y();
       switch (mouse_event.GetButton()) {
@@ -118,13 +134,6 @@ bool ConvertEvent(const pp::InputEvent& in_event, InputEvent* out_event) {
       pp::KeyboardInputEvent key_event(in_event);
       out_event->key.code = key_event.GetKeyCode();
       memset(out_event->key.text, 0, sizeof(out_event->key.text));
-
-      // Kill repeated keys if it is turned off.
-      if (!g_key_repeat) {
-        if (out_event->key.type == KEY_DOWN &&
-            IsKeyPressed(out_event->key.code))
-            return false;
-      }
       break;
     }
     case INPUT_CHARACTER: {
@@ -165,22 +174,78 @@ void EnqueueEvent(const pp::InputEvent& event) {
     EnqueueEvent(converted_event);
 }
 
-void EnqueueEvent(const InputEvent& event) {
-  pthread_mutex_lock(&g_event_queue_mutex);
-  // Try to combine this character event with a previous key event.
-  // It's possible that we've already sent off the INPUT_KEY event without
-  // attaching its accompanying INPUT_CHARACTER event, but it's still better
-  // than waiting for an INPUT_CHARACTER event when we receive an INPUT_KEY
-  // event.
-  if (event.type == INPUT_CHARACTER) {
-    if (!g_input_event_queue.empty()) {
-      InputEvent& prev_event = g_input_event_queue.back();
-      if (prev_event.type == INPUT_KEY && prev_event.key.type == KEY_DOWN) {
-        strncpy(prev_event.key.text, event.character.text,
-                sizeof(prev_event.key.text));
-        pthread_mutex_unlock(&g_event_queue_mutex);
-        return;
+InputFilter GetFilter(const InputEvent& event) {
+  switch (event.type) {
+    case INPUT_KEY:
+      return event.key.type == KEY_UP ? FILTER_KEY_UP : FILTER_KEY_DOWN;
+    case INPUT_CHARACTER:
+      return FILTER_KEY_DOWN;
+    case INPUT_MOUSE:
+      switch (event.mouse.type) {
+        case MOUSE_DOWN:
+          return FILTER_MOUSE_DOWN;
+        case MOUSE_UP:
+          return FILTER_MOUSE_UP;
+        default:
+          return FILTER_MOUSE_MOVE;
       }
+    case INPUT_WHEEL:
+      return FILTER_MOUSE_DOWN;
+    default:
+      return FILTER_MAX;
+  }
+}
+
+void EnqueueEvent(const InputEvent& in_event) {
+  InputEvent event = in_event;
+  pthread_mutex_lock(&g_event_queue_mutex);
+  if (event.type == INPUT_MOUSE) {
+    event.mouse.x = ClampMouseX(g_received_state, event.mouse.x);
+    event.mouse.y = ClampMouseY(g_received_state, event.mouse.y);
+  }
+
+  // Kill repeated keys if it is turned off.
+  if (!g_key_repeat && event.type == INPUT_KEY &&
+      event.key.type == KEY_DOWN && event.key.code < KEY_CODE_MAX &&
+      g_received_state.keys[event.key.code]) {
+    pthread_mutex_unlock(&g_event_queue_mutex);
+    return;
+  }
+
+  UpdateInputState(&g_received_state, event);
+
+  InputFilter filter = GetFilter(event);
+  if (filter != FILTER_MAX && !g_input_enabled[filter]) {
+    pthread_mutex_unlock(&g_event_queue_mutex);
+    return;
+  }
+
+  if (!g_input_event_queue.empty()) {
+    InputEvent& prev_event = g_input_event_queue.back();
+
+    // Try to combine this character event with a previous key event.
+    // It's possible that we've already sent off the INPUT_KEY event without
+    // attaching its accompanying INPUT_CHARACTER event, but it's still better
+    // than waiting for an INPUT_CHARACTER event when we receive an INPUT_KEY
+    // event.
+    if (event.type == INPUT_CHARACTER &&
+        prev_event.type == INPUT_KEY && prev_event.key.type == KEY_DOWN) {
+      strncpy(prev_event.key.text, event.character.text,
+              sizeof(prev_event.key.text));
+      pthread_mutex_unlock(&g_event_queue_mutex);
+      return;
+    }
+
+    if (g_coalesce_mouse_move &&
+        event.type == INPUT_MOUSE && event.mouse.type == MOUSE_MOVE &&
+        prev_event.type == INPUT_MOUSE && prev_event.mouse.type == MOUSE_MOVE &&
+        prev_event.modifiers == event.modifiers) {
+      prev_event.mouse.x = event.mouse.x;
+      prev_event.mouse.y = event.mouse.y;
+      prev_event.mouse.movement_x += event.mouse.movement_x;
+      prev_event.mouse.movement_y += event.mouse.movement_y;
+      pthread_mutex_unlock(&g_event_queue_mutex);
+      return;
     }
   }
 
@@ -191,80 +256,140 @@ void EnqueueEvent(const InputEvent& event) {
 
 bool DequeueEvent(InputEvent* out_event) {
   bool has_event = false;
+  bool emptied = false;
+  InputState state;
   pthread_mutex_lock(&g_event_queue_mutex);
   if (!g_input_event_queue.empty()) {
     *out_event = g_input_event_queue.front();
-    g_input_event_queue.pop_front();
+    g_input_event_queue.erase(g_input_event_queue.begin());
     has_event = true;
+    emptied = g_input_event_queue.empty();
+    if (emptied)
+      state = g_received_state;
   }
   pthread_mutex_unlock(&g_event_queue_mutex);
-  UpdateInputState(*out_event);
+  if (has_event)
+    HandleDequeuedEvent(*out_event);
+  if (emptied)
+    g_state = state;
   return has_event;
 }
 
 void DequeueAllEvents(InputEvents* out_events) {
+  out_events->clear();
   pthread_mutex_lock(&g_event_queue_mutex);
-  out_events->resize(g_input_event_queue.size());
-  std::copy(g_input_event_queue.begin(), g_input_event_queue.end(),
-            out_events->begin());
-  g_input_event_queue.clear();
+  out_events->swap(g_input_event_queue);
+  InputState state = g_received_state;
   pthread_mutex_unlock(&g_event_queue_mutex);
-  UpdateInputState(*out_events);
+  for (InputEvents::const_iterator iter = out_events->begin();
+       iter != out_events->end();
+       ++iter) {
+    HandleDequeuedEvent(*iter);
+  }
+  // Takes in the changes made by events which were filtered out.
+  g_state = state;
 }
 
-void WaitForEvent() {
+uint32_t GetWakeGeneration() {
   pthread_mutex_lock(&g_event_queue_mutex);
-  while (g_input_event_queue.empty()) {
-    pthread_cond_wait(&g_queue_non_empty, &g_event_queue_mutex);
+  uint32_t generation = g_wake_generation;
+  pthread_mutex_unlock(&g_event_queue_mutex);
+  return generation;
+}
+
+bool WaitForEvent(int timeout_ms, uint32_t generation) {
+  struct timespec deadline;
+  if (timeout_ms >= 0) {
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    int64_t nsec = (int64_t) now.tv_usec * 1000 +
+                   (int64_t) (timeout_ms % 1000) * 1000000;
+    deadline.tv_sec = now.tv_sec + timeout_ms / 1000 + nsec / 1000000000;
+    deadline.tv_nsec = nsec % 1000000000;
   }
+
+  bool timed_out = false;
+  pthread_mutex_lock(&g_event_queue_mutex);
+  while (g_input_event_queue.empty() && g_wake_generation == generation) {
+    if (timeout_ms < 0) {
+      pthread_cond_wait(&g_queue_non_empty, &g_event_queue_mutex);
+    } else if (pthread_cond_timedwait(&g_queue_non_empty,
+                                      &g_event_queue_mutex,
+                                      &deadline) == ETIMEDOUT) {
+      timed_out = g_input_event_queue.empty() &&
+                  g_wake_generation == generation;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&g_event_queue_mutex);
+  return !timed_out;
+}
+
+void WakeEventWaiters() {
+  pthread_mutex_lock(&g_event_queue_mutex);
+  g_wake_generation++;
+  pthread_cond_broadcast(&g_queue_non_empty);
+  pthread_mutex_unlock(&g_event_queue_mutex);
+}
+
+void SetInputFilter(InputFilter filter, bool enabled) {
+  if (filter < 0 || filter >= FILTER_MAX)
+    return;
+  pthread_mutex_lock(&g_event_queue_mutex);
+  g_input_enabled[filter] = enabled;
+  pthread_mutex_unlock(&g_event_queue_mutex);
+}
+
+bool IsInputEnabled(InputFilter filter) {
+  if (filter < 0 || filter >= FILTER_MAX)
+    return false;
+  return g_input_enabled[filter];
+}
+
+void SetMouseMoveCoalescing(bool coalesce) {
+  pthread_mutex_lock(&g_event_queue_mutex);
+  g_coalesce_mouse_move = coalesce;
   pthread_mutex_unlock(&g_event_queue_mutex);
 }
 
 int GetMouseX() {
-  return g_mouse_x;
+  return g_state.mouse_x;
 }
 
 int GetMouseY() {
-  return g_mouse_y;
+  return g_state.mouse_y;
 }
 
 bool IsMouseButtonPressed(MouseButton button) {
   if (button <= MOUSE_NONE || button >= MOUSE_BUTTON_MAX)
     return false;
-  return g_mouse_button[button];
+  return g_state.mouse_button[button];
 }
 
 bool IsKeyPressed(uint32_t code) {
   if (code >= KEY_CODE_MAX)
     return false;
-  return g_keys[code];
+  return g_state.keys[code];
 }
 
 void SetKeyRepeat(bool repeat) {
+  pthread_mutex_lock(&g_event_queue_mutex);
   g_key_repeat = repeat;
+  pthread_mutex_unlock(&g_event_queue_mutex);
 }
 
-void UpdateInputState(const InputEvents& events) {
-  for (InputEvents::const_iterator iter = events.begin();
-       iter != events.end();
-       ++iter) {
-    UpdateInputState(*iter);
-  }
-}
-
-void UpdateInputState(const InputEvent& event) {
-  Window* window = static_cast<Window*>(Window::getSingleton());
+void UpdateInputState(InputState* state, const InputEvent& event) {
   switch (event.type) {
     case INPUT_MOUSE:
-      g_mouse_x = ClampMouseX(event.mouse.x);
-      g_mouse_y = ClampMouseY(event.mouse.y);
+      state->mouse_x = ClampMouseX(*state, event.mouse.x);
+      state->mouse_y = ClampMouseY(*state, event.mouse.y);
 
       switch (event.mouse.type) {
         case MOUSE_DOWN:
-          g_mouse_button[event.mouse.button] = true;
+          state->mouse_button[event.mouse.button] = true;
           break;
         case MOUSE_UP:
-          g_mouse_button[event.mouse.button] = false;
+          state->mouse_button[event.mouse.button] = false;
           break;
       }
       break;
@@ -273,26 +398,32 @@ void UpdateInputState(const InputEvent& event) {
       switch (event.key.type) {
         case KEY_DOWN:
           if (event.key.code < KEY_CODE_MAX)
-            g_keys[event.key.code] = true;
+            state->keys[event.key.code] = true;
           break;
         case KEY_UP:
           if (event.key.code < KEY_CODE_MAX)
-            g_keys[event.key.code] = false;
+            state->keys[event.key.code] = false;
           break;
       }
       break;
 
-    case INPUT_FOCUS:
-      window->onFocusChanged(event.focus.has_focus);
-      break;
-
     case INPUT_VIEW_CHANGED:
-      g_window_width = event.view_changed.width;
-      g_window_height = event.view_changed.height;
+      state->window_width = event.view_changed.width;
+      state->window_height = event.view_changed.height;
       break;
   }
 }
 
+// Handles the parts of an event which must happen on the game's thread.
+void HandleDequeuedEvent(const InputEvent& event) {
+  UpdateInputState(&g_state, event);
+
+  if (event.type == INPUT_FOCUS) {
+    Window* window = static_cast<Window*>(Window::getSingleton());
+    window->onFocusChanged(event.focus.has_focus);
+  }
+}
+
 }  // ppapi
 }  // window
 }  // love
@@ -259,14 +259,50 @@ struct InputEvent {
 
 typedef std::vector<InputEvent> InputEvents;
 
+// Types of event which can be turned off with SetInputFilter. Mouse wheel
+// events count as MOUSE_DOWN, and mouse enter/leave as MOUSE_MOVE.
+enum InputFilter {
+  FILTER_KEY_DOWN,
+  FILTER_KEY_UP,
+  FILTER_MOUSE_DOWN,
+  FILTER_MOUSE_UP,
+  FILTER_MOUSE_MOVE,
+  FILTER_MAX,
+};
+
 void InitializeEventQueue();
 void EnqueueViewChangeEvent(int32_t width, int32_t height);
 void EnqueueFocusEvent(bool has_focus);
 void EnqueueEvent(const pp::InputEvent& event);
 void EnqueueEvent(const InputEvent& event);
 bool DequeueEvent(InputEvent* out_event);
+// Swaps the queue with |out_events|, which is cleared first. Passing the
+// same vector each time means neither side allocates once the capacity
+// has grown to fit a frame of events.
 void DequeueAllEvents(InputEvents* out_events);
-void WaitForEvent();
+// Gets the number of WakeEventWaiters calls so far, to pass to
+// WaitForEvent. Read it before checking for events by other routes, so
+// that a wake in between is not missed.
+uint32_t GetWakeGeneration();
+// Blocks until the queue is not empty, WakeEventWaiters has been called
+// since GetWakeGeneration returned |generation|, or |timeout_ms| has
+// passed (a negative timeout waits forever). Returns false if it timed
+// out.
+bool WaitForEvent(int timeout_ms, uint32_t generation);
+// Wakes a thread blocked in WaitForEvent, for events which arrive by
+// another route.
+void WakeEventWaiters();
+
+// Events of a disabled type are dropped as they arrive. The mouse and
+// keyboard state still takes them in, when the queue is next emptied.
+// Mouse motion is disabled by default.
+void SetInputFilter(InputFilter filter, bool enabled);
+bool IsInputEnabled(InputFilter filter);
+
+// When on (the default), a mouse move which arrives while another is at
+// the back of the queue is merged into it. The merged event has the
+// latest position and the summed movement.
+void SetMouseMoveCoalescing(bool coalesce);
 
 // Mouse state
 int GetMouseX();
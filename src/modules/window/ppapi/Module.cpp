@@ -22,13 +22,19 @@
 #include <ppapi/utility/completion_callback_factory.h>
 #include <ppapi/utility/threading/simple_thread.h>
 
+#include <filesystem/physfs/Archive.h>
 #include <window/Window.h>
 #include <window/ppapi/Window.h>
 #include "FilesystemHack.h"
 #include "Input.h"
+#include "URLRangeIO.h"
 
 #define READ_BUFFER_SIZE (128 * 1024)
 
+// The name the downloaded game is registered under; it is never written to
+// the filesystem, love.filesystem.setSource mounts it from memory.
+#define GAME_SOURCE_NAME "/temporary/game.love"
+
 
 int love_main(int argc, char** argv);
 
@@ -54,25 +60,33 @@ class Instance : public pp::Instance {
 
  private:
   void MainLoop_Initialize(int32_t);
+  bool MainLoop_OpenRemote();
   void MainLoop_Download();
   void MainLoop_Run(int32_t);
   void Filesystem_AllowAccess(int32_t, bool allowed);
   void Filesystem_CopyFile(int32_t, const std::string& path);
   void Filesystem_MakeDir(int32_t, const std::string& path);
+  void Filesystem_Flush(int32_t);
+
+  static void ScheduleFilesystemFlush(void* user_data, int delay_ms);
 
   std::string url_;
+  bool progressive_;
 
   pp::URLRequestInfo url_request_;
   pp::URLLoader url_loader_;
   char* buffer_;
 
-  pp::CompletionCallbackFactory<Instance> callback_factory_;
+  // Also used from the game thread, by ScheduleFilesystemFlush.
+  pp::CompletionCallbackFactory<Instance, pp::ThreadSafeThreadTraits>
+      callback_factory_;
   pp::SimpleThread main_loop_thread_;
   pp::SimpleThread filesystem_thread_;
 };
 
 Instance::Instance(PP_Instance instance)
     : pp::Instance(instance),
+      progressive_(false),
       buffer_(new char[READ_BUFFER_SIZE]),
       callback_factory_(this),
       main_loop_thread_(this),
@@ -96,6 +110,7 @@ bool Instance::Init(uint32_t argc, const char* argn[], const char* argv[]) {
 
   InitializeEventQueue();
   InitializeFilesystemHack();
+  SetFilesystemFlushScheduler(&Instance::ScheduleFilesystemFlush, this);
   main_loop_thread_.Start();
   filesystem_thread_.Start();
 
@@ -108,6 +123,8 @@ bool Instance::Init(uint32_t argc, const char* argn[], const char* argv[]) {
     } else if (!strcmp(argn[i], "src")) {
       src = argv[i];
       printf("Found src: %s\n", src.c_str());
+    } else if (!strcmp(argn[i], "love_progressive")) {
+      progressive_ = true;
     }
   }
 
@@ -206,12 +223,25 @@ void Instance::MainLoop_Initialize(int32_t) {
   setvbuf(stdout, NULL, _IOLBF, 0);
   setvbuf(stderr, NULL, _IOLBF, 0);
 
-  MainLoop_Download();
+  if (!progressive_ || !MainLoop_OpenRemote())
+    MainLoop_Download();
 
   // Notify the JavaScript that we're OK!
   PostMessage("OK");
 }
 
+bool Instance::MainLoop_OpenRemote() {
+  URLRangeIO* game = new URLRangeIO(this, url_);
+  bool opened = game->Open();
+  if (opened) {
+    printf("Reading %s with range requests.\n", url_.c_str());
+    love::filesystem::physfs::Archive::addSource(GAME_SOURCE_NAME, game);
+    url_loader_ = pp::URLLoader();
+  }
+  game->release();
+  return opened;
+}
+
 void Instance::MainLoop_Download() {
   int32_t result;
   if (url_loader_.is_null()) {
@@ -233,15 +263,15 @@ void Instance::MainLoop_Download() {
   int64_t total_bytes = 0;
   int64_t total_written = 0;
 
-  FILE* outf = fopen("/temporary/game.love", "w+");
-  if (!outf) {
-    fprintf(stderr, "Cannot open output file\n");
-    return;
-  }
+  using love::filesystem::physfs::Archive;
+  using love::filesystem::physfs::MemoryIO;
+  MemoryIO* game = new MemoryIO();
 
   while (1) {
     if (url_loader_.GetDownloadProgress(&total_received, &total_bytes)) {
       PostMessagef("download:%lld,%lld", total_received, total_bytes);
+      // Size the buffer once when the server sends a Content-Length.
+      game->reserve(total_bytes);
     } else {
       PostMessagef("download:%lld,0", total_written);
     }
@@ -256,19 +286,19 @@ void Instance::MainLoop_Download() {
       break;
     }
 
-    size_t bytes_written = fwrite(&buffer_[0], 1, result, outf);
-    if (bytes_written != static_cast<size_t>(result)) {
-      fprintf(stderr, "Error writing to output file\n");
+    if (!game->append(&buffer_[0], result)) {
+      fprintf(stderr, "Out of memory while downloading %s\n", url_.c_str());
       goto done;
     }
 
-    total_written += bytes_written;
+    total_written += result;
   }
 
+  Archive::addSource(GAME_SOURCE_NAME, game);
   printf("Done.\n");
 
 done:
-  fclose(outf);
+  game->release();
   url_loader_ = pp::URLLoader();
   return;
 }
@@ -276,8 +306,10 @@ done:
 void Instance::MainLoop_Run(int32_t) {
   std::vector<const char*> args;
   args.push_back("/");
-  args.push_back("/temporary/game.love");
+  args.push_back(GAME_SOURCE_NAME);
   love_main(args.size(), const_cast<char**>(args.data()));
+  // Don't leave the last saves waiting for a flush.
+  FlushFilesystemHack();
   PostMessage("bye");
 }
 
@@ -293,6 +325,18 @@ void Instance::Filesystem_MakeDir(int32_t, const std::string& path) {
   MakeDirectoryForRead(path.c_str());
 }
 
+void Instance::Filesystem_Flush(int32_t) {
+  FlushFilesystemHack();
+}
+
+// static
+void Instance::ScheduleFilesystemFlush(void* user_data, int delay_ms) {
+  Instance* self = static_cast<Instance*>(user_data);
+  self->filesystem_thread_.message_loop().PostWork(
+      self->callback_factory_.NewCallback(&Instance::Filesystem_Flush),
+      delay_ms);
+}
+
 class Module : public pp::Module {
  public:
   Module() : pp::Module() {}
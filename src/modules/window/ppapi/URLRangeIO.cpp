@@ -0,0 +1,140 @@
+#include "URLRangeIO.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include <ppapi/c/pp_errors.h>
+#include <ppapi/cpp/completion_callback.h>
+#include <ppapi/cpp/url_loader.h>
+#include <ppapi/cpp/url_request_info.h>
+#include <ppapi/cpp/url_response_info.h>
+#include <ppapi/cpp/var.h>
+
+#include "sdk_util/auto_lock.h"
+
+// Decoded entries of a remote archive kept in memory.
+#define URL_RANGE_CACHE_LIMIT (32 * 1024 * 1024)
+
+namespace love {
+namespace window {
+namespace ppapi {
+
+namespace {
+
+const int32_t kStatusPartialContent = 206;
+
+// Returns the total size from a "Content-Range: bytes 0-0/1234" header, or
+// -1 if there is none.
+love::int64 ParseContentRangeTotal(const std::string& headers) {
+  const char kContentRange[] = "content-range:";
+  size_t start = 0;
+  while (start < headers.size()) {
+    size_t end = headers.find('\n', start);
+    if (end == std::string::npos)
+      end = headers.size();
+
+    std::string line = headers.substr(start, end - start);
+    if (strncasecmp(line.c_str(), kContentRange, strlen(kContentRange)) == 0) {
+      size_t slash = line.find('/');
+      if (slash == std::string::npos || line[slash + 1] == '*')
+        return -1;
+      return strtoll(line.c_str() + slash + 1, NULL, 10);
+    }
+    start = end + 1;
+  }
+  return -1;
+}
+
+}  // namespace
+
+URLRangeIO::URLRangeIO(const pp::InstanceHandle& instance,
+                       const std::string& url)
+    : instance_(instance),
+      url_(url),
+      size_(-1) {
+  pthread_mutex_init(&mutex_, NULL);
+}
+
+URLRangeIO::~URLRangeIO() {
+  pthread_mutex_destroy(&mutex_);
+}
+
+bool URLRangeIO::Open() {
+  AutoLock lock(&mutex_);
+  char byte;
+  std::string headers;
+  if (!ReadRange(&byte, 0, 1, &headers))
+    return false;
+
+  size_ = ParseContentRangeTotal(headers);
+  return size_ > 0;
+}
+
+love::int64 URLRangeIO::getSize() {
+  return size_;
+}
+
+bool URLRangeIO::read(void* dst, love::int64 offset, love::int64 size) {
+  if (offset < 0 || size < 0 || offset + size > size_)
+    return false;
+  if (size == 0)
+    return true;
+
+  AutoLock lock(&mutex_);
+  return ReadRange(dst, offset, size, NULL);
+}
+
+love::int64 URLRangeIO::getCacheLimit() const {
+  return URL_RANGE_CACHE_LIMIT;
+}
+
+bool URLRangeIO::ReadRange(void* dst, love::int64 offset, love::int64 size,
+                           std::string* headers) {
+  char range[64];
+  snprintf(range, sizeof(range), "Range: bytes=%lld-%lld", offset,
+           offset + size - 1);
+
+  pp::URLRequestInfo request(instance_);
+  request.SetURL(url_);
+  request.SetMethod("GET");
+  request.SetHeaders(range);
+
+  pp::URLLoader loader(instance_);
+  int32_t result = loader.Open(request, pp::CompletionCallback());
+  if (result != PP_OK) {
+    fprintf(stderr, "Cannot read range of URL %s. Error %d\n", url_.c_str(),
+            result);
+    return false;
+  }
+
+  // A server that ignores the Range header would send the whole file.
+  pp::URLResponseInfo response = loader.GetResponseInfo();
+  if (response.GetStatusCode() != kStatusPartialContent)
+    return false;
+
+  if (headers)
+    *headers = response.GetHeaders().AsString();
+
+  char* out = static_cast<char*>(dst);
+  love::int64 remaining = size;
+  while (remaining > 0) {
+    int32_t to_read = remaining > 0x7fffffff ? 0x7fffffff
+                                             : static_cast<int32_t>(remaining);
+    result = loader.ReadResponseBody(out, to_read, pp::CompletionCallback());
+    if (result <= 0) {
+      fprintf(stderr, "Error reading range of URL %s. Error %d\n",
+              url_.c_str(), result);
+      return false;
+    }
+    out += result;
+    remaining -= result;
+  }
+
+  return true;
+}
+
+}  // namespace ppapi
+}  // namespace window
+}  // namespace love
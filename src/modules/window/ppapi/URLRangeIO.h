@@ -0,0 +1,46 @@
+#ifndef LOVE_WINDOW_PPAPI_URL_RANGE_IO_H_
+#define LOVE_WINDOW_PPAPI_URL_RANGE_IO_H_
+
+#include <pthread.h>
+
+#include <string>
+
+#include <filesystem/physfs/Archive.h>
+#include <ppapi/cpp/instance_handle.h>
+
+namespace love {
+namespace window {
+namespace ppapi {
+
+// Reads a remote file with HTTP range requests, so a .love can be mounted
+// without downloading it first. Requests block, so it must not be used on
+// the main PPAPI thread; they are serialized with a mutex.
+class URLRangeIO : public love::filesystem::physfs::ArchiveIO {
+ public:
+  URLRangeIO(const pp::InstanceHandle& instance, const std::string& url);
+  virtual ~URLRangeIO();
+
+  // Finds the size of the file. Returns false if the server does not
+  // support range requests, in which case the file must be downloaded.
+  bool Open();
+
+  // Implements ArchiveIO.
+  virtual love::int64 getSize();
+  virtual bool read(void* dst, love::int64 offset, love::int64 size);
+  virtual love::int64 getCacheLimit() const;
+
+ private:
+  bool ReadRange(void* dst, love::int64 offset, love::int64 size,
+                 std::string* headers);
+
+  pp::InstanceHandle instance_;
+  std::string url_;
+  love::int64 size_;
+  pthread_mutex_t mutex_;
+};
+
+}  // namespace ppapi
+}  // namespace window
+}  // namespace love
+
+#endif  // LOVE_WINDOW_PPAPI_URL_RANGE_IO_H_
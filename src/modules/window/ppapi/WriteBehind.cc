@@ -0,0 +1,289 @@
+#include "WriteBehind.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+namespace love {
+namespace window {
+namespace ppapi {
+
+namespace {
+
+class ScopedLock {
+ public:
+  explicit ScopedLock(pthread_mutex_t* mutex) : mutex_(mutex) {
+    pthread_mutex_lock(mutex_);
+  }
+  ~ScopedLock() { pthread_mutex_unlock(mutex_); }
+
+ private:
+  pthread_mutex_t* mutex_;
+};
+
+bool IsSameOrChild(const std::string& path, const std::string& parent) {
+  return path.compare(0, parent.size(), parent) == 0 &&
+         (path.size() == parent.size() || path[parent.size()] == '/');
+}
+
+}  // namespace
+
+WriteBehind::WriteBehind(const std::string& src_root,
+                         const std::string& dst_root,
+                         int delay_ms)
+    : src_root_(src_root),
+      dst_root_(dst_root),
+      delay_ms_(delay_ms),
+      schedule_func_(NULL),
+      schedule_user_data_(NULL),
+      paused_(false),
+      scheduled_(false) {
+  pthread_mutex_init(&mutex_, NULL);
+  pthread_mutex_init(&copy_mutex_, NULL);
+  memset(&stats_, 0, sizeof(stats_));
+}
+
+WriteBehind::~WriteBehind() {
+  pthread_mutex_destroy(&copy_mutex_);
+  pthread_mutex_destroy(&mutex_);
+}
+
+void WriteBehind::SetScheduler(ScheduleFunc func, void* user_data) {
+  ScopedLock lock(&mutex_);
+  schedule_func_ = func;
+  schedule_user_data_ = user_data;
+}
+
+void WriteBehind::SetPaused(bool paused) {
+  bool schedule = false;
+  {
+    ScopedLock lock(&mutex_);
+    paused_ = paused;
+    ScheduleLocked(&schedule);
+  }
+
+  if (schedule)
+    schedule_func_(schedule_user_data_, delay_ms_);
+}
+
+void WriteBehind::MakeDirectory(const std::string& path) {
+  Push(OP_MAKE_DIRECTORY, path);
+}
+
+void WriteBehind::Remove(const std::string& path) {
+  Push(OP_REMOVE, path);
+}
+
+void WriteBehind::Write(const std::string& path) {
+  Push(OP_WRITE, path);
+}
+
+void WriteBehind::Clear() {
+  ScopedLock lock(&mutex_);
+  ops_.clear();
+}
+
+bool WriteBehind::Flush() {
+  ScopedLock copy_lock(&copy_mutex_);
+
+  OpDeque ops;
+  {
+    ScopedLock lock(&mutex_);
+    ops.swap(ops_);
+    scheduled_ = false;
+  }
+
+  bool result = true;
+  for (OpDeque::const_iterator iter = ops.begin(); iter != ops.end(); ++iter) {
+    if (!Apply(*iter))
+      result = false;
+  }
+
+  TrimBufferLocked();
+  return result;
+}
+
+bool WriteBehind::CopyFile(const std::string& src_path,
+                           const std::string& dst_path) {
+  ScopedLock copy_lock(&copy_mutex_);
+  bool result = CopyFileLocked(src_path, dst_path);
+  TrimBufferLocked();
+  return result;
+}
+
+WriteBehind::Stats WriteBehind::GetStats() {
+  ScopedLock lock(&mutex_);
+  return stats_;
+}
+
+void WriteBehind::Push(OpType type, const std::string& path) {
+  bool schedule = false;
+  {
+    ScopedLock lock(&mutex_);
+    switch (type) {
+      case OP_MAKE_DIRECTORY:
+        if (!directories_.insert(path).second) {
+          stats_.directories_avoided++;
+          return;
+        }
+        break;
+
+      case OP_REMOVE: {
+        // Queued writes to the file, or to the files of the directory,
+        // are pointless now.
+        OpDeque::iterator iter = ops_.begin();
+        while (iter != ops_.end()) {
+          if (iter->type == OP_WRITE && IsSameOrChild(iter->path, path)) {
+            iter = ops_.erase(iter);
+            stats_.copies_avoided++;
+          } else {
+            ++iter;
+          }
+        }
+
+        std::set<std::string>::iterator dir = directories_.lower_bound(path);
+        while (dir != directories_.end() && IsSameOrChild(*dir, path))
+          directories_.erase(dir++);
+        break;
+      }
+
+      case OP_WRITE:
+        // The file is copied when the queue is flushed, so a write which
+        // is already queued (and not followed by a remove) covers this
+        // one too.
+        for (OpDeque::reverse_iterator iter = ops_.rbegin();
+             iter != ops_.rend(); ++iter) {
+          if (iter->path != path)
+            continue;
+          if (iter->type == OP_WRITE) {
+            stats_.copies_avoided++;
+            return;
+          }
+          break;
+        }
+        break;
+    }
+
+    Op op;
+    op.type = type;
+    op.path = path;
+    ops_.push_back(op);
+    ScheduleLocked(&schedule);
+  }
+
+  if (schedule)
+    schedule_func_(schedule_user_data_, delay_ms_);
+}
+
+void WriteBehind::ScheduleLocked(bool* schedule) {
+  if (!paused_ && !scheduled_ && schedule_func_ && !ops_.empty()) {
+    scheduled_ = true;
+    *schedule = true;
+  }
+}
+
+bool WriteBehind::Apply(const Op& op) {
+  switch (op.type) {
+    case OP_MAKE_DIRECTORY:
+      if (!MakeDirectories(op.path)) {
+        ScopedLock lock(&mutex_);
+        directories_.erase(op.path);
+        return false;
+      }
+      return true;
+
+    case OP_REMOVE: {
+      std::string path(dst_root_ + op.path);
+      if (remove(path.c_str()) != 0) {
+        fprintf(stderr, "remove(%s) failed with errno: %d\n", path.c_str(),
+                errno);
+        return false;
+      }
+      return true;
+    }
+
+    case OP_WRITE:
+      return CopyFileLocked(src_root_ + op.path, dst_root_ + op.path);
+  }
+
+  return false;
+}
+
+bool WriteBehind::MakeDirectories(const std::string& path) {
+  // Parent directories first; these may well exist already.
+  for (size_t slash = path.find('/', 1); slash != std::string::npos;
+       slash = path.find('/', slash + 1)) {
+    mkdir((dst_root_ + path.substr(0, slash)).c_str(), 0777);
+  }
+
+  std::string full_path(dst_root_ + path);
+  if (mkdir(full_path.c_str(), 0777) != 0 && errno != EEXIST) {
+    fprintf(stderr, "mkdir(%s) failed with errno: %d\n", full_path.c_str(),
+            errno);
+    return false;
+  }
+
+  return true;
+}
+
+bool WriteBehind::CopyFileLocked(const std::string& src_path,
+                                 const std::string& dst_path) {
+  struct stat statbuf;
+  if (stat(src_path.c_str(), &statbuf) != 0) {
+    fprintf(stderr, "stat(%s) failed with errno: %d\n", src_path.c_str(),
+            errno);
+    return false;
+  }
+
+  size_t size = statbuf.st_size;
+  if (buffer_.size() < size)
+    buffer_.resize(size);
+
+  FILE* src = fopen(src_path.c_str(), "rb");
+  if (!src) {
+    fprintf(stderr, "fopen(%s) failed with errno: %d\n", src_path.c_str(),
+            errno);
+    return false;
+  }
+
+  bool read_ok = size == 0 || fread(&buffer_[0], size, 1, src) == 1;
+  fclose(src);
+  if (!read_ok) {
+    fprintf(stderr, "CopyFile: fread(%s, %u) failed.\n", src_path.c_str(),
+            static_cast<unsigned>(size));
+    return false;
+  }
+
+  FILE* dst = fopen(dst_path.c_str(), "wb");
+  if (!dst) {
+    fprintf(stderr, "fopen(%s) failed with errno: %d\n", dst_path.c_str(),
+            errno);
+    return false;
+  }
+
+  bool write_ok = size == 0 || fwrite(&buffer_[0], size, 1, dst) == 1;
+  if (fclose(dst) != 0)
+    write_ok = false;
+  if (!write_ok) {
+    fprintf(stderr, "CopyFile: fwrite(%s, %u) failed.\n", dst_path.c_str(),
+            static_cast<unsigned>(size));
+    return false;
+  }
+
+  ScopedLock lock(&mutex_);
+  stats_.bytes_copied += size;
+  stats_.files_copied++;
+  return true;
+}
+
+void WriteBehind::TrimBufferLocked() {
+  // One large save should not pin its size in memory for good.
+  if (buffer_.capacity() > kMaxKeptBufferSize)
+    std::vector<uint8_t>().swap(buffer_);
+}
+
+}  // namespace ppapi
+}  // namespace window
+}  // namespace love
@@ -0,0 +1,112 @@
+#ifndef LOVE_WINDOW_PPAPI_WRITE_BEHIND_H_
+#define LOVE_WINDOW_PPAPI_WRITE_BEHIND_H_
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include <deque>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace love {
+namespace window {
+namespace ppapi {
+
+// Mirrors changes made under one directory (the memfs save directory) to
+// another (html5fs). Changes are queued and applied later by Flush, so
+// several writes to the same file in that time cost a single copy, and a
+// directory is only created once. Nothing here depends on PPAPI, so it
+// works on plain directories too.
+class WriteBehind {
+ public:
+  struct Stats {
+    uint64_t bytes_copied;
+    uint32_t files_copied;
+    // Writes that were merged into an already queued write, or dropped
+    // because the file was removed before it was copied.
+    uint32_t copies_avoided;
+    // Directories which were not created again.
+    uint32_t directories_avoided;
+  };
+
+  // Called (with no lock held) when a change is queued and no flush is
+  // pending. It should arrange for Flush to be called after |delay_ms|.
+  typedef void (*ScheduleFunc)(void* user_data, int delay_ms);
+
+  // Paths passed to the other methods are relative to the roots, and
+  // start with a '/'.
+  WriteBehind(const std::string& src_root, const std::string& dst_root,
+              int delay_ms);
+  ~WriteBehind();
+
+  void SetScheduler(ScheduleFunc func, void* user_data);
+
+  // While paused, changes are queued but no flush is scheduled.
+  void SetPaused(bool paused);
+
+  void MakeDirectory(const std::string& path);
+  void Remove(const std::string& path);
+  void Write(const std::string& path);
+
+  // Drops all queued changes.
+  void Clear();
+
+  // Applies the queued changes in order. Returns false if any failed.
+  bool Flush();
+
+  // Copies a file with a single read and write, using a buffer which is
+  // kept between copies. Buffers larger than kMaxKeptBufferSize are
+  // released after the copy or flush which needed them.
+  bool CopyFile(const std::string& src_path, const std::string& dst_path);
+
+  Stats GetStats();
+
+ private:
+  enum OpType {
+    OP_MAKE_DIRECTORY,
+    OP_REMOVE,
+    OP_WRITE,
+  };
+
+  struct Op {
+    OpType type;
+    std::string path;
+  };
+
+  typedef std::deque<Op> OpDeque;
+
+  static const size_t kMaxKeptBufferSize = 64 * 1024;
+
+  void Push(OpType type, const std::string& path);
+  void ScheduleLocked(bool* schedule);
+  bool Apply(const Op& op);
+  bool MakeDirectories(const std::string& path);
+  bool CopyFileLocked(const std::string& src_path,
+                      const std::string& dst_path);
+  void TrimBufferLocked();
+
+  std::string src_root_;
+  std::string dst_root_;
+  int delay_ms_;
+  ScheduleFunc schedule_func_;
+  void* schedule_user_data_;
+  bool paused_;
+  bool scheduled_;
+
+  // Guards the queue, the directory set and the stats.
+  pthread_mutex_t mutex_;
+  OpDeque ops_;
+  std::set<std::string> directories_;
+  Stats stats_;
+
+  // Held while copying; guards buffer_.
+  pthread_mutex_t copy_mutex_;
+  std::vector<uint8_t> buffer_;
+};
+
+}  // namespace ppapi
+}  // namespace window
+}  // namespace love
+
+#endif  // LOVE_WINDOW_PPAPI_WRITE_BEHIND_H_
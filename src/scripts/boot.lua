@@ -166,6 +166,9 @@ function love.createhandlers()
 		mousereleased = function (x,y,b)
 			if love.mousereleased then love.mousereleased(x,y,b) end
 		end,
+		mousemoved = function (x,y,dx,dy)
+			if love.mousemoved then love.mousemoved(x,y,dx,dy) end
+		end,
 		joystickpressed = function (j,b)
 			if love.joystickpressed then love.joystickpressed(j,b) end
 		end,
@@ -175,6 +178,9 @@ function love.createhandlers()
 		focus = function (f)
 			if love.focus then love.focus(f) end
 		end,
+		filesystemasync = function (id, ok, result)
+			if love.filesystem then love.filesystem.completeAsync(id, ok, result) end
+		end,
 		quit = function ()
 			return
 		end,
@@ -255,6 +261,7 @@ function love.init()
 			thread = true,
 		},
 		console = false, -- Only relevant for windows.
+		ondemand = false, -- Only draw when there is an event or love.redraw is called.
 		identity = false,
 		release = false,
 	}
@@ -282,6 +289,8 @@ function love.init()
 		}
 	end
 
+	love._ondemand = c.ondemand and true or false
+
 	if love.arg.options.console.set then
 		c.console = true
 	end
@@ -370,6 +379,20 @@ function love.init()
 
 end
 
+-- Asks for a frame to be drawn when running with t.ondemand set in
+-- love.conf. With a delay, the frame is drawn that many seconds from now
+-- (or sooner, if an event arrives). Animations can call this from
+-- love.update or love.draw to keep frames coming.
+function love.redraw(delay)
+	local at = 0
+	if delay and delay > 0 and love.timer then
+		at = love.timer.getMicroTime() + delay
+	end
+	if not love._redraw_at or at < love._redraw_at then
+		love._redraw_at = at
+	end
+end
+
 function love.run()
 
 	math.randomseed(os.time())
@@ -379,21 +402,51 @@ function love.run()
 
 	local dt = 0
 
+	-- The first frame is always drawn.
+	if love._ondemand then love.redraw() end
+
+	-- Returns true if the game should stop.
+	local function handle(e,a,b,c,d)
+		if e == "quit" then
+			if not love.quit or not love.quit() then
+				if love.audio then
+					love.audio.stop()
+				end
+				return true
+			end
+		end
+		love.handlers[e](a,b,c,d)
+	end
+
 	-- Main loop time.
 	while true do
 		-- Process events.
 		if love.event then
+			-- In on-demand mode, sleep until there is an event or a frame
+			-- has been asked for.
+			if love._ondemand then
+				local timeout
+				if love._redraw_at then
+					timeout = 0
+					if love.timer then
+						timeout = math.max(love._redraw_at - love.timer.getMicroTime(), 0)
+					end
+				end
+				local e,a,b,c,d = love.event.wait(timeout)
+				if e and handle(e,a,b,c,d) then
+					return
+				end
+				-- A frame asked for later than this one is still due.
+				if love._redraw_at and (not love.timer or love._redraw_at <= love.timer.getMicroTime()) then
+					love._redraw_at = nil
+				end
+			end
+
 			love.event.pump()
 			for e,a,b,c,d in love.event.poll() do
-				if e == "quit" then
-					if not love.quit or not love.quit() then
-						if love.audio then
-							love.audio.stop()
-						end
-						return
-					end
+				if handle(e,a,b,c,d) then
+					return
 				end
-				love.handlers[e](a,b,c,d)
 			end
 		end
 
@@ -410,7 +463,13 @@ function love.run()
 			if love.draw then love.draw() end
 		end
 
-		if love.timer then love.timer.sleep(0.001) end
+		if love.timer then
+			if love.timer.getTargetFPS() > 0 then
+				love.timer.limit()
+			else
+				love.timer.sleep(0.001)
+			end
+		end
 		if love.graphics then love.graphics.present() end
 
 	end
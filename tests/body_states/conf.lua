@@ -0,0 +1,3 @@
+function love.conf(t)
+  t.title = "Body states"
+end
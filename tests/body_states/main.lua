@@ -0,0 +1,66 @@
+-- Moves the sprites of 2,000 bodies in a SpriteBatch each frame. Press
+-- space to switch between a Lua loop (getPosition, getAngle and set per
+-- body) and a single World:getBodyStates(batch) call.
+
+local BODIES = 2000
+
+local world
+local bodies = {}
+local batch
+local useStates = true
+local elapsed = 0
+local frames = 0
+local average = 0
+
+function love.load()
+  local data = love.image.newImageData(8, 8)
+  data:mapPixel(function() return 255, 255, 255, 255 end)
+  local image = love.graphics.newImage(data)
+  batch = love.graphics.newSpriteBatch(image, BODIES)
+
+  world = love.physics.newWorld(0, 9.81 * 30, true)
+  local ground = love.physics.newBody(world, 400, 595, "static")
+  love.physics.newFixture(ground, love.physics.newRectangleShape(800, 10))
+
+  local shape = love.physics.newRectangleShape(8, 8)
+  for i = 1, BODIES do
+    local body = love.physics.newBody(world, 20 + (i % 76) * 10, 580 - math.floor(i / 76) * 10, "dynamic")
+    local fixture = love.physics.newFixture(body, shape)
+    local index = batch:add(0, 0)
+    fixture:setSprite(index, 4, 4)
+    bodies[i] = { body = body, index = index }
+  end
+end
+
+function love.keypressed(key)
+  if key == " " then
+    useStates = not useStates
+    elapsed, frames = 0, 0
+  end
+end
+
+function love.update(dt)
+  world:update(dt)
+
+  local start = love.timer.getMicroTime()
+  if useStates then
+    world:getBodyStates(batch)
+  else
+    for _, b in ipairs(bodies) do
+      local x, y = b.body:getPosition()
+      batch:set(b.index, x, y, b.body:getAngle(), 1, 1, 4, 4)
+    end
+  end
+  elapsed = elapsed + love.timer.getMicroTime() - start
+  frames = frames + 1
+  if frames == 60 then
+    average = elapsed / frames
+    elapsed, frames = 0, 0
+  end
+end
+
+function love.draw()
+  love.graphics.draw(batch)
+  love.graphics.print(string.format("%s: %.3f ms per frame",
+    useStates and "getBodyStates" or "Lua loop", average * 1000), 10, 10)
+end
@@ -0,0 +1,4 @@
+function love.conf(t)
+  t.title = "Frame pacing"
+  t.screen.vsync = false
+end
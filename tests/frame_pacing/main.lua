@@ -0,0 +1,41 @@
+-- Paces frames with love.timer.setTargetFPS and shows frame time
+-- percentiles. Press up/down to change the target, 0 to turn it off.
+
+local target = 60
+
+function love.load()
+  love.timer.setTargetFPS(target)
+end
+
+function love.keypressed(key)
+  if key == "up" then
+    target = target + 10
+  elseif key == "down" then
+    target = math.max(target - 10, 10)
+  elseif key == "0" then
+    target = 0
+  elseif key == "escape" then
+    love.event.push("quit")
+  end
+  love.timer.setTargetFPS(target)
+end
+
+local function ms(t)
+  return string.format("%.2f ms", t * 1000)
+end
+
+function love.draw()
+  local avg, p50, p95, p99 = love.timer.getFrameStats()
+  local y = 10
+  for _, line in ipairs{
+    "target: " .. (target > 0 and target or "off"),
+    "fps: " .. love.timer.getFPS(),
+    "average: " .. ms(avg),
+    "p50: " .. ms(p50),
+    "p95: " .. ms(p95),
+    "p99: " .. ms(p99),
+  } do
+    love.graphics.print(line, 10, y)
+    y = y + 20
+  end
+end
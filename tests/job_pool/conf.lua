@@ -0,0 +1,3 @@
+function love.conf(t)
+  t.title = "Job Pool"
+end
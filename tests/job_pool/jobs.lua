@@ -0,0 +1,30 @@
+-- Loaded once into the Lua state of every worker.
+
+function squares(arg, first, last)
+  local sum = 0
+  for i = first, last do
+    sum = sum + i * i
+  end
+  return sum
+end
+
+-- Pushes its name to a channel, after some busy work so that a job
+-- running too early would overtake it.
+function mark(arg)
+  local x = 0
+  for i = 1, arg.work do
+    x = x + i % 7
+  end
+  arg.channel:push(arg.name)
+end
+
+-- Waits for a parallelFor from inside a worker. With a single worker,
+-- this only finishes if the waiting worker runs the chunks itself.
+function outer(arg)
+  local parts = arg.pool:parallelFor("squares", nil, arg.count, arg.grain):wait()
+  local sum = 0
+  for _, part in ipairs(parts) do
+    sum = sum + part
+  end
+  return sum
+end
@@ -0,0 +1,96 @@
+-- Checks job pools: the results of a parallelFor, the order of jobs
+-- with dependencies, and a job which waits for other jobs.
+
+local results = {}
+
+local function squares(count)
+  local sum = 0
+  for i = 1, count do
+    sum = sum + i * i
+  end
+  return sum
+end
+
+local function check(name, ok, detail)
+  results[#results + 1] = string.format("%s %s%s", ok and "PASS" or "FAIL",
+    name, detail and (": " .. detail) or "")
+  print(results[#results])
+end
+
+local function testParallelFor(pool)
+  for _, grain in ipairs({0, 1, 7, 1000, 5000}) do
+    local parts = pool:parallelFor("squares", nil, 1000, grain):wait()
+    local sum = 0
+    for _, part in ipairs(parts) do
+      sum = sum + part
+    end
+    check("parallelFor grain " .. grain, sum == squares(1000),
+      string.format("%d chunks, sum %d", #parts, sum))
+  end
+
+  local empty = pool:parallelFor("squares", nil, 0):wait()
+  check("parallelFor of nothing", #empty == 0)
+end
+
+local function testDependencies(pool)
+  local channel = love.thread.newChannel()
+
+  -- c after b after a, though a has the most work and c the least.
+  local a = pool:submit("mark", {name = "a", work = 300000, channel = channel})
+  local b = pool:submit("mark", {name = "b", work = 30000, channel = channel}, a)
+  local c = pool:submit("mark", {name = "c", work = 0, channel = channel}, b)
+  -- d waits for both branches.
+  local e = pool:submit("mark", {name = "e", work = 100000, channel = channel})
+  local d = pool:submit("mark", {name = "d", work = 0, channel = channel}, c, e)
+  d:wait()
+
+  local order = {}
+  for i = 1, 5 do
+    order[i] = channel:pop()
+  end
+  local seen = table.concat(order, "")
+  local ok = seen:find("a") < seen:find("b") and seen:find("b") < seen:find("c")
+    and seen:sub(5) == "d"
+  check("dependencies", ok, seen)
+  check("dependencies done", a:isDone() and b:isDone() and c:isDone() and e:isDone())
+end
+
+local function testNestedWait(pool)
+  local jobs = {}
+  for i = 1, pool:getWorkerCount() + 2 do
+    jobs[i] = pool:submit("outer", {pool = pool, count = 500 + i, grain = 16})
+  end
+  local ok = true
+  for i, job in ipairs(jobs) do
+    ok = ok and job:wait() == squares(500 + i)
+  end
+  check("nested wait", ok, #jobs .. " jobs on " .. pool:getWorkerCount() .. " workers")
+end
+
+local function testError(pool)
+  local ok, err = pcall(function()
+    return pool:parallelFor("missing", nil, 10):wait()
+  end)
+  check("error in a job", not ok, err)
+end
+
+function love.load()
+  love.graphics.setMode(500, 300, false, false, 0)
+  local pool = love.thread.newJobPool("jobs.lua")
+  testParallelFor(pool)
+  testDependencies(pool)
+  testNestedWait(pool)
+  testError(pool)
+end
+
+function love.draw()
+  for i, line in ipairs(results) do
+    love.graphics.print(line, 20, i * 20)
+  end
+end
+
+function love.keypressed(key, unicode)
+  if key == 'escape' then
+    love.event.push("quit")
+  end
+end
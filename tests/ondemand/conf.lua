@@ -0,0 +1,4 @@
+function love.conf(t)
+  t.title = "On-demand redraw"
+  t.ondemand = true
+end
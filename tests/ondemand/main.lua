@@ -0,0 +1,30 @@
+-- Draws only when there is input, and twice a second to blink the
+-- cursor. The frame counter should stay still while nothing happens.
+
+local frames = 0
+local text = ""
+local cursor = true
+local last
+
+function love.keypressed(key, unicode)
+  if key == "backspace" then
+    text = text:sub(1, -2)
+  elseif unicode and unicode >= 32 and unicode < 127 then
+    text = text .. string.char(unicode)
+  end
+end
+
+function love.update(dt)
+  local now = love.timer.getMicroTime()
+  if not last or now - last >= 0.5 then
+    cursor = not cursor
+    last = now
+  end
+  love.redraw(0.5 - (now - last))
+end
+
+function love.draw()
+  frames = frames + 1
+  love.graphics.print("Frames drawn: " .. frames, 10, 10)
+  love.graphics.print("> " .. text .. (cursor and "_" or ""), 10, 40)
+end
@@ -0,0 +1,136 @@
+-- Builds the same world twice: many piles of boxes, each in its own cup
+-- with a pendulum, where all the cups belong to one static body. Every
+-- pile is a separate island. One world solves its islands on the calling
+-- thread, the other with World:setThreaded(true). Both are stepped and
+-- timed, and their bodies and postsolve impulses are compared after each
+-- step; they should match to the bit.
+
+local PILES = 64
+local COLUMNS = 8
+local BOXES = 60
+local STEPS = 300
+local DT = 1 / 60
+local CUP = 90
+
+local worlds = {}
+local steps = 0
+local mismatches = 0
+local results = {}
+
+local function build(threaded)
+  local w = {
+    world = love.physics.newWorld(0, 9.81 * 30, true),
+    bodies = {},
+    time = 0,
+    postsolves = 0,
+    impulses = 0,
+  }
+  w.world:setThreaded(threaded)
+  w.world:setCallbacks(nil, nil, nil, function(a, b, contact, normal, tangent)
+    -- Order matters to this sum, so it also checks the callback order.
+    w.postsolves = w.postsolves + 1
+    w.impulses = w.impulses * 0.5 + (normal or 0) + (tangent or 0)
+  end)
+
+  local ground = love.physics.newBody(w.world, 0, 0, "static")
+  w.ground = ground
+  local box = love.physics.newRectangleShape(6, 6)
+  local link = love.physics.newRectangleShape(3, 12)
+
+  for p = 0, PILES - 1 do
+    local left = (p % COLUMNS) * CUP
+    local bottom = (math.floor(p / COLUMNS) + 1) * CUP * 1.5
+
+    -- The cup.
+    love.physics.newFixture(ground, love.physics.newRectangleShape(left + CUP / 2, bottom, CUP - 10, 4))
+    love.physics.newFixture(ground, love.physics.newRectangleShape(left + 7, bottom - 30, 4, 60))
+    love.physics.newFixture(ground, love.physics.newRectangleShape(left + CUP - 7, bottom - 30, 4, 60))
+
+    for i = 0, BOXES - 1 do
+      local x = left + 15 + (i % 10) * 6.5 + (math.floor(i / 10) % 2) * 2
+      local y = bottom - 6 - math.floor(i / 10) * 7
+      local body = love.physics.newBody(w.world, x, y, "dynamic")
+      love.physics.newFixture(body, box)
+      table.insert(w.bodies, body)
+    end
+
+    -- A pendulum, hung from the shared static body.
+    local x = left + CUP / 2
+    local y = bottom - CUP + 10
+    local last = ground
+    for i = 1, 3 do
+      local body = love.physics.newBody(w.world, x + i * 10, y, "dynamic")
+      body:setAngle(math.pi / 2)
+      love.physics.newFixture(body, link)
+      love.physics.newRevoluteJoint(last, body, x + (i - 1) * 10 + 4, y)
+      table.insert(w.bodies, body)
+      last = body
+    end
+  end
+
+  return w
+end
+
+local function compare(a, b)
+  for i, body in ipairs(a.bodies) do
+    local other = b.bodies[i]
+    local x1, y1 = body:getPosition()
+    local x2, y2 = other:getPosition()
+    local vx1, vy1 = body:getLinearVelocity()
+    local vx2, vy2 = other:getLinearVelocity()
+    if x1 ~= x2 or y1 ~= y2 or body:getAngle() ~= other:getAngle()
+      or vx1 ~= vx2 or vy1 ~= vy2 or body:isAwake() ~= other:isAwake() then
+      mismatches = mismatches + 1
+    end
+  end
+  if a.ground:isAwake() ~= b.ground:isAwake()
+    or a.postsolves ~= b.postsolves or a.impulses ~= b.impulses then
+    mismatches = mismatches + 1
+  end
+end
+
+local function report()
+  local single, threaded = worlds[1], worlds[2]
+  local lines = {
+    string.format("%d piles, %d bodies, %d steps", PILES, #single.bodies, steps),
+    string.format("  single-threaded %.2f ms/step  threaded %.2f ms/step  (%.2fx)",
+      single.time / steps * 1000, threaded.time / steps * 1000, single.time / threaded.time),
+    string.format("  postsolve %d  mismatches %d", threaded.postsolves, mismatches),
+  }
+  for _, line in ipairs(lines) do
+    print(line)
+    table.insert(results, line)
+  end
+end
+
+function love.load()
+  worlds[1] = build(false)
+  worlds[2] = build(true)
+end
+
+function love.update()
+  if steps >= STEPS then
+    return
+  end
+
+  for _, w in ipairs(worlds) do
+    local start = love.timer.getMicroTime()
+    w.world:update(DT)
+    w.time = w.time + love.timer.getMicroTime() - start
+  end
+  steps = steps + 1
+  compare(worlds[1], worlds[2])
+
+  if steps == STEPS then
+    report()
+  end
+end
+
+function love.draw()
+  for _, body in ipairs(worlds[2].bodies) do
+    love.graphics.point(body:getX(), body:getY())
+  end
+  for i, line in ipairs(results) do
+    love.graphics.print(line, 10, i * 20)
+  end
+end
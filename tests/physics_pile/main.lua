@@ -0,0 +1,118 @@
+-- Drops 5,000 circles into a box and times World:update, once for each
+-- way of getting begin, end and postsolve events:
+--   callbacks  called during the time step;
+--   buffered   called after it, with World:setContactBuffering(true);
+--   events     World:getContactEvents after each update.
+-- Once the pile settles there are many touching contacts, so this is
+-- mostly a measure of the per-contact cost of each path.
+
+local BODIES = 5000
+local STEPS = 300
+local DT = 1 / 60
+local MODES = { "callbacks", "buffered", "events" }
+
+local world
+local mode = 0
+local counts
+local times
+local events = {}
+local results = {}
+
+local function count(kind)
+  return function()
+    counts[kind] = counts[kind] + 1
+  end
+end
+
+local function wall(x, y, w, h)
+  local body = love.physics.newBody(world, x, y, "static")
+  love.physics.newFixture(body, love.physics.newRectangleShape(w, h))
+end
+
+local function reset()
+  if world then
+    world:destroy()
+  end
+
+  mode = mode + 1
+  counts = { begin = 0, ["end"] = 0, postsolve = 0 }
+  times = {}
+  world = love.physics.newWorld(0, 9.81 * 30, true)
+  world:setContactBuffering(MODES[mode] ~= "callbacks")
+  if MODES[mode] ~= "events" then
+    world:setCallbacks(count("begin"), count("end"), nil, count("postsolve"))
+  end
+
+  wall(400, 595, 800, 10)
+  wall(5, 300, 10, 600)
+  wall(795, 300, 10, 600)
+
+  local shape = love.physics.newCircleShape(3)
+  local columns = 100
+  for i = 0, BODIES - 1 do
+    local x = 25 + (i % columns) * 7.5 + (math.floor(i / columns) % 2) * 3
+    local y = 580 - math.floor(i / columns) * 7.5
+    local body = love.physics.newBody(world, x, y, "dynamic")
+    love.physics.newFixture(body, shape)
+  end
+end
+
+local function report()
+  table.sort(times)
+  local total = 0
+  for _, t in ipairs(times) do
+    total = total + t
+  end
+  local function percentile(p)
+    return times[math.max(1, math.ceil(#times * p))]
+  end
+  local lines = {
+    string.format("%s: %d bodies, %d steps, %d contacts", MODES[mode], BODIES, #times, world:getContactCount()),
+    string.format("  step avg %.2f ms  p50 %.2f ms  p95 %.2f ms  max %.2f ms",
+      total / #times * 1000, percentile(0.5) * 1000, percentile(0.95) * 1000, times[#times] * 1000),
+    string.format("  begin %d  end %d  postsolve %d",
+      counts.begin, counts["end"], counts.postsolve),
+  }
+  for _, line in ipairs(lines) do
+    print(line)
+    table.insert(results, line)
+  end
+end
+
+function love.load()
+  reset()
+end
+
+function love.update()
+  if #times >= STEPS then
+    return
+  end
+
+  local start = love.timer.getMicroTime()
+  world:update(DT)
+  if MODES[mode] == "events" then
+    local n
+    events, n = world:getContactEvents(events)
+    for i = 1, n do
+      local kind = events[i].type
+      counts[kind] = counts[kind] + 1
+    end
+  end
+  table.insert(times, love.timer.getMicroTime() - start)
+
+  if #times == STEPS then
+    report()
+    if mode < #MODES then
+      reset()
+    end
+  end
+end
+
+function love.draw()
+  for _, body in ipairs(world:getBodyList()) do
+    love.graphics.point(body:getX(), body:getY())
+  end
+  for i, line in ipairs(results) do
+    love.graphics.print(line, 10, i * 20)
+  end
+end
@@ -0,0 +1,20 @@
+-- Creates and collects objects as fast as it can.
+local thread = love.thread.getThread()
+local iterations = thread:demand("iterations")
+local shared = thread:demand("shared")
+
+-- Sending the shared object through a channel gives every pop a new
+-- reference, so all threads retain and release the same object.
+local channel = love.thread.newChannel()
+
+for i = 1, iterations do
+  local data = love.thread.newByteData(64)
+  channel:push(shared)
+  local copy = channel:pop()
+  if i % 64 == 0 then
+    collectgarbage("step")
+  end
+end
+
+collectgarbage()
+thread:set("done", true)
@@ -0,0 +1,50 @@
+-- Runs the same amount of object churn per thread on 1, 2, 4 and 8
+-- threads at once. With no global lock around collection, the time
+-- should stay about the same as threads are added (up to the number
+-- of cores).
+
+local ITERATIONS = 200000
+
+local shared = love.thread.newByteData("shared between all threads")
+local results = {}
+local run = 0
+
+local function churn(count)
+  local threads = {}
+  local start = love.timer.getMicroTime()
+  for i = 1, count do
+    local t = love.thread.newThread("churn" .. run .. "_" .. i, "churn.lua")
+    t:start()
+    t:set("iterations", ITERATIONS)
+    t:set("shared", shared)
+    threads[i] = t
+  end
+  for i, t in ipairs(threads) do
+    t:demand("done")
+    t:wait()
+  end
+  run = run + 1
+  local elapsed = love.timer.getMicroTime() - start
+  return string.format("%d threads: %6.1f ms, %6.0f objects/ms", count,
+    elapsed * 1000, count * ITERATIONS / (elapsed * 1000))
+end
+
+function love.load()
+  love.graphics.setMode(400, 200, false, false, 0)
+  for _, count in ipairs({1, 2, 4, 8}) do
+    results[#results + 1] = churn(count)
+    print(results[#results])
+  end
+end
+
+function love.draw()
+  for i, line in ipairs(results) do
+    love.graphics.print(line, 20, 20 + i * 20)
+  end
+end
+
+function love.keypressed(key, unicode)
+  if key == 'escape' then
+    love.event.push("quit")
+  end
+end
@@ -0,0 +1,72 @@
+-- Compares sending a table through a channel as a table (binary
+-- serialization) with the old way: serializing to Lua source, sending
+-- the string and loading it on the other side.
+
+local ITERATIONS = 200
+
+local function serialize(v)
+  local t = type(v)
+  if t == "table" then
+    local parts = {}
+    for k, x in pairs(v) do
+      parts[#parts + 1] = "[" .. serialize(k) .. "]=" .. serialize(x)
+    end
+    return "{" .. table.concat(parts, ",") .. "}"
+  elseif t == "string" then
+    return string.format("%q", v)
+  end
+  return tostring(v)
+end
+
+local function makeMessage(count)
+  local msg = {}
+  for i = 1, count do
+    msg[i] = {x = i * 1.5, y = -i, kind = "enemy", alive = true}
+  end
+  return msg
+end
+
+local function bench(count)
+  local msg = makeMessage(count)
+  local channel = love.thread.newChannel()
+
+  local start = love.timer.getMicroTime()
+  for i = 1, ITERATIONS do
+    channel:push(serialize(msg))
+    local copy = loadstring("return " .. channel:pop())()
+  end
+  local text = love.timer.getMicroTime() - start
+
+  start = love.timer.getMicroTime()
+  for i = 1, ITERATIONS do
+    channel:push(msg)
+    local copy = channel:pop()
+  end
+  local binary = love.timer.getMicroTime() - start
+
+  return string.format("%5d entries: string %7.2f ms, table %7.2f ms (%.1fx)",
+    count, text * 1000 / ITERATIONS, binary * 1000 / ITERATIONS, text / binary)
+end
+
+local results = {}
+
+function love.load()
+  love.graphics.setMode(600, 200, false, false, 0)
+  for _, count in ipairs({10, 100, 1000}) do
+    results[#results + 1] = bench(count)
+    print(results[#results])
+  end
+end
+
+function love.draw()
+  love.graphics.print("Round trip per message:", 20, 20)
+  for i, line in ipairs(results) do
+    love.graphics.print(line, 20, 30 + i * 20)
+  end
+end
+
+function love.keypressed(key, unicode)
+  if key == 'escape' then
+    love.event.push("quit")
+  end
+end
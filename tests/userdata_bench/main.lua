@@ -0,0 +1,43 @@
+-- Pushes 1M userdata through each path of the runtime.
+-- Fixture:getShape makes a new Lua value on every call (luax_newtype).
+-- Fixture:getBody reuses the value it made before (luax_pushtype).
+
+local N = 1000000
+local results = {}
+
+local function bench(name, f)
+  collectgarbage()
+  local start = love.timer.getMicroTime()
+  f()
+  collectgarbage()
+  local t = love.timer.getMicroTime() - start
+  table.insert(results, string.format("%-22s %7.1f ms  %6.0f ns/push", name, t * 1000, t / N * 1e9))
+end
+
+function love.load()
+  local world = love.physics.newWorld(0, 0)
+  local body = love.physics.newBody(world, 0, 0, "dynamic")
+  local fixture = love.physics.newFixture(body, love.physics.newCircleShape(10))
+
+  bench("new value (getShape)", function()
+    for i = 1, N do
+      local s = fixture:getShape()
+    end
+  end)
+
+  bench("cached value (getBody)", function()
+    for i = 1, N do
+      local b = fixture:getBody()
+    end
+  end)
+
+  for _, line in ipairs(results) do
+    print(line)
+  end
+end
+
+function love.draw()
+  for i, line in ipairs(results) do
+    love.graphics.print(line, 10, i * 20)
+  end
+end